@@ -86,6 +86,30 @@ inline uint8_t *pgm_read_bitmap_ptr(const GFXfont *gfxFont) {
 #endif //__AVR__
 }
 
+inline GFXglyph *pgm_read_aaglyph_ptr(const GFXaafont *font, uint8_t c) {
+#ifdef __AVR__
+  return &(((GFXglyph *)pgm_read_pointer(&font->glyph))[c]);
+#else
+  return font->glyph + c;
+#endif //__AVR__
+}
+
+inline uint8_t *pgm_read_aabitmap_ptr(const GFXaafont *font) {
+#ifdef __AVR__
+  return (uint8_t *)pgm_read_pointer(&font->bitmap);
+#else
+  return font->bitmap;
+#endif //__AVR__
+}
+
+inline GFXkern *pgm_read_kern_ptr(const GFXaafont *font) {
+#ifdef __AVR__
+  return (GFXkern *)pgm_read_pointer(&font->kern);
+#else
+  return font->kern;
+#endif //__AVR__
+}
+
 #ifndef min
 #define min(a, b) (((a) < (b)) ? (a) : (b))
 #endif
@@ -1099,6 +1123,18 @@ void Adafruit_GFX::drawRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap,
 
 // TEXT- AND CHARACTER-HANDLING FUNCTIONS ----------------------------------
 
+/**************************************************************************/
+/*!
+   @brief   Read one column of a glyph of the built-in 'classic' font
+    @param    c       The 8-bit font-indexed character, after charset handling
+    @param    column  Column 0-4 of the 5x8 glyph
+    @returns  Column bits, bit 0 is the top row
+*/
+/**************************************************************************/
+uint8_t Adafruit_GFX::classicFontColumn(unsigned char c, uint8_t column) {
+  return pgm_read_byte(&font[c * 5 + column]);
+}
+
 // Draw a character
 /**************************************************************************/
 /*!
@@ -1350,6 +1386,255 @@ void Adafruit_GFX::setFont(const GFXfont *f) {
   gfxFont = (GFXfont *)f;
 }
 
+/**************************************************************************/
+/*!
+    @brief  Look up the kerning between two characters of an anti-aliased
+            font
+    @param  font   The font
+    @param  left   First character
+    @param  right  Character following it
+    @returns Pixels to add to the xAdvance of left, usually 0 or negative
+*/
+/**************************************************************************/
+static int8_t aaKerning(const GFXaafont *font, uint8_t left, uint8_t right) {
+  GFXkern *kern = pgm_read_kern_ptr(font);
+  int16_t lo = 0, hi = (int16_t)pgm_read_word(&font->kernCount) - 1;
+  uint16_t key = (left << 8) | right;
+  while (lo <= hi) { // Pairs are sorted, binary search
+    int16_t mid = (lo + hi) / 2;
+    uint16_t k = (pgm_read_byte(&kern[mid].left) << 8) |
+                 pgm_read_byte(&kern[mid].right);
+    if (k == key)
+      return (int8_t)pgm_read_byte(&kern[mid].adjust);
+    if (k < key)
+      lo = mid + 1;
+    else
+      hi = mid - 1;
+  }
+  return 0;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a string in an anti-aliased font. Every character is drawn
+            as an opaque cell of its advance width and the font's yAdvance
+            in height, edges blended from color into bg, so changing text
+            needs no separate clear as long as the new text covers the old.
+            Characters missing from the font are skipped.
+    @param  x      Left edge of the first cell
+    @param  y      Baseline
+    @param  str    Text, '\0' terminated
+    @param  font   Anti-aliased font
+    @param  color  16-bit 5-6-5 text color
+    @param  bg     16-bit 5-6-5 background color
+    @returns X coordinate after the last cell
+*/
+/**************************************************************************/
+int16_t Adafruit_GFX::drawAAText(int16_t x, int16_t y, const char *str,
+                                 const GFXaafont *font, uint16_t color,
+                                 uint16_t bg) {
+  uint8_t bpp = pgm_read_byte(&font->bpp);
+  uint8_t levels = (1 << bpp) - 1;
+  uint16_t lut[16];
+
+  // Blend table, one color per alpha level
+  for (uint8_t a = 0; a <= levels; a++) {
+    uint8_t r = ((bg >> 11) * (levels - a) + (color >> 11) * a) / levels;
+    uint8_t g = (((bg >> 5) & 0x3F) * (levels - a) +
+                 ((color >> 5) & 0x3F) * a) /
+                levels;
+    uint8_t b = ((bg & 0x1F) * (levels - a) + (color & 0x1F) * a) / levels;
+    lut[a] = (r << 11) | (g << 5) | b;
+  }
+
+  uint16_t first = pgm_read_word(&font->first),
+           last = pgm_read_word(&font->last);
+  int16_t top = y + 1 - pgm_read_byte(&font->ascent);
+
+  for (; *str; str++) {
+    uint8_t c = *str;
+    if ((c < first) || (c > last))
+      continue;
+    GFXglyph *glyph = pgm_read_aaglyph_ptr(font, c - first);
+    int16_t w = pgm_read_byte(&glyph->xAdvance) + aaKerning(font, c, str[1]);
+    if (w > 0) {
+      drawAAChar(x, top, font, glyph, w, lut);
+      x += w;
+    }
+  }
+  return x;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Width of a string drawn with drawAAText()
+    @param  str   Text, '\0' terminated
+    @param  font  Anti-aliased font
+    @returns Width in pixels
+*/
+/**************************************************************************/
+int16_t Adafruit_GFX::getAATextWidth(const char *str, const GFXaafont *font) {
+  uint16_t first = pgm_read_word(&font->first),
+           last = pgm_read_word(&font->last);
+  int16_t width = 0;
+
+  for (; *str; str++) {
+    uint8_t c = *str;
+    if ((c < first) || (c > last))
+      continue;
+    int16_t w = pgm_read_byte(&pgm_read_aaglyph_ptr(font, c - first)->xAdvance) +
+                aaKerning(font, c, str[1]);
+    if (w > 0)
+      width += w;
+  }
+  return width;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw one anti-aliased text cell pixel by pixel. Subclasses with
+            address windows override this to send the cell in one go.
+    @param  x      Left edge of the cell
+    @param  y      Top edge of the cell
+    @param  font   Anti-aliased font
+    @param  glyph  Glyph of the character
+    @param  w      Cell width
+    @param  lut    Color of each alpha level
+*/
+/**************************************************************************/
+void Adafruit_GFX::drawAAChar(int16_t x, int16_t y, const GFXaafont *font,
+                              const GFXglyph *glyph, int16_t w,
+                              const uint16_t *lut) {
+  AAcell cell;
+  uint16_t buf[32];
+  uint32_t n;
+  int16_t col = 0;
+
+  aaCellBegin(cell, font, glyph, w);
+  startWrite();
+  while ((n = aaCellPixels(cell, lut, buf, 32))) {
+    for (uint32_t i = 0; i < n; i++) {
+      writePixel(x + col, y, buf[i]);
+      if (++col == w) {
+        col = 0;
+        y++;
+      }
+    }
+  }
+  endWrite();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Decode the alpha of the next glyph pixel of an anti-aliased cell
+    @param  cell  Cell being read
+    @returns Alpha level of the pixel
+*/
+/**************************************************************************/
+uint8_t Adafruit_GFX::aaNext(AAcell &cell) {
+  if (!cell.run) {
+    uint8_t b = pgm_read_byte(cell.data++);
+    cell.alpha = b & ((1 << cell.bpp) - 1);
+    cell.run = (b >> cell.bpp) + 1;
+  }
+  cell.run--;
+  return cell.alpha;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Decode and drop glyph pixels of an anti-aliased cell
+    @param  cell  Cell being read
+    @param  n     Number of pixels
+*/
+/**************************************************************************/
+void Adafruit_GFX::aaSkip(AAcell &cell, int16_t n) {
+  while (n > 0) {
+    if (!cell.run) {
+      aaNext(cell);
+      n--;
+      continue;
+    }
+    int16_t k = (cell.run < n) ? cell.run : n;
+    cell.run -= k;
+    n -= k;
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Start reading the pixels of an anti-aliased text cell
+    @param  cell   State to initialize
+    @param  font   Anti-aliased font
+    @param  glyph  Glyph of the character
+    @param  w      Cell width
+*/
+/**************************************************************************/
+void Adafruit_GFX::aaCellBegin(AAcell &cell, const GFXaafont *font,
+                               const GFXglyph *glyph, int16_t w) {
+  uint8_t *bitmap = pgm_read_aabitmap_ptr(font);
+  int16_t gw = pgm_read_byte(&glyph->width);
+
+  cell.data = bitmap + pgm_read_word(&glyph->bitmapOffset);
+  cell.bpp = pgm_read_byte(&font->bpp);
+  cell.run = 0;
+  cell.w = w;
+  cell.h = pgm_read_byte(&font->yAdvance);
+  cell.gx = (int8_t)pgm_read_byte(&glyph->xOffset);
+  cell.gy = pgm_read_byte(&font->ascent) - 1 +
+            (int8_t)pgm_read_byte(&glyph->yOffset);
+  cell.gh = pgm_read_byte(&glyph->height);
+  cell.row = 0;
+  cell.col = 0;
+
+  // Glyph columns outside the cell are decoded but not drawn
+  int16_t left = (cell.gx < 0) ? 0 : cell.gx;
+  int16_t right = (cell.gx + gw < w) ? cell.gx + gw : w;
+  cell.visible = (right > left) ? right - left : 0;
+  cell.skipLeft = (cell.gx < 0) ? -cell.gx : 0;
+  if (cell.skipLeft > gw)
+    cell.skipLeft = gw;
+  cell.skipRight = gw - cell.skipLeft - cell.visible;
+
+  // Same for rows above the cell
+  for (; (cell.gy < 0) && (cell.gh > 0); cell.gy++, cell.gh--)
+    aaSkip(cell, gw);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Read the next pixels of an anti-aliased text cell, row by row
+    @param  cell  State from aaCellBegin()
+    @param  lut   Color of each alpha level
+    @param  out   Output buffer
+    @param  len   Capacity of out in pixels
+    @returns Number of pixels written to out, 0 once the cell is complete
+*/
+/**************************************************************************/
+uint32_t Adafruit_GFX::aaCellPixels(AAcell &cell, const uint16_t *lut,
+                                    uint16_t *out, uint32_t len) {
+  uint32_t n = 0;
+  int16_t x0 = (cell.gx < 0) ? 0 : cell.gx, x1 = x0 + cell.visible;
+
+  while ((n < len) && (cell.row < cell.h)) {
+    int16_t gr = cell.row - cell.gy;
+    if ((gr < 0) || (gr >= cell.gh) || (cell.col < x0) || (cell.col >= x1)) {
+      out[n++] = lut[0];
+    } else {
+      if (cell.col == x0) // Entering the glyph, drop pixels left of the cell
+        aaSkip(cell, cell.skipLeft);
+      out[n++] = lut[aaNext(cell)];
+      if (cell.col == x1 - 1) // Leaving it, drop pixels right of the cell
+        aaSkip(cell, cell.skipRight);
+    }
+    if (++cell.col == cell.w) {
+      cell.col = 0;
+      cell.row++;
+    }
+  }
+  return n;
+}
+
 /**************************************************************************/
 /*!
     @brief  Helper to determine size of a character with current font/size.
@@ -2693,3 +2978,270 @@ void GFXcanvas16::drawFastRawHLine(int16_t x, int16_t y, int16_t w,
     buffer[i] = color;
   }
 }
+
+/**************************************************************************/
+/*!
+   @brief    Instatiate a banded 16-bit canvas. Only two bands of band_h
+             unrotated rows are held in RAM, the image is drawn once per
+             band and every band is sent to the display on its own.
+   @param    w       Canvas width, in pixels
+   @param    h       Canvas height, in pixels
+   @param    band_h  Rows per band
+*/
+/**************************************************************************/
+GFXcanvasBanded16::GFXcanvasBanded16(uint16_t w, uint16_t h, uint16_t band_h)
+    : GFXcanvas16(w, h, false), band_h(band_h ? band_h : 1) {
+  band_count = (h + this->band_h - 1) / this->band_h;
+  uint32_t bytes = w * this->band_h * 2;
+  strip[0] = (uint16_t *)malloc(bytes);
+  strip[1] = (uint16_t *)malloc(bytes);
+  dirty = (uint32_t *)calloc((band_count + 31) / 32, sizeof(uint32_t));
+  if (!strip[0] || !strip[1] || !dirty) {
+    free(strip[0]);
+    free(strip[1]);
+    free(dirty);
+    strip[0] = strip[1] = nullptr;
+    dirty = nullptr;
+    band_count = 0;
+  }
+  markDirty();
+  selectBand(0);
+}
+
+/**************************************************************************/
+/*!
+   @brief    Delete the canvas, free memory
+*/
+/**************************************************************************/
+GFXcanvasBanded16::~GFXcanvasBanded16(void) {
+  free(strip[0]);
+  free(strip[1]);
+  free(dirty);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Select the band following drawing operations go to. The band
+            gets the strip not used by the previous band, so that one can
+            still be transferred while this one is drawn. The strip is not
+            cleared, the image is expected to cover it.
+    @param  band  Band index, 0 is the top band
+*/
+/**************************************************************************/
+void GFXcanvasBanded16::selectBand(uint16_t band) {
+  if (band >= band_count) {
+    buffer = nullptr;
+    band_rows = 0;
+    return;
+  }
+  active ^= 1;
+  buffer = strip[active];
+  band_y = band * band_h;
+  band_rows = (HEIGHT - band_y < band_h) ? HEIGHT - band_y : band_h;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Mark every band as changed
+*/
+/**************************************************************************/
+void GFXcanvasBanded16::markDirty(void) {
+  if (dirty)
+    memset(dirty, 0xFF, ((band_count + 31) / 32) * sizeof(uint32_t));
+}
+
+/**************************************************************************/
+/*!
+    @brief  Mark the bands touched by a rectangle as changed
+    @param  x  Left edge, in the current rotation
+    @param  y  Top edge, in the current rotation
+    @param  w  Width
+    @param  h  Height
+*/
+/**************************************************************************/
+void GFXcanvasBanded16::markDirty(int16_t x, int16_t y, int16_t w,
+                                  int16_t h) {
+  if (!dirty || (w <= 0) || (h <= 0))
+    return;
+
+  // Rows of the rectangle in unrotated coordinates
+  int16_t top, bottom;
+  switch (rotation) {
+  case 1:
+    top = x;
+    bottom = x + w;
+    break;
+  case 2:
+    top = HEIGHT - y - h;
+    bottom = HEIGHT - y;
+    break;
+  case 3:
+    top = HEIGHT - x - w;
+    bottom = HEIGHT - x;
+    break;
+  default:
+    top = y;
+    bottom = y + h;
+    break;
+  }
+  if (top < 0)
+    top = 0;
+  if (bottom > HEIGHT)
+    bottom = HEIGHT;
+
+  for (int16_t row = top - top % band_h; row < bottom; row += band_h) {
+    uint16_t band = row / band_h;
+    dirty[band / 32] |= 1ul << (band % 32);
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Check if a band changed since it was last sent
+    @param  band  Band index
+    @returns  true if the band must be redrawn
+*/
+/**************************************************************************/
+bool GFXcanvasBanded16::isDirty(uint16_t band) const {
+  if (band >= band_count)
+    return false;
+  return dirty[band / 32] & (1ul << (band % 32));
+}
+
+/**************************************************************************/
+/*!
+    @brief  Mark a band as sent
+    @param  band  Band index
+*/
+/**************************************************************************/
+void GFXcanvasBanded16::clearDirty(uint16_t band) {
+  if (band < band_count)
+    dirty[band / 32] &= ~(1ul << (band % 32));
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draw a pixel, dropped unless it lies in the selected band
+    @param  x   x coordinate
+    @param  y   y coordinate
+    @param  color 16-bit 5-6-5 Color to fill with
+*/
+/**************************************************************************/
+void GFXcanvasBanded16::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if (!buffer || (x < 0) || (y < 0) || (x >= _width) || (y >= _height))
+    return;
+
+  int16_t t;
+  switch (rotation) {
+  case 1:
+    t = x;
+    x = WIDTH - 1 - y;
+    y = t;
+    break;
+  case 2:
+    x = WIDTH - 1 - x;
+    y = HEIGHT - 1 - y;
+    break;
+  case 3:
+    t = x;
+    x = y;
+    y = HEIGHT - 1 - t;
+    break;
+  }
+
+  y -= band_y;
+  if ((y >= 0) && (y < band_rows))
+    buffer[x + y * WIDTH] = __builtin_bswap16(color);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Fill the selected band with one color
+    @param  color 16-bit 5-6-5 Color to fill with
+*/
+/**************************************************************************/
+void GFXcanvasBanded16::fillScreen(uint16_t color) {
+  if (buffer) {
+    uint32_t i, pixels = WIDTH * band_rows;
+    color = __builtin_bswap16(color);
+    for (i = 0; i < pixels; i++)
+      buffer[i] = color;
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Reverse the byte order of the selected band. Bands are kept in
+            display order already, this is only needed to read the buffer
+            as native 16-bit values.
+*/
+/**************************************************************************/
+void GFXcanvasBanded16::byteSwap(void) {
+  if (buffer) {
+    uint32_t i, pixels = WIDTH * band_rows;
+    for (i = 0; i < pixels; i++)
+      buffer[i] = __builtin_bswap16(buffer[i]);
+  }
+}
+
+/**********************************************************************/
+/*!
+        @brief    Get the pixel color value at an unrotated coordinate
+        @param    x   x coordinate
+        @param    y   y coordinate
+        @returns  The pixel's 16-bit 5-6-5 color value, 0 outside the
+                  selected band
+*/
+/**********************************************************************/
+uint16_t GFXcanvasBanded16::getRawPixel(int16_t x, int16_t y) const {
+  y -= band_y;
+  if (!buffer || (x < 0) || (x >= WIDTH) || (y < 0) || (y >= band_rows))
+    return 0;
+  return __builtin_bswap16(buffer[x + y * WIDTH]);
+}
+
+/**************************************************************************/
+/*!
+   @brief    Vertical line in unrotated coordinates, clipped to the band
+   @param    x   Line horizontal start point
+   @param    y   Line vertical start point
+   @param    h   length of vertical line to be drawn, including first point
+   @param    color   color 16-bit 5-6-5 Color to draw line with
+*/
+/**************************************************************************/
+void GFXcanvasBanded16::drawFastRawVLine(int16_t x, int16_t y, int16_t h,
+                                         uint16_t color) {
+  int16_t y1 = y, y2 = y + h;
+  if (y1 < band_y)
+    y1 = band_y;
+  if (y2 > band_y + band_rows)
+    y2 = band_y + band_rows;
+  if (!buffer || (y1 >= y2))
+    return;
+  uint16_t *buffer_ptr = buffer + (y1 - band_y) * WIDTH + x;
+  color = __builtin_bswap16(color);
+  for (int16_t i = y1; i < y2; i++) {
+    (*buffer_ptr) = color;
+    buffer_ptr += WIDTH;
+  }
+}
+
+/**************************************************************************/
+/*!
+   @brief    Horizontal line in unrotated coordinates, clipped to the band
+   @param    x   Line horizontal start point
+   @param    y   Line vertical start point
+   @param    w   length of horizontal line to be drawn, including first point
+   @param    color   color 16-bit 5-6-5 Color to draw line with
+*/
+/**************************************************************************/
+void GFXcanvasBanded16::drawFastRawHLine(int16_t x, int16_t y, int16_t w,
+                                         uint16_t color) {
+  y -= band_y;
+  if (!buffer || (y < 0) || (y >= band_rows))
+    return;
+  uint16_t *buffer_ptr = buffer + y * WIDTH + x;
+  color = __builtin_bswap16(color);
+  for (int16_t i = 0; i < w; i++)
+    buffer_ptr[i] = color;
+}
@@ -109,8 +109,8 @@ public:
                      int16_t w, int16_t h);
   void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color,
                 uint16_t bg, uint8_t size);
-  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color,
-                uint16_t bg, uint8_t size_x, uint8_t size_y);
+  virtual void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color,
+                        uint16_t bg, uint8_t size_x, uint8_t size_y);
   void getTextBounds(const char *string, int16_t x, int16_t y, int16_t *x1,
                      int16_t *y1, uint16_t *w, uint16_t *h);
   void getTextBounds(const __FlashStringHelper *s, int16_t x, int16_t y,
@@ -120,6 +120,9 @@ public:
   void setTextSize(uint8_t s);
   void setTextSize(uint8_t sx, uint8_t sy);
   void setFont(const GFXfont *f = NULL);
+  int16_t drawAAText(int16_t x, int16_t y, const char *str,
+                     const GFXaafont *font, uint16_t color, uint16_t bg);
+  static int16_t getAATextWidth(const char *str, const GFXaafont *font);
 
   /**********************************************************************/
   /*!
@@ -230,6 +233,33 @@ public:
   int16_t getCursorY(void) const { return cursor_y; };
 
 protected:
+  /// Read position within the text cell of a GFXaafont glyph
+  struct AAcell {
+    const uint8_t *data; ///< Next run-length byte
+    uint8_t bpp;         ///< Alpha bits per pixel
+    uint8_t alpha;       ///< Value of the current run
+    uint8_t run;         ///< Pixels left in the current run
+    int16_t w;           ///< Cell width
+    int16_t h;           ///< Cell height
+    int16_t gx;          ///< Glyph left edge within the cell
+    int16_t gy;          ///< Glyph top edge within the cell
+    int16_t gh;          ///< Glyph rows
+    int16_t skipLeft;    ///< Glyph pixels per row left of the cell
+    int16_t visible;     ///< Glyph pixels per row inside the cell
+    int16_t skipRight;   ///< Glyph pixels per row right of the cell
+    int16_t row;         ///< Next cell row
+    int16_t col;         ///< Next cell column
+  };
+  virtual void drawAAChar(int16_t x, int16_t y, const GFXaafont *font,
+                          const GFXglyph *glyph, int16_t w,
+                          const uint16_t *lut);
+  static void aaCellBegin(AAcell &cell, const GFXaafont *font,
+                          const GFXglyph *glyph, int16_t w);
+  static uint32_t aaCellPixels(AAcell &cell, const uint16_t *lut,
+                               uint16_t *out, uint32_t len);
+  static uint8_t aaNext(AAcell &cell);
+  static void aaSkip(AAcell &cell, int16_t n);
+  static uint8_t classicFontColumn(unsigned char c, uint8_t column);
   void charBounds(unsigned char c, int16_t *x, int16_t *y, int16_t *minx,
                   int16_t *miny, int16_t *maxx, int16_t *maxy);
   int16_t WIDTH;        ///< This is the 'raw' display width - never changes
@@ -386,12 +416,72 @@ public:
   uint16_t *getBuffer(void) const { return buffer; }
 
 protected:
-  uint16_t getRawPixel(int16_t x, int16_t y) const;
-  void drawFastRawVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
-  void drawFastRawHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  virtual uint16_t getRawPixel(int16_t x, int16_t y) const;
+  virtual void drawFastRawVLine(int16_t x, int16_t y, int16_t h,
+                                uint16_t color);
+  virtual void drawFastRawHLine(int16_t x, int16_t y, int16_t w,
+                                uint16_t color);
   uint16_t *buffer;  ///< Raster data: no longer private, allow subclass access
   bool buffer_owned; ///< If true, destructor will free buffer, else it will do
                      ///< nothing
 };
 
+/// A 16-bit canvas holding two horizontal bands of the full image at a time
+class GFXcanvasBanded16 : public GFXcanvas16 {
+public:
+  GFXcanvasBanded16(uint16_t w, uint16_t h, uint16_t band_h);
+  ~GFXcanvasBanded16(void);
+  void drawPixel(int16_t x, int16_t y, uint16_t color);
+  void fillScreen(uint16_t color);
+  void byteSwap(void);
+  void selectBand(uint16_t band);
+  void markDirty(void);
+  void markDirty(int16_t x, int16_t y, int16_t w, int16_t h);
+  bool isDirty(uint16_t band) const;
+  void clearDirty(uint16_t band);
+  /**********************************************************************/
+  /*!
+    @brief    Number of bands covering the canvas
+    @returns  Band count, the last band may be shorter than the others
+  */
+  /**********************************************************************/
+  uint16_t bands(void) const { return band_count; }
+  /**********************************************************************/
+  /*!
+    @brief    First unrotated row of the selected band
+    @returns  Row offset of getBuffer() within the full image
+  */
+  /**********************************************************************/
+  int16_t bandY(void) const { return band_y; }
+  /**********************************************************************/
+  /*!
+    @brief    Rows of the selected band
+    @returns  Height of getBuffer() in unrotated rows
+  */
+  /**********************************************************************/
+  int16_t bandHeight(void) const { return band_rows; }
+  /**********************************************************************/
+  /*!
+    @brief    Unrotated width of the canvas and its bands
+    @returns  Pixels per band row
+  */
+  /**********************************************************************/
+  int16_t bandWidth(void) const { return WIDTH; }
+
+protected:
+  uint16_t getRawPixel(int16_t x, int16_t y) const;
+  void drawFastRawVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+  void drawFastRawHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  uint16_t *strip[2];   ///< Ping-pong band buffers, display (big-endian) order
+  uint32_t *dirty;      ///< One bit per band
+  uint16_t band_h;      ///< Rows per band
+  uint16_t band_count;  ///< Number of bands
+  int16_t band_y = 0;   ///< First row of the selected band
+  int16_t band_rows = 0; ///< Rows of the selected band
+  uint8_t active = 0;   ///< Index of the strip in buffer
+};
+
+/// Callback drawing the whole image into a GFXcanvasBanded16, once per band
+typedef void (*GFXbandRenderer)(GFXcanvasBanded16 &canvas, void *arg);
+
 #endif // _ADAFRUIT_GFX_H
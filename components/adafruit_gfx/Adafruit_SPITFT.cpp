@@ -53,6 +53,10 @@
 #endif
 #endif
 
+#if defined(ESP32)
+#include "esp_memory_utils.h" // esp_ptr_dma_capable()
+#endif
+
 #if defined(PORT_IOBUS)
 // On SAMD21, redefine digitalPinToPort() to use the slightly-faster
 // PORT_IOBUS rather than PORT (not needed on SAMD51).
@@ -105,6 +109,10 @@ static const struct {
 #define TFT_SOFT_SPI 1 ///< Display interface = software SPI
 #define TFT_PARALLEL 2 ///< Display interface = 8- or 16-bit parallel
 
+// Line buffer of drawChar() and drawAAChar(), word aligned so runs of
+// SPITFT_DMA_MIN_PIXELS or more can go out by DMA.
+static uint16_t glyphRun[SPITFT_GLYPH_RUN_PIXELS] __attribute__((aligned(4)));
+
 // CONSTRUCTORS ------------------------------------------------------------
 
 /*!
@@ -592,6 +600,9 @@ void Adafruit_SPITFT::initSPI(uint32_t freq, uint8_t spiMode) {
     ) {
       hwspi._spi->begin();
     }
+#if defined(ESP32)
+    hwspi._spi->dmaBegin(); // Falls back to FIFO writes if unavailable
+#endif
   } else if (connection == TFT_SOFT_SPI) {
 
     pinMode(swspi._mosi, OUTPUT);
@@ -931,6 +942,9 @@ void Adafruit_SPITFT::startWrite(void) {
             for all display types; not an SPI-specific function.
 */
 void Adafruit_SPITFT::endWrite(void) {
+#if defined(ESP32)
+  dmaWait(); // Don't deselect while pixels are still queued
+#endif
   if (_cs >= 0)
     SPI_CS_HIGH();
   SPI_END_TRANSACTION();
@@ -1013,6 +1027,32 @@ void Adafruit_SPITFT::writePixels(uint16_t *colors, uint32_t len, bool block,
 
 #if defined(ESP32)
   if (connection == TFT_HARD_SPI) {
+    // Long runs from RAM go through DMA. Little-endian pixels are swapped
+    // in place and restored once the transfer is done, by dmaWait() when
+    // not blocking.
+    if ((len >= SPITFT_DMA_MIN_PIXELS) && esp_ptr_dma_capable(colors) &&
+        !((uintptr_t)colors & 3)) {
+      if (!bigEndian) {
+        for (uint8_t i = 0; i < dmaSwappedCount; i++) {
+          if (dmaSwapped[i] == colors)
+            dmaWait(); // Same buffer still queued, restore it first
+        }
+        if (dmaSwappedCount == SPITFT_DMA_PENDING)
+          dmaWait();
+        swapBytes(colors, len);
+      }
+      if (hwspi._spi->writeDMA(colors, len * 2)) {
+        if (!bigEndian) {
+          dmaSwapped[dmaSwappedCount] = colors;
+          dmaSwappedLen[dmaSwappedCount++] = len;
+        }
+        if (block)
+          dmaWait();
+        return;
+      }
+      if (!bigEndian)
+        swapBytes(colors, len); // Not queued, undo and use the FIFO
+    }
     if (!bigEndian) {
       hwspi._spi->writePixels(colors, len * 2); // Inbuilt endian-swap
     } else {
@@ -1175,7 +1215,15 @@ void Adafruit_SPITFT::writePixels(uint16_t *colors, uint32_t len, bool block,
             was used (as is the default case).
 */
 void Adafruit_SPITFT::dmaWait(void) {
-#if defined(USE_SPI_DMA) && (defined(__SAMD51__) || defined(ARDUINO_SAMD_ZERO))
+#if defined(ESP32)
+  if (connection == TFT_HARD_SPI) {
+    hwspi._spi->dmaWait();
+    while (dmaSwappedCount) {
+      dmaSwappedCount--;
+      swapBytes(dmaSwapped[dmaSwappedCount], dmaSwappedLen[dmaSwappedCount]);
+    }
+  }
+#elif defined(USE_SPI_DMA) && (defined(__SAMD51__) || defined(ARDUINO_SAMD_ZERO))
   while (dma_busy)
     ;
 #if defined(__SAMD51__) || defined(ARDUINO_SAMD_ZERO)
@@ -1195,7 +1243,9 @@ void Adafruit_SPITFT::dmaWait(void) {
     @return true if DMA is enabled and transmitting data, false otherwise.
 */
 bool Adafruit_SPITFT::dmaBusy(void) const {
-#if defined(USE_SPI_DMA) && (defined(__SAMD51__) || defined(ARDUINO_SAMD_ZERO))
+#if defined(ESP32)
+  return (connection == TFT_HARD_SPI) && hwspi._spi->dmaBusy();
+#elif defined(USE_SPI_DMA) && (defined(__SAMD51__) || defined(ARDUINO_SAMD_ZERO))
   return dma_busy;
 #else
   return false;
@@ -1215,26 +1265,12 @@ void Adafruit_SPITFT::writeColor(uint16_t color, uint32_t len) {
 
   uint8_t hi = color >> 8, lo = color;
 
-#if defined(ESP32) // ESP32 has a special SPI pixel-writing function...
+#if defined(ESP32) // ESP32 has a special SPI pattern-writing function...
   if (connection == TFT_HARD_SPI) {
-#define SPI_MAX_PIXELS_AT_ONCE 32
-#define TMPBUF_LONGWORDS (SPI_MAX_PIXELS_AT_ONCE + 1) / 2
-#define TMPBUF_PIXELS (TMPBUF_LONGWORDS * 2)
-    static uint32_t temp[TMPBUF_LONGWORDS];
-    uint32_t c32 = color * 0x00010001;
-    uint16_t bufLen = (len < TMPBUF_PIXELS) ? len : TMPBUF_PIXELS, xferLen,
-             fillLen;
-    // Fill temp buffer 32 bits at a time
-    fillLen = (bufLen + 1) / 2; // Round up to next 32-bit boundary
-    for (uint32_t t = 0; t < fillLen; t++) {
-      temp[t] = c32;
-    }
-    // Issue pixels in blocks from temp buffer
-    while (len) {                              // While pixels remain
-      xferLen = (bufLen < len) ? bufLen : len; // How many this pass?
-      writePixels((uint16_t *)temp, xferLen);
-      len -= xferLen;
-    }
+    // The whole run goes out as one repeating transfer (DMA if available)
+    // instead of one writePixels() per 32 pixels
+    uint8_t pattern[2] = {hi, lo};
+    hwspi._spi->writePattern(pattern, 2, len);
     return;
   }
 #elif defined(ARDUINO_NRF52_ADAFRUIT) &&                                       \
@@ -1865,6 +1901,101 @@ void Adafruit_SPITFT::pushColor(uint16_t color) {
   endWrite();
 }
 
+/*!
+    @brief  Draw a single character. Opaque, scaled characters of the
+            'classic' built-in font are rasterized, background included,
+            into a line buffer and sent with a single setAddrWindow(),
+            instead of one address window per set font pixel. Glyphs larger
+            than SPITFT_GLYPH_RUN_PIXELS are sent in several writePixels()
+            calls within that window. Custom fonts, transparent text, size 1
+            and clipped characters are drawn by Adafruit_GFX::drawChar().
+    @param  x       Top left corner horizontal coordinate.
+    @param  y       Top left corner vertical coordinate.
+    @param  c       The 8-bit font-indexed character (likely ascii).
+    @param  color   16-bit 5-6-5 Color to draw character with.
+    @param  bg      16-bit 5-6-5 Color to fill background with (if same as
+                    color, no background).
+    @param  size_x  Font magnification level in X-axis.
+    @param  size_y  Font magnification level in Y-axis.
+*/
+void Adafruit_SPITFT::drawChar(int16_t x, int16_t y, unsigned char c,
+                               uint16_t color, uint16_t bg, uint8_t size_x,
+                               uint8_t size_y) {
+  int16_t w = 6 * size_x, h = 8 * size_y;
+
+  if (gfxFont || (bg == color) || ((size_x == 1) && (size_y == 1)) ||
+      (x < 0) || (y < 0) || ((x + w) > _width) || ((y + h) > _height) ||
+      (w > SPITFT_GLYPH_RUN_PIXELS)) {
+    Adafruit_GFX::drawChar(x, y, c, color, bg, size_x, size_y);
+    return;
+  }
+
+  if (!_cp437 && (c >= 176))
+    c++; // Handle 'classic' charset behavior
+
+  uint16_t *buf = glyphRun;
+  uint8_t columns[5];
+  for (uint8_t i = 0; i < 5; i++)
+    columns[i] = classicFontColumn(c, i);
+
+  startWrite();
+  setAddrWindow(x, y, w, h);
+  uint32_t len = 0;
+  for (int16_t py = 0; py < h; py++) {
+    uint16_t *row = &buf[len];
+    if ((py % size_y) && (len >= (uint32_t)w)) {
+      // Same font row as the line before, repeat it
+      memcpy(row, row - w, w * sizeof(uint16_t));
+    } else {
+      uint8_t bit = 1 << (py / size_y);
+      uint16_t *p = row;
+      for (uint8_t i = 0; i < 6; i++) {
+        uint16_t pixel = ((i < 5) && (columns[i] & bit)) ? color : bg;
+        for (uint8_t sx = 0; sx < size_x; sx++)
+          *p++ = pixel;
+      }
+    }
+    len += w;
+    if ((len + w > SPITFT_GLYPH_RUN_PIXELS) || (py == h - 1)) {
+      writePixels(buf, len);
+      len = 0;
+    }
+  }
+  endWrite();
+}
+
+/*!
+    @brief  Draw one anti-aliased text cell. Cells fully on screen are sent
+            as a single address window, decoded in runs of up to
+            SPITFT_GLYPH_RUN_PIXELS, clipped cells are drawn by
+            Adafruit_GFX::drawAAChar().
+    @param  x      Left edge of the cell
+    @param  y      Top edge of the cell
+    @param  font   Anti-aliased font
+    @param  glyph  Glyph of the character
+    @param  w      Cell width
+    @param  lut    Color of each alpha level
+*/
+void Adafruit_SPITFT::drawAAChar(int16_t x, int16_t y, const GFXaafont *font,
+                                 const GFXglyph *glyph, int16_t w,
+                                 const uint16_t *lut) {
+  int16_t h = pgm_read_byte(&font->yAdvance);
+
+  if ((x < 0) || (y < 0) || ((x + w) > _width) || ((y + h) > _height)) {
+    Adafruit_GFX::drawAAChar(x, y, font, glyph, w, lut);
+    return;
+  }
+
+  AAcell cell;
+  uint32_t len;
+  aaCellBegin(cell, font, glyph, w);
+  startWrite();
+  setAddrWindow(x, y, w, h);
+  while ((len = aaCellPixels(cell, lut, glyphRun, SPITFT_GLYPH_RUN_PIXELS)))
+    writePixels(glyphRun, len);
+  endWrite();
+}
+
 /*!
     @brief  Draw a 16-bit image (565 RGB) at the specified (x,y) position.
             For 16-bit display devices; no color reduction performed.
@@ -1918,6 +2049,44 @@ void Adafruit_SPITFT::drawRGBBitmap(int16_t x, int16_t y, uint16_t *pcolors,
   endWrite();
 }
 
+/*!
+    @brief  Draw the dirty bands of a banded canvas. The renderer is called
+            once per dirty band and draws the whole image into the canvas,
+            everything outside the selected band is dropped. Each band is
+            sent with a non-blocking writePixels(), so with DMA the next
+            band is drawn while the previous one is still on the bus. Only
+            one band of pixels ever reaches the display at a time, the
+            image never shows half drawn. Handles its own transaction; the
+            renderer must draw to the canvas only, never to the display.
+    @param  x       Top left corner horizontal coordinate.
+    @param  y       Top left corner vertical coordinate.
+    @param  canvas  Banded canvas, must lie entirely on screen.
+    @param  render  Draws the image into the canvas.
+    @param  arg     Passed to render.
+*/
+void Adafruit_SPITFT::drawBands(int16_t x, int16_t y, GFXcanvasBanded16 &canvas,
+                                GFXbandRenderer render, void *arg) {
+  int16_t w = canvas.bandWidth();
+  if (!canvas.bands() || (x < 0) || (y < 0) || (x + w > _width))
+    return;
+
+  startWrite();
+  for (uint16_t band = 0; band < canvas.bands(); band++) {
+    if (!canvas.isDirty(band))
+      continue;
+    canvas.selectBand(band);
+    if ((y + canvas.bandY() + canvas.bandHeight()) > _height)
+      break; // Off-edge bottom
+    render(canvas, arg);
+    canvas.clearDirty(band);
+    dmaWait(); // Previous band done, the bus is free for the window command
+    setAddrWindow(x, y + canvas.bandY(), w, canvas.bandHeight());
+    writePixels(canvas.getBuffer(), (uint32_t)w * canvas.bandHeight(), false,
+                true);
+  }
+  endWrite();
+}
+
 // -------------------------------------------------------------------------
 // Miscellaneous class member functions that don't draw anything.
 
@@ -66,6 +66,17 @@ typedef uint32_t ADAGFX_PORT_t; ///< PORT values are 32-bit
 #endif                                     // end !ARM
 typedef volatile ADAGFX_PORT_t *PORTreg_t; ///< PORT register type
 
+#if !defined(SPITFT_GLYPH_RUN_PIXELS)
+#define SPITFT_GLYPH_RUN_PIXELS 512 ///< Line buffer size of drawChar()
+#endif
+
+#if defined(ESP32)
+#if !defined(SPITFT_DMA_MIN_PIXELS)
+#define SPITFT_DMA_MIN_PIXELS 64 ///< Shorter writePixels() runs use the FIFO
+#endif
+#define SPITFT_DMA_PENDING 4 ///< Non-blocking writes restored by dmaWait()
+#endif
+
 #if defined(__AVR__) && !defined(__LGT8F__)
 #define DEFAULT_SPI_FREQ 8000000L ///< Hardware SPI default speed
 #else
@@ -251,9 +262,17 @@ public:
   // for backward compatibility, consider it deprecated:
   void pushColor(uint16_t color);
 
+  // Opaque, scaled classic-font characters are sent as one address
+  // window from a line buffer instead of one rectangle per font pixel.
+  using Adafruit_GFX::drawChar;
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color,
+                uint16_t bg, uint8_t size_x, uint8_t size_y);
+
   using Adafruit_GFX::drawRGBBitmap; // Check base class first
   void drawRGBBitmap(int16_t x, int16_t y, uint16_t *pcolors, int16_t w,
                      int16_t h);
+  void drawBands(int16_t x, int16_t y, GFXcanvasBanded16 &canvas,
+                 GFXbandRenderer render, void *arg = NULL);
 
   void invertDisplay(bool i);
   uint16_t color565(uint8_t r, uint8_t g, uint8_t b);
@@ -379,6 +398,9 @@ protected:
   inline void SPI_BEGIN_TRANSACTION(void);
   inline void SPI_END_TRANSACTION(void);
   inline void TFT_WR_STROBE(void); // Parallel interface write strobe
+  // Anti-aliased text cells go out as one address window
+  void drawAAChar(int16_t x, int16_t y, const GFXaafont *font,
+                  const GFXglyph *glyph, int16_t w, const uint16_t *lut);
   inline void TFT_RD_HIGH(void);   // Parallel interface read high
   inline void TFT_RD_LOW(void);    // Parallel interface read low
 
@@ -501,6 +523,11 @@ protected:
   uint32_t lastFillLen = 0;          ///< # of pixels w/last fill
   uint8_t onePixelBuf;               ///< For hi==lo fill
 #endif
+#if defined(ESP32)
+  uint16_t *dmaSwapped[SPITFT_DMA_PENDING]; ///< Byte swapped DMA buffers
+  uint32_t dmaSwappedLen[SPITFT_DMA_PENDING]; ///< Their length in pixels
+  uint8_t dmaSwappedCount = 0;                ///< Buffers to restore
+#endif
 #if defined(USE_FAST_PINIO)
 #if defined(HAS_PORT_SET_CLR)
 #if !defined(KINETISK)
@@ -0,0 +1,101 @@
+#pragma once
+#include <Adafruit_GFX.h>
+
+// Source Code Pro Bold, SIL Open Font License 1.1. Digits, '-', '.' and '/' only,
+// anti-aliased for drawAAText(). Generated with: fontconvert -a4 SourceCodePro-Bold.ttf 10 45 57
+
+const uint8_t SourceCodePro_Bold10pt7b_aa4Bitmaps[] PROGMEM = {
+  0x09, 0x7F, 0x19, 0x7F, 0x09, 0x00, 0x06, 0x1D, 0x05, 0x00, 0x02, 0x3F,
+  0x01, 0x04, 0x3F, 0x04, 0x02, 0x3F, 0x02, 0x00, 0x06, 0x1E, 0x06, 0x00,
+  0x50, 0x02, 0x1F, 0x05, 0x50, 0x08, 0x0F, 0x0E, 0x60, 0x0D, 0x0F, 0x08,
+  0x50, 0x04, 0x1F, 0x02, 0x50, 0x0A, 0x0F, 0x0C, 0x50, 0x01, 0x1F, 0x06,
+  0x50, 0x07, 0x0F, 0x0E, 0x01, 0x50, 0x0D, 0x0F, 0x09, 0x50, 0x03, 0x1F,
+  0x03, 0x50, 0x09, 0x0F, 0x0D, 0x50, 0x01, 0x0E, 0x0F, 0x07, 0x50, 0x06,
+  0x1F, 0x01, 0x50, 0x0C, 0x0F, 0x0A, 0x50, 0x02, 0x1F, 0x04, 0x50, 0x08,
+  0x0F, 0x0D, 0x60, 0x0E, 0x0F, 0x08, 0x50, 0x05, 0x1F, 0x02, 0x50, 0x10,
+  0x04, 0x0B, 0x1E, 0x0B, 0x04, 0x20, 0x06, 0x5F, 0x06, 0x00, 0x01, 0x0E,
+  0x0F, 0x0B, 0x12, 0x0B, 0x0F, 0x0E, 0x01, 0x07, 0x1F, 0x02, 0x10, 0x02,
+  0x1F, 0x07, 0x0B, 0x0F, 0x0D, 0x30, 0x0D, 0x0F, 0x0A, 0x0C, 0x0F, 0x0C,
+  0x02, 0x1D, 0x02, 0x0C, 0x0F, 0x0C, 0x0D, 0x0F, 0x0B, 0x07, 0x1F, 0x07,
+  0x0B, 0x0F, 0x0D, 0x0C, 0x0F, 0x0C, 0x02, 0x1D, 0x02, 0x0C, 0x0F, 0x0C,
+  0x0A, 0x0F, 0x0E, 0x30, 0x0E, 0x0F, 0x0A, 0x07, 0x1F, 0x03, 0x10, 0x03,
+  0x1F, 0x07, 0x01, 0x0E, 0x0F, 0x0B, 0x12, 0x0B, 0x0F, 0x0E, 0x01, 0x00,
+  0x05, 0x5F, 0x05, 0x20, 0x04, 0x0B, 0x1E, 0x0B, 0x04, 0x10, 0x00, 0x01,
+  0x04, 0x08, 0x0E, 0x0F, 0x0D, 0x30, 0x0B, 0x3F, 0x0D, 0x30, 0x0A, 0x3F,
+  0x0D, 0x50, 0x01, 0x1F, 0x0D, 0x50, 0x01, 0x1F, 0x0D, 0x50, 0x01, 0x1F,
+  0x0D, 0x50, 0x01, 0x1F, 0x0D, 0x50, 0x01, 0x1F, 0x0D, 0x50, 0x01, 0x1F,
+  0x0D, 0x50, 0x01, 0x1F, 0x0D, 0x50, 0x01, 0x1F, 0x0D, 0x20, 0x05, 0x7F,
+  0x0B, 0x05, 0x7F, 0x0B, 0x00, 0x04, 0x0A, 0x0E, 0x0F, 0x0E, 0x09, 0x02,
+  0x10, 0x09, 0x5F, 0x0E, 0x02, 0x00, 0x04, 0x0E, 0x09, 0x02, 0x01, 0x08,
+  0x1F, 0x0A, 0x10, 0x02, 0x30, 0x0D, 0x0F, 0x0E, 0x60, 0x0C, 0x1F, 0x50,
+  0x02, 0x1F, 0x0C, 0x50, 0x0A, 0x1F, 0x06, 0x40, 0x07, 0x1F, 0x0B, 0x40,
+  0x05, 0x1F, 0x0D, 0x01, 0x30, 0x05, 0x1F, 0x0E, 0x02, 0x30, 0x07, 0x1F,
+  0x0E, 0x02, 0x30, 0x07, 0x2F, 0x1E, 0x2F, 0x0B, 0x0D, 0x7F, 0x0B, 0x10,
+  0x05, 0x0A, 0x0E, 0x0F, 0x0D, 0x0B, 0x05, 0x20, 0x08, 0x6F, 0x08, 0x10,
+  0x01, 0x0C, 0x09, 0x02, 0x00, 0x04, 0x0E, 0x1F, 0x01, 0x60, 0x0C, 0x1F,
+  0x02, 0x40, 0x02, 0x08, 0x1F, 0x0B, 0x30, 0x02, 0x2F, 0x0E, 0x08, 0x01,
+  0x30, 0x02, 0x3F, 0x0C, 0x03, 0x50, 0x02, 0x06, 0x1F, 0x0E, 0x02, 0x60,
+  0x07, 0x1F, 0x08, 0x10, 0x01, 0x30, 0x06, 0x1F, 0x09, 0x00, 0x06, 0x0E,
+  0x07, 0x02, 0x00, 0x04, 0x0D, 0x1F, 0x05, 0x00, 0x0D, 0x6F, 0x09, 0x10,
+  0x01, 0x07, 0x0C, 0x0E, 0x0F, 0x0D, 0x0B, 0x04, 0x10, 0x40, 0x05, 0x2F,
+  0x08, 0x50, 0x01, 0x0E, 0x2F, 0x08, 0x50, 0x09, 0x0F, 0x0A, 0x1F, 0x08,
+  0x40, 0x04, 0x0F, 0x0E, 0x04, 0x1F, 0x08, 0x30, 0x01, 0x0D, 0x0F, 0x08,
+  0x03, 0x1F, 0x08, 0x30, 0x08, 0x0F, 0x0E, 0x01, 0x03, 0x1F, 0x08, 0x20,
+  0x03, 0x1F, 0x06, 0x00, 0x03, 0x1F, 0x08, 0x20, 0x0C, 0x0F, 0x0C, 0x10,
+  0x03, 0x1F, 0x08, 0x10, 0x04, 0x9F, 0x02, 0x04, 0x9F, 0x02, 0x50, 0x03,
+  0x1F, 0x08, 0x70, 0x03, 0x1F, 0x08, 0x70, 0x03, 0x1F, 0x08, 0x10, 0x10,
+  0x0B, 0x6F, 0x01, 0x10, 0x0C, 0x6F, 0x01, 0x10, 0x0D, 0x0F, 0x0C, 0x70,
+  0x0E, 0x0F, 0x0A, 0x70, 0x0E, 0x0F, 0x0A, 0x70, 0x3F, 0x0E, 0x0C, 0x07,
+  0x01, 0x20, 0x0D, 0x5F, 0x0C, 0x01, 0x10, 0x01, 0x07, 0x02, 0x00, 0x04,
+  0x0D, 0x1F, 0x06, 0x60, 0x06, 0x1F, 0x09, 0x10, 0x01, 0x30, 0x06, 0x1F,
+  0x08, 0x00, 0x05, 0x0E, 0x07, 0x11, 0x04, 0x0D, 0x1F, 0x03, 0x00, 0x0C,
+  0x6F, 0x08, 0x20, 0x06, 0x0B, 0x0E, 0x0F, 0x0E, 0x0A, 0x03, 0x10, 0x10,
+  0x01, 0x07, 0x0D, 0x0F, 0x0E, 0x0C, 0x06, 0x10, 0x01, 0x0C, 0x5F, 0x06,
+  0x00, 0x0B, 0x1F, 0x07, 0x11, 0x07, 0x08, 0x00, 0x03, 0x1F, 0x09, 0x50,
+  0x08, 0x1F, 0x03, 0x50, 0x0B, 0x1F, 0x03, 0x0A, 0x1E, 0x0B, 0x03, 0x00,
+  0x0C, 0x1F, 0x0E, 0x4F, 0x03, 0x0B, 0x1F, 0x0B, 0x03, 0x01, 0x06, 0x1F,
+  0x1A, 0x1F, 0x02, 0x20, 0x0D, 0x0F, 0x0D, 0x06, 0x1F, 0x05, 0x20, 0x0D,
+  0x0F, 0x0C, 0x00, 0x0D, 0x0F, 0x0D, 0x03, 0x01, 0x07, 0x1F, 0x08, 0x00,
+  0x04, 0x0E, 0x4F, 0x0C, 0x20, 0x02, 0x0A, 0x0E, 0x0F, 0x0D, 0x08, 0x01,
+  0x00, 0x0C, 0x7F, 0x1C, 0x7F, 0x09, 0x50, 0x0B, 0x0F, 0x0C, 0x01, 0x40,
+  0x06, 0x1F, 0x03, 0x40, 0x01, 0x0E, 0x0F, 0x09, 0x50, 0x07, 0x1F, 0x02,
+  0x50, 0x0D, 0x0F, 0x0B, 0x50, 0x04, 0x1F, 0x07, 0x50, 0x08, 0x1F, 0x04,
+  0x50, 0x0B, 0x1F, 0x01, 0x50, 0x0E, 0x1F, 0x60, 0x1F, 0x0E, 0x50, 0x02,
+  0x1F, 0x0D, 0x30, 0x10, 0x06, 0x0C, 0x1E, 0x0C, 0x06, 0x20, 0x09, 0x5F,
+  0x09, 0x00, 0x02, 0x1F, 0x0A, 0x11, 0x09, 0x1F, 0x02, 0x03, 0x1F, 0x07,
+  0x10, 0x04, 0x1F, 0x03, 0x00, 0x0D, 0x0F, 0x0E, 0x07, 0x02, 0x0A, 0x0F,
+  0x0D, 0x10, 0x02, 0x0C, 0x3F, 0x0D, 0x02, 0x10, 0x04, 0x0D, 0x3F, 0x0D,
+  0x04, 0x00, 0x03, 0x1F, 0x08, 0x03, 0x0A, 0x2F, 0x03, 0x0A, 0x0F, 0x0D,
+  0x20, 0x05, 0x1F, 0x09, 0x0B, 0x0F, 0x0D, 0x30, 0x1F, 0x0B, 0x08, 0x1F,
+  0x08, 0x11, 0x08, 0x1F, 0x09, 0x01, 0x0D, 0x5F, 0x0D, 0x02, 0x00, 0x01,
+  0x07, 0x0D, 0x1F, 0x0D, 0x08, 0x01, 0x00, 0x00, 0x01, 0x08, 0x0D, 0x0F,
+  0x0E, 0x09, 0x02, 0x10, 0x01, 0x0C, 0x4F, 0x0E, 0x03, 0x00, 0x08, 0x1F,
+  0x07, 0x01, 0x03, 0x0E, 0x0F, 0x0D, 0x00, 0x0D, 0x0F, 0x0D, 0x20, 0x06,
+  0x1F, 0x05, 0x0E, 0x0F, 0x0C, 0x20, 0x02, 0x1F, 0x09, 0x0B, 0x1F, 0x05,
+  0x01, 0x03, 0x0C, 0x1F, 0x0B, 0x03, 0x4F, 0x0E, 0x1F, 0x0B, 0x00, 0x04,
+  0x0B, 0x1E, 0x0A, 0x02, 0x1F, 0x0A, 0x50, 0x03, 0x1F, 0x07, 0x50, 0x09,
+  0x1F, 0x03, 0x00, 0x08, 0x07, 0x11, 0x07, 0x1F, 0x0A, 0x00, 0x07, 0x5F,
+  0x0C, 0x01, 0x10, 0x06, 0x0C, 0x0E, 0x0F, 0x0D, 0x07, 0x01, 0x10 };
+
+const GFXglyph SourceCodePro_Bold10pt7b_aa4Glyphs[] PROGMEM = {
+  {     0,  10,   2,  12,    1,   -7 },   // 0x2D '-'
+  {     5,   6,   5,  12,    3,   -4 },   // 0x2E '.'
+  {    24,  10,  17,  12,    1,  -13 },   // 0x2F '/'
+  {    95,  10,  13,  12,    1,  -12 },   // 0x30 '0'
+  {   190,  10,  13,  12,    1,  -12 },   // 0x31 '1'
+  {   244,  10,  13,  12,    1,  -12 },   // 0x32 '2'
+  {   311,  11,  13,  12,    0,  -12 },   // 0x33 '3'
+  {   393,  12,  13,  12,    0,  -12 },   // 0x34 '4'
+  {   467,  11,  13,  12,    0,  -12 },   // 0x35 '5'
+  {   539,  10,  13,  12,    1,  -12 },   // 0x36 '6'
+  {   625,  10,  13,  12,    1,  -12 },   // 0x37 '7'
+  {   675,  10,  13,  12,    1,  -12 },   // 0x38 '8'
+  {   763,  10,  13,  12,    1,  -12 } }; // 0x39 '9'
+
+const GFXaafont SourceCodePro_Bold10pt7b_aa4 PROGMEM = {
+  (uint8_t  *)SourceCodePro_Bold10pt7b_aa4Bitmaps,
+  (GFXglyph *)SourceCodePro_Bold10pt7b_aa4Glyphs,
+  (GFXkern  *)NULL, 0,
+  0x2D, 0x39, 25, 20, 4 };
+
+// Approx. 954 bytes
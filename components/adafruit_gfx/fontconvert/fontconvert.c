@@ -8,6 +8,10 @@ fonts to be used with the Adafruit_GFX Arduino library.
 For UNIX-like systems.  Outputs to stdout; redirect to header file, e.g.:
   ./fontconvert ~/Library/Fonts/FreeSans.ttf 18 > FreeSans18pt7b.h
 
+With -a2 or -a4 as first argument an anti-aliased GFXaafont with 2 or 4
+bits of alpha per pixel is written instead, for drawAAText(), e.g.:
+  ./fontconvert -a4 ~/Library/Fonts/FreeSans.ttf 18 > FreeSans18pt7b_aa4.h
+
 REQUIRES FREETYPE LIBRARY.  www.freetype.org
 
 Currently this only extracts the printable 7-bit ASCII chars of a font.
@@ -29,29 +33,55 @@ See notes at end for glyph nomenclature & other tidbits.
 
 #define DPI 141 // Approximate res. of Adafruit 2.8" TFT
 
+// Hexadecimal byte write, 12 per line
+void enbyte(uint8_t value) {
+  static uint8_t row = 0, firstCall = 1;
+  if (!firstCall) {    // Format output table nicely
+    if (++row >= 12) { // Last entry on line?
+      printf(",\n  "); //   Newline format output
+      row = 0;         //   Reset row counter
+    } else {           // Not end of line
+      printf(", ");    //   Simple comma delim
+    }
+  }
+  printf("0x%02X", value); // Write byte value
+  firstCall = 0;           // Formatting flag
+}
+
 // Accumulate bits for output, with periodic hexadecimal byte write
 void enbit(uint8_t value) {
-  static uint8_t row = 0, sum = 0, bit = 0x80, firstCall = 1;
+  static uint8_t sum = 0, bit = 0x80;
   if (value)
-    sum |= bit;          // Set bit if needed
-  if (!(bit >>= 1)) {    // Advance to next bit, end of byte reached?
-    if (!firstCall) {    // Format output table nicely
-      if (++row >= 12) { // Last entry on line?
-        printf(",\n  "); //   Newline format output
-        row = 0;         //   Reset row counter
-      } else {           // Not end of line
-        printf(", ");    //   Simple comma delim
-      }
-    }
-    printf("0x%02X", sum); // Write byte value
-    sum = 0;               // Clear for next byte
-    bit = 0x80;            // Reset bit counter
-    firstCall = 0;         // Formatting flag
+    sum |= bit;       // Set bit if needed
+  if (!(bit >>= 1)) { // Advance to next bit, end of byte reached?
+    enbyte(sum);      // Write byte value
+    sum = 0;          // Clear for next byte
+    bit = 0x80;       // Reset bit counter
   }
 }
 
+// Accumulate anti-aliased pixels into runs, each written as one byte
+// ((run - 1) << bpp) | alpha. A negative alpha flushes the pending run.
+// Returns the number of bytes written.
+int enrun(int alpha, int bpp) {
+  static int current = -1, run = 0;
+  int written = 0;
+  if ((run > 0) &&
+      ((alpha != current) || (run == (256 >> bpp)))) { // Run complete?
+    enbyte(((run - 1) << bpp) | current);
+    written = 1;
+    run = 0;
+  }
+  if (alpha >= 0) {
+    current = alpha;
+    run++;
+  }
+  return written;
+}
+
 int main(int argc, char *argv[]) {
   int i, j, err, size, first = ' ', last = '~', bitmapOffset = 0, x, y, byte;
+  int bpp = 0, kernCount = 0;
   char *fontName, c, *ptr;
   FT_Library library;
   FT_Face face;
@@ -59,17 +89,27 @@ int main(int argc, char *argv[]) {
   FT_Bitmap *bitmap;
   FT_BitmapGlyphRec *g;
   GFXglyph *table;
+  GFXkern *kern;
+  FT_Vector delta;
   uint8_t bit;
 
   // Parse command line.  Valid syntaxes are:
   //   fontconvert [filename] [size]
   //   fontconvert [filename] [size] [last char]
   //   fontconvert [filename] [size] [first char] [last char]
+  // Each optionally preceded by -a2 or -a4 for an anti-aliased font.
   // Unless overridden, default first and last chars are
   // ' ' (space) and '~', respectively
 
+  if ((argc > 1) && (!strcmp(argv[1], "-a2") || !strcmp(argv[1], "-a4"))) {
+    bpp = argv[1][2] - '0';
+    argv++;
+    argc--;
+  }
+
   if (argc < 3) {
-    fprintf(stderr, "Usage: %s fontfile size [first] [last]\n", argv[0]);
+    fprintf(stderr, "Usage: %s [-a2|-a4] fontfile size [first] [last]\n",
+            argv[0]);
     return 1;
   }
 
@@ -110,6 +150,8 @@ int main(int argc, char *argv[]) {
   // Insert font size and 7/8 bit.  fontName was alloc'd w/extra
   // space to allow this, we're not sprintfing into Forbidden Zone.
   sprintf(ptr, "%dpt%db", size, (last > 127) ? 8 : 7);
+  if (bpp)
+    sprintf(&ptr[strlen(ptr)], "_aa%d", bpp);
   // Space and punctuation chars in name replaced w/ underscores.
   for (i = 0; (c = fontName[i]); i++) {
     if (isspace(c) || ispunct(c))
@@ -126,9 +168,12 @@ int main(int argc, char *argv[]) {
   // This improves clarity of fonts since this library does not
   // support rendering multiple levels of gray in a glyph.
   // See https://github.com/adafruit/Adafruit-GFX-Library/issues/103
-  FT_UInt interpreter_version = TT_INTERPRETER_VERSION_35;
-  FT_Property_Set(library, "truetype", "interpreter-version",
-                  &interpreter_version);
+  // Anti-aliased fonts keep the default, gray levels are used there.
+  if (!bpp) {
+    FT_UInt interpreter_version = TT_INTERPRETER_VERSION_35;
+    FT_Property_Set(library, "truetype", "interpreter-version",
+                    &interpreter_version);
+  }
 
   if ((err = FT_New_Face(library, argv[1], 0, &face))) {
     fprintf(stderr, "Font load error: %d", err);
@@ -151,12 +196,16 @@ int main(int argc, char *argv[]) {
   for (i = first, j = 0; i <= last; i++, j++) {
     // MONO renderer provides clean image with perfect crop
     // (no wasted pixels) via bitmap struct.
-    if ((err = FT_Load_Char(face, i, FT_LOAD_TARGET_MONO))) {
+    // The NORMAL renderer gives 8 bits of gray per pixel, quantized
+    // to bpp bits below.
+    if ((err = FT_Load_Char(face, i,
+                            bpp ? FT_LOAD_TARGET_NORMAL : FT_LOAD_TARGET_MONO))) {
       fprintf(stderr, "Error %d loading char '%c'\n", err, i);
       continue;
     }
 
-    if ((err = FT_Render_Glyph(face->glyph, FT_RENDER_MODE_MONO))) {
+    if ((err = FT_Render_Glyph(face->glyph, bpp ? FT_RENDER_MODE_NORMAL
+                                                : FT_RENDER_MODE_MONO))) {
       fprintf(stderr, "Error %d rendering char '%c'\n", err, i);
       continue;
     }
@@ -184,6 +233,20 @@ int main(int argc, char *argv[]) {
     table[j].xOffset = g->left;
     table[j].yOffset = 1 - g->top;
 
+    if (bpp) {
+      // Runs of equal alpha, continuing across rows but not glyphs
+      int levels = (1 << bpp) - 1;
+      for (y = 0; y < bitmap->rows; y++) {
+        for (x = 0; x < bitmap->width; x++) {
+          int gray = bitmap->buffer[y * bitmap->pitch + x];
+          bitmapOffset += enrun((gray * levels + 127) / 255, bpp);
+        }
+      }
+      bitmapOffset += enrun(-1, bpp);
+      FT_Done_Glyph(glyph);
+      continue;
+    }
+
     for (y = 0; y < bitmap->rows; y++) {
       for (x = 0; x < bitmap->width; x++) {
         byte = x / 8;
@@ -206,6 +269,39 @@ int main(int argc, char *argv[]) {
 
   printf(" };\n\n"); // End bitmap array
 
+  // Kerning pairs within first - last, sorted by left then right.
+  // Only the legacy 'kern' table is read, GPOS kerning is ignored.
+  if (bpp && FT_HAS_KERNING(face)) {
+    if (!(kern = (GFXkern *)malloc((last - first + 1) * (last - first + 1) *
+                                   sizeof(GFXkern)))) {
+      fprintf(stderr, "Malloc error\n");
+      return 1;
+    }
+    for (i = first; i <= last; i++) {
+      for (j = first; j <= last; j++) {
+        if (FT_Get_Kerning(face, FT_Get_Char_Index(face, i),
+                           FT_Get_Char_Index(face, j), FT_KERNING_DEFAULT,
+                           &delta))
+          continue;
+        int adjust = (delta.x + 32) >> 6; // Round 26.6 to pixels
+        if (adjust) {
+          kern[kernCount].left = i;
+          kern[kernCount].right = j;
+          kern[kernCount++].adjust = adjust;
+        }
+      }
+    }
+    if (kernCount) {
+      printf("const GFXkern %sKerning[] PROGMEM = {\n  ", fontName);
+      for (i = 0; i < kernCount; i++) {
+        printf("{ 0x%02X, 0x%02X, %3d }%s", kern[i].left, kern[i].right,
+               kern[i].adjust,
+               (i == kernCount - 1) ? " };\n\n"
+                                    : ((i % 4) == 3) ? ",\n  " : ", ");
+      }
+    }
+  }
+
   // Output glyph attributes table (one per character)
   printf("const GFXglyph %sGlyphs[] PROGMEM = {\n", fontName);
   for (i = first, j = 0; i <= last; i++, j++) {
@@ -225,6 +321,27 @@ int main(int argc, char *argv[]) {
     printf(" '%c'", last);
   printf("\n\n");
 
+  if (bpp) {
+    // Output anti-aliased font structure. Cells are yAdvance rows
+    // high with the baseline ascent - 1 rows below their top.
+    printf("const GFXaafont %s PROGMEM = {\n", fontName);
+    printf("  (uint8_t  *)%sBitmaps,\n", fontName);
+    printf("  (GFXglyph *)%sGlyphs,\n", fontName);
+    if (kernCount)
+      printf("  (GFXkern  *)%sKerning, %d,\n", fontName, kernCount);
+    else
+      printf("  (GFXkern  *)NULL, 0,\n");
+    printf("  0x%02X, 0x%02X, %ld, %ld, %d };\n\n", first, last,
+           face->size->metrics.height >> 6,
+           (face->size->metrics.ascender + 63) >> 6, bpp);
+    printf("// Approx. %d bytes\n",
+           bitmapOffset + (last - first + 1) * 7 + kernCount * 3 + 12);
+
+    FT_Done_FreeType(library);
+
+    return 0;
+  }
+
   // Output font structure
   printf("const GFXfont %s PROGMEM = {\n", fontName);
   printf("  (uint8_t  *)%sBitmaps,\n", fontName);
@@ -26,4 +26,26 @@ typedef struct {
   uint8_t yAdvance; ///< Newline distance (y axis)
 } GFXfont;
 
+/// Kerning pair of an anti-aliased font
+typedef struct {
+  uint8_t left;  ///< First character
+  uint8_t right; ///< Character following it
+  int8_t adjust; ///< Added to the xAdvance of left when followed by right
+} GFXkern;
+
+/// Anti-aliased font. Each glyph bitmap is a run-length coded stream of
+/// bytes ((run - 1) << bpp) | alpha, covering the glyph pixels row by row.
+/// Runs continue across rows. Glyph metrics are the same as in GFXfont.
+typedef struct {
+  uint8_t *bitmap;    ///< Run-length coded glyphs, concatenated
+  GFXglyph *glyph;    ///< Glyph array
+  GFXkern *kern;      ///< Kerning pairs sorted by left, then right
+  uint16_t kernCount; ///< Number of kerning pairs
+  uint16_t first;     ///< ASCII extents (first char)
+  uint16_t last;      ///< ASCII extents (last char)
+  uint8_t yAdvance;   ///< Newline distance (y axis), height of a text cell
+  uint8_t ascent;     ///< Rows from the top of a text cell to the baseline
+  uint8_t bpp;        ///< Alpha bits per pixel, 2 or 4
+} GFXaafont;
+
 #endif // _GFXFONT_H_
@@ -0,0 +1,102 @@
+/**************************************************************************
+  Banded canvas example for ST7735 displays.
+
+  A full 128x160 GFXcanvas16 needs 40 KB of RAM. GFXcanvasBanded16 keeps
+  only two bands (here 128x6 pixels, 3 KB together) and draws the image
+  once per band. drawBands() sends each band as soon as it is drawn and,
+  on ESP32 with DMA, draws the next band while the previous one is on
+  the bus. Bands that were not marked dirty are neither drawn nor sent.
+
+  setup() first checks every band against a full GFXcanvas16 drawn with
+  the same scene and prints the result, then loop() moves a ball across
+  the screen and only redraws the bands it touches.
+ **************************************************************************/
+
+#include <Adafruit_GFX.h>    // Core graphics library
+#include <Adafruit_ST7735.h> // Hardware-specific library for ST7735
+#include <SPI.h>
+
+#define TFT_CS        5
+#define TFT_RST       21
+#define TFT_DC        22
+
+#define BAND_HEIGHT   6
+
+Adafruit_ST7735 tft = Adafruit_ST7735(TFT_CS, TFT_DC, TFT_RST);
+GFXcanvasBanded16 canvas(128, 160, BAND_HEIGHT);
+
+int16_t ballX = 20, ballY = 30, dx = 3, dy = 2;
+
+void drawScene(Adafruit_GFX &gfx) {
+  gfx.fillScreen(ST77XX_BLACK);
+  gfx.drawRoundRect(0, 0, 128, 160, 8, ST77XX_BLUE);
+  gfx.setCursor(8, 8);
+  gfx.setTextColor(ST77XX_YELLOW);
+  gfx.setTextSize(2);
+  gfx.print("Bands");
+  gfx.fillCircle(ballX, ballY, 10, ST77XX_RED);
+}
+
+void render(GFXcanvasBanded16 &c, void *arg) {
+  (void)arg;
+  drawScene(c);
+}
+
+bool compareWithCanvas() {
+  GFXcanvas16 reference(128, 160);
+  if (!reference.getBuffer()) {
+    Serial.println("Not enough RAM for the reference canvas");
+    return false;
+  }
+  drawScene(reference);
+
+  uint32_t mismatches = 0;
+  for (uint16_t band = 0; band < canvas.bands(); band++) {
+    canvas.selectBand(band);
+    drawScene(canvas);
+    const uint16_t *strip = canvas.getBuffer();
+    const uint16_t *expected =
+        reference.getBuffer() + canvas.bandY() * canvas.bandWidth();
+    for (int32_t i = 0; i < canvas.bandWidth() * canvas.bandHeight(); i++) {
+      // Bands are stored in display byte order
+      if (__builtin_bswap16(strip[i]) != expected[i])
+        mismatches++;
+    }
+  }
+  Serial.print("Band mismatches: ");
+  Serial.println(mismatches);
+  return mismatches == 0;
+}
+
+void setup(void) {
+  Serial.begin(115200);
+  tft.initR(INITR_BLACKTAB);
+
+  compareWithCanvas();
+
+  canvas.markDirty();
+  uint32_t start = micros();
+  tft.drawBands(0, 0, canvas, render);
+  Serial.print("Full redraw: ");
+  Serial.print(micros() - start);
+  Serial.println(" us");
+}
+
+void loop() {
+  // Old and new ball position are the only changes
+  canvas.markDirty(ballX - 10, ballY - 10, 21, 21);
+  ballX += dx;
+  ballY += dy;
+  if ((ballX < 12) || (ballX > 115))
+    dx = -dx;
+  if ((ballY < 30) || (ballY > 147))
+    dy = -dy;
+  canvas.markDirty(ballX - 10, ballY - 10, 21, 21);
+
+  uint32_t start = micros();
+  tft.drawBands(0, 0, canvas, render);
+  Serial.print("Partial redraw: ");
+  Serial.print(micros() - start);
+  Serial.println(" us");
+  delay(20);
+}
@@ -0,0 +1,79 @@
+/**************************************************************************
+  Fill benchmark for ST7735 displays on ESP32.
+
+  Compares solid fills sent the old way, one writePixels() call per 32
+  pixel buffer, with fillScreen()/fillRect(), which now stream the color
+  as one repeating SPIClass::writePattern() transfer per address window.
+  Results are printed as fills per second.
+ **************************************************************************/
+
+#include <Adafruit_GFX.h>    // Core graphics library
+#include <Adafruit_ST7735.h> // Hardware-specific library for ST7735
+#include <SPI.h>
+
+#define TFT_CS        5
+#define TFT_RST       21
+#define TFT_DC        22
+
+#define RUNS          50
+
+Adafruit_ST7735 tft = Adafruit_ST7735(TFT_CS, TFT_DC, TFT_RST);
+
+const uint16_t colors[] = {ST77XX_RED, ST77XX_GREEN, ST77XX_BLUE,
+                           ST77XX_BLACK};
+
+// The fill loop writeColor() used before, one transfer per 32 pixels
+void fillRectBuffered(int16_t x, int16_t y, int16_t w, int16_t h,
+                      uint16_t color) {
+  static uint16_t temp[32];
+  for (uint8_t i = 0; i < 32; i++)
+    temp[i] = color;
+
+  uint32_t len = (uint32_t)w * h;
+  tft.startWrite();
+  tft.setAddrWindow(x, y, w, h);
+  while (len) {
+    uint32_t n = (len < 32) ? len : 32;
+    tft.writePixels(temp, n);
+    len -= n;
+  }
+  tft.endWrite();
+}
+
+void report(const char *name, uint32_t us) {
+  Serial.print(name);
+  Serial.print(": ");
+  Serial.print(RUNS * 1000000.0f / us, 1);
+  Serial.println(" fills/s");
+}
+
+void benchmark(int16_t w, int16_t h) {
+  uint32_t start;
+
+  Serial.print(w);
+  Serial.print("x");
+  Serial.println(h);
+
+  start = micros();
+  for (int i = 0; i < RUNS; i++)
+    fillRectBuffered(0, 0, w, h, colors[i & 3]);
+  report("  writePixels per 32 pixels", micros() - start);
+
+  start = micros();
+  for (int i = 0; i < RUNS; i++)
+    tft.fillRect(0, 0, w, h, colors[i & 3]);
+  report("  fillRect pattern        ", micros() - start);
+}
+
+void setup(void) {
+  Serial.begin(115200);
+  tft.initR(INITR_BLACKTAB);
+  tft.setSPISpeed(40000000);
+}
+
+void loop() {
+  benchmark(tft.width(), tft.height());
+  benchmark(64, 64);
+  benchmark(16, 16);
+  delay(5000);
+}
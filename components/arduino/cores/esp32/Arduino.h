@@ -195,6 +195,7 @@ void shiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t val);
 #include "Stream.h"
 #include "Printable.h"
 #include "Print.h"
+#include "StringView.h"
 #include "IPAddress.h"
 #include "Client.h"
 #include "Server.h"
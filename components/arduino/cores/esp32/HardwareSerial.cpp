@@ -3,6 +3,7 @@
 #include <string.h>
 #include <inttypes.h>
 #include <ctime>
+#include <new>
 
 #include "pins_arduino.h"
 #include "io_pin_remap.h"
@@ -120,7 +121,7 @@ void serialEventRun(void) {
 #endif
 
 HardwareSerial::HardwareSerial(uint8_t uart_nr)
-  : _uart_nr(uart_nr), _uart(NULL), _rxBufferSize(256), _txBufferSize(0), _onReceiveCB(NULL), _onReceiveErrorCB(NULL), _onReceiveTimeout(false), _rxTimeout(1),
+  : _uart_nr(uart_nr), _uart(NULL), _rxBufferSize(256), _txBufferSize(0), _onReceiveCB(NULL), _onReceiveErrorCB(NULL), _frameReceiver(NULL), _onReceiveTimeout(false), _rxTimeout(1),
     _rxFIFOFull(0), _eventTask(NULL)
 #if !CONFIG_DISABLE_HAL_LOCKS
     ,
@@ -202,6 +203,59 @@ void HardwareSerial::onReceive(OnReceiveCb function, bool onlyOnTimeout) {
   HSERIAL_MUTEX_UNLOCK();
 }
 
+bool HardwareSerial::onReceiveFrame(OnReceiveFrameCb function, SerialFrameParser parser, size_t maxFrameSize, size_t frameBuffers) {
+  SerialFrameReceiver *receiver = NULL;
+  if (function != NULL) {
+    receiver = new (std::nothrow) SerialFrameReceiver();
+    if (receiver == NULL || !receiver->begin(maxFrameSize, frameBuffers, parser ? parser : SerialFrameReceiver::delimiter('\n'), function)) {
+      log_e("UART%d frame receiver not created, it needs a frame size and two or more buffers.", _uart_nr);
+      delete receiver;
+      return false;
+    }
+  }
+  HSERIAL_MUTEX_LOCK();
+  // the event task uses the receiver without locking, it must not run while it changes
+  _destroyEventTask();
+  delete _frameReceiver;
+  _frameReceiver = receiver;
+  if (_uart != NULL && (_onReceiveCB != NULL || _onReceiveErrorCB != NULL || _frameReceiver != NULL)) {
+    _createEventTask(this);
+  }
+  HSERIAL_MUTEX_UNLOCK();
+  return true;
+}
+
+void HardwareSerial::releaseFrame(SerialFrame *frame) {
+  if (_frameReceiver == NULL || frame == NULL) {
+    return;
+  }
+  _frameReceiver->release(frame);
+  if (_frameReceiver->waiting()) {
+    // wake up the event task, a complete frame waits for this buffer
+    QueueHandle_t uartEventQueue = NULL;
+    uartGetEventQueue(_uart, &uartEventQueue);
+    if (uartEventQueue != NULL) {
+      uart_event_t event = {};
+      event.type = UART_DATA;
+      xQueueSend(uartEventQueue, &event, 0);
+    }
+  }
+}
+
+// Reads the RX Buffer straight into the frame buffers, the frame callback is called from here
+void HardwareSerial::_receiveFrames(void) {
+  _frameReceiver->commit(0);
+  uint8_t *data;
+  size_t room;
+  while ((room = _frameReceiver->writeSpan(&data)) > 0) {
+    size_t len = uartReadBytes(_uart, data, room, 0);
+    if (len == 0) {
+      break;
+    }
+    _frameReceiver->commit(len);
+  }
+}
+
 // This function allow the user to define how many bytes will trigger an Interrupt that will copy RX FIFO to the internal RX Ringbuffer
 // ISR will also move data from FIFO to RX Ringbuffer after a RX Timeout defined in HardwareSerial::setRxTimeout(uint8_t symbols_timeout)
 // A low value of FIFO Full bytes will consume more CPU time within the ISR
@@ -265,6 +319,9 @@ void HardwareSerial::_uartEventTask(void *args) {
         hardwareSerial_error_t currentErr = UART_NO_ERROR;
         switch (event.type) {
           case UART_DATA:
+            if (uart->_frameReceiver) {
+              uart->_receiveFrames();
+            }
             if (uart->_onReceiveCB && uart->available() > 0 && ((uart->_onReceiveTimeout && event.timeout_flag) || !uart->_onReceiveTimeout)) {
               uart->_onReceiveCB();
             }
@@ -276,6 +333,9 @@ void HardwareSerial::_uartEventTask(void *args) {
           case UART_BUFFER_FULL:
             log_w("UART%d Buffer Full. Consider increasing your buffer size of your Application.", uart->_uart_nr);
             currentErr = UART_BUFFER_FULL_ERROR;
+            if (uart->_frameReceiver) {
+              uart->_receiveFrames();
+            }
             break;
           case UART_BREAK:
             log_v("UART%d RX break.", uart->_uart_nr);
@@ -449,7 +509,7 @@ void HardwareSerial::begin(unsigned long baud, uint32_t config, int8_t rxPin, in
   }
   // create a task to deal with Serial Events when, for example, calling begin() twice to change the baudrate,
   // or when setting the callback before calling begin()
-  if (_uart != NULL && (_onReceiveCB != NULL || _onReceiveErrorCB != NULL) && _eventTask == NULL) {
+  if (_uart != NULL && (_onReceiveCB != NULL || _onReceiveErrorCB != NULL || _frameReceiver != NULL) && _eventTask == NULL) {
     _createEventTask(this);
   }
 
@@ -489,6 +549,8 @@ void HardwareSerial::end() {
   _rxFIFOFull = 0;
   uartEnd(_uart_nr);    // fully detach all pins and delete the UART driver
   _destroyEventTask();  // when IDF uart driver is deleted, _eventTask must finish too
+  delete _frameReceiver;
+  _frameReceiver = NULL;
   _uart = NULL;
 }
 
@@ -48,6 +48,7 @@
 #include <inttypes.h>
 #include <functional>
 #include "Stream.h"
+#include "SerialFrameReceiver.h"
 #include "esp32-hal.h"
 #include "soc/soc_caps.h"
 #include "HWCDC.h"
@@ -302,6 +303,17 @@ public:
   // onReceive will be called on error events (see hardwareSerial_error_t)
   void onReceiveError(OnReceiveErrorCb function);
 
+  // onReceiveFrame splits the received bytes into frames, see SerialFrameReceiver.h
+  // parser runs in the UART event task on the bytes received so far, it can look for a delimiter
+  // (SerialFrameReceiver::delimiter()) or read a length from a frame header. Without one, frames are lines ending in '\n'.
+  // function is called in the same task with every complete frame and gets the pool buffer itself,
+  // it has to give the frame back with releaseFrame(), possibly later and from another task.
+  // While all frameBuffers are handed out, the bytes stay in the RX Buffer.
+  // All bytes received go to frames, read() and onReceive() get none. NULL function stops it,
+  // all frames must have been released by then.
+  bool onReceiveFrame(OnReceiveFrameCb function, SerialFrameParser parser = NULL, size_t maxFrameSize = 64, size_t frameBuffers = 4);
+  void releaseFrame(SerialFrame *frame);
+
   // eventQueueReset clears all events in the queue (the events that trigger onReceive and onReceiveError) - maybe useful in some use cases
   void eventQueueReset();
 
@@ -396,6 +408,7 @@ protected:
   size_t _txBufferSize;
   OnReceiveCb _onReceiveCB;
   OnReceiveErrorCb _onReceiveErrorCB;
+  SerialFrameReceiver *_frameReceiver;
   // _onReceive and _rxTimeout have be consistent when timeout is disabled
   bool _onReceiveTimeout;
   uint8_t _rxTimeout, _rxFIFOFull;
@@ -407,6 +420,7 @@ protected:
   void _createEventTask(void *args);
   void _destroyEventTask(void);
   static void _uartEventTask(void *args);
+  void _receiveFrames(void);
 };
 
 extern void serialEventRun(void) __attribute__((weak));
@@ -28,6 +28,7 @@
 #include "Arduino.h"
 
 #include "Print.h"
+#include "StringView.h"
 extern "C" {
 #include "time.h"
 }
@@ -43,31 +44,52 @@ size_t Print::write(const uint8_t *buffer, size_t size) {
   return n;
 }
 
+// Destination of the stream vprintf() formats into
+struct PrintStream {
+  Print &out;
+  size_t written;
+};
+
+#ifdef __NEWLIB__
+static _READ_WRITE_RETURN_TYPE printStreamWrite(struct _reent *, void *cookie, const char *data, _READ_WRITE_BUFSIZE_TYPE size) {
+#else
+static ssize_t printStreamWrite(void *cookie, const char *data, size_t size) {
+#endif
+  PrintStream *stream = (PrintStream *)cookie;
+  stream->written += stream->out.write((const uint8_t *)data, size);
+  return size;
+}
+
+// The C library formats the whole output in one pass into a stream with a small
+// stack buffer, which passes the text on to the destination each time it fills up.
 size_t Print::vprintf(const char *format, va_list arg) {
-  char loc_buf[64];
-  char *temp = loc_buf;
-  va_list copy;
-  va_copy(copy, arg);
-  int len = vsnprintf(temp, sizeof(loc_buf), format, copy);
-  va_end(copy);
-  if (len < 0) {
-    va_end(arg);
+  PrintStream stream = {*this, 0};
+  char buf[64];
+#ifdef __NEWLIB__
+  // set up on the stack like the one of newlib's __sbprintf(), no heap and no lock
+  FILE file;
+  memset(&file, 0, sizeof(file));
+  file._flags = __SWR;
+  file._flags2 = __SNLK;
+  file._file = -1;
+  file._bf._base = file._p = (unsigned char *)buf;
+  file._bf._size = file._w = sizeof(buf);
+  file._cookie = &stream;
+  file._write = printStreamWrite;
+  _vfprintf_r(_REENT, &file, format, arg);
+  _fflush_r(_REENT, &file);
+#else
+  // other C libraries, e.g. in host tests, only have an allocated cookie stream
+  cookie_io_functions_t functions = {NULL, printStreamWrite, NULL, NULL};
+  FILE *file = fopencookie(&stream, "w", functions);
+  if (file == NULL) {
     return 0;
   }
-  if (len >= (int)sizeof(loc_buf)) {  // comparison of same sign type for the compiler
-    temp = (char *)malloc(len + 1);
-    if (temp == NULL) {
-      va_end(arg);
-      return 0;
-    }
-    len = vsnprintf(temp, len + 1, format, arg);
-  }
-  va_end(arg);
-  len = write((uint8_t *)temp, len);
-  if (temp != loc_buf) {
-    free(temp);
-  }
-  return len;
+  setvbuf(file, buf, _IOFBF, sizeof(buf));
+  vfprintf(file, format, arg);
+  fclose(file);
+#endif
+  return stream.written;
 }
 
 size_t Print::printf(const __FlashStringHelper *ifsh, ...) {
@@ -91,6 +113,10 @@ size_t Print::print(const String &s) {
   return write(s.c_str(), s.length());
 }
 
+size_t Print::print(const StringView &s) {
+  return write(s.data(), s.length());
+}
+
 size_t Print::print(const char str[]) {
   return write(str);
 }
@@ -176,6 +202,12 @@ size_t Print::println(const String &s) {
   return n;
 }
 
+size_t Print::println(const StringView &s) {
+  size_t n = print(s);
+  n += println();
+  return n;
+}
+
 size_t Print::println(const char c[]) {
   size_t n = print(c);
   n += println();
@@ -248,6 +280,49 @@ size_t Print::println(struct tm *timeinfo, const char *format) {
   return n;
 }
 
+// PrintBuffer ///////////////////////////////////////////////////////////////
+
+size_t PrintBuffer::write(const uint8_t *buffer, size_t size) {
+  if (size > sizeof(_buf) - _len) {
+    flush();
+    if (size >= sizeof(_buf)) {
+      // large pieces go straight to the destination
+      _written += _out.write(buffer, size);
+      return size;
+    }
+  }
+  memcpy(_buf + _len, buffer, size);
+  _len += size;
+  return size;
+}
+
+void PrintBuffer::flush() {
+  if (_len) {
+    _written += _out.write(_buf, _len);
+    _len = 0;
+  }
+}
+
+const char *PrintBuffer::text(const char *format) {
+  const char *start = format;
+  while (*format) {
+    if (*format == '{' || *format == '}') {
+      write(start, format - start);
+      if (format[0] == '{' && format[1] == '}') {
+        return format + 2;
+      }
+      // "{{" or "}}"
+      write((uint8_t)*format);
+      format += format[1] ? 2 : 1;
+      start = format;
+    } else {
+      format++;
+    }
+  }
+  write(start, format - start);
+  return format;
+}
+
 // Private Methods /////////////////////////////////////////////////////////////
 
 size_t Print::printNumber(unsigned long n, uint8_t base) {
@@ -22,7 +22,9 @@
 
 #include <stdint.h>
 #include <stdio.h>
+#include <stdarg.h>
 #include <stddef.h>
+#include <utility>
 
 #include "WString.h"
 #include "Printable.h"
@@ -32,6 +34,56 @@
 #define OCT 8
 #define BIN 2
 
+#if __cplusplus >= 202002L
+#define PRINT_FORMAT_CHECK consteval
+#else
+#define PRINT_FORMAT_CHECK constexpr  // checked only where the compiler evaluates it at compile time
+#endif
+
+// Format of print(format, args...): every "{}" is replaced by the next argument
+// as print(argument) prints it, "{{" and "}}" print a single brace.
+// A format that does not match the number of arguments does not compile.
+template<typename... Args> class PrintFormat {
+public:
+  template<size_t N> PRINT_FORMAT_CHECK PrintFormat(const char (&format)[N]) : _format(format) {
+    if (countFields(format) != sizeof...(Args)) {
+      print_format_does_not_match_arguments();
+    }
+  }
+
+  const char *c_str() const {
+    return _format;
+  }
+
+private:
+  const char *_format;
+
+  // returns the number of "{}" fields, or -1 for a single brace
+  static constexpr int countFields(const char *format) {
+    int count = 0;
+    for (; *format; format++) {
+      if (*format == '{' && format[1] == '}') {
+        count++;
+        format++;
+      } else if ((*format == '{' || *format == '}') && format[1] == *format) {
+        format++;
+      } else if (*format == '{' || *format == '}') {
+        return -1;
+      }
+    }
+    return count;
+  }
+
+  // not constexpr, calling it stops the compile time evaluation
+  static void print_format_does_not_match_arguments() {}
+};
+
+template<typename T> struct PrintFormatArg {
+  using type = T;
+};
+
+class StringView;
+
 class Print {
 private:
   int write_error;
@@ -71,6 +123,10 @@ public:
   size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
   size_t printf(const __FlashStringHelper *ifsh, ...);
 
+  // typed formatting without va_list, e.g. print("CO: {} ppm\n", co), see PrintFormat
+  template<typename T, typename... Args>
+  size_t print(PrintFormat<typename PrintFormatArg<T>::type, typename PrintFormatArg<Args>::type...> format, T &&arg, Args &&...args);
+
   // add availableForWrite to make compatible with Arduino Print.h
   // default to zero, meaning "a single write may block"
   // should be overridden by subclasses with buffering
@@ -81,6 +137,7 @@ public:
     return print(reinterpret_cast<const char *>(ifsh));
   }
   size_t print(const String &);
+  size_t print(const StringView &);
   size_t print(const char[]);
   size_t print(char);
   size_t print(unsigned char, int = DEC);
@@ -98,6 +155,7 @@ public:
     return println(reinterpret_cast<const char *>(ifsh));
   }
   size_t println(const String &s);
+  size_t println(const StringView &s);
   size_t println(const char[]);
   size_t println(char);
   size_t println(unsigned char, int = DEC);
@@ -115,4 +173,52 @@ public:
   virtual void flush() { /* Empty implementation for backward compatibility */ }
 };
 
+// Collects output on the stack and passes it on to another Print in chunks,
+// so formatted output reaches the destination in few writes without allocating
+class PrintBuffer : public Print {
+public:
+  explicit PrintBuffer(Print &out) : _out(out), _len(0), _written(0) {}
+  ~PrintBuffer() {
+    flush();
+  }
+
+  using Print::write;
+  size_t write(uint8_t c) override {
+    if (_len == sizeof(_buf)) {
+      flush();
+    }
+    _buf[_len++] = c;
+    return 1;
+  }
+  size_t write(const uint8_t *buffer, size_t size) override;
+
+  // passes the collected bytes on, does not flush the destination
+  void flush() override;
+
+  // writes the text up to the next "{}" of a PrintFormat and returns the position after it
+  const char *text(const char *format);
+
+  // bytes accepted by the destination so far
+  size_t written() {
+    flush();
+    return _written;
+  }
+
+private:
+  Print &_out;
+  uint8_t _buf[64];
+  size_t _len;
+  size_t _written;
+};
+
+template<typename T, typename... Args>
+size_t Print::print(PrintFormat<typename PrintFormatArg<T>::type, typename PrintFormatArg<Args>::type...> format, T &&arg, Args &&...args) {
+  PrintBuffer out(*this);
+  const char *p = out.text(format.c_str());
+  out.print(std::forward<T>(arg));
+  ((p = out.text(p), out.print(std::forward<Args>(args))), ...);
+  out.text(p);
+  return out.written();
+}
+
 #endif
@@ -0,0 +1,136 @@
+/*
+ SerialFrameReceiver.cpp - Splits a serial byte stream into frames
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "SerialFrameReceiver.h"
+
+SerialFrameReceiver::~SerialFrameReceiver() {
+  free(_frames);
+  free(_pool);
+}
+
+bool SerialFrameReceiver::begin(size_t frameSize, size_t frameCount, SerialFrameParser parser, OnReceiveFrameCb onFrame) {
+  if (frameSize == 0 || frameCount < 2 || !parser || !onFrame) {
+    return false;
+  }
+  SerialFrame *frames = (SerialFrame *)malloc(frameCount * sizeof(SerialFrame));
+  uint8_t *pool = (uint8_t *)malloc(frameCount * frameSize);
+  if (frames == NULL || pool == NULL) {
+    free(frames);
+    free(pool);
+    return false;
+  }
+  free(_frames);
+  free(_pool);
+  _frames = frames;
+  _pool = pool;
+  _frameSize = frameSize;
+  _parser = parser;
+  _onFrame = onFrame;
+  _free.store(NULL);
+  for (size_t i = 0; i < frameCount; i++) {
+    _frames[i].data = _pool + i * frameSize;
+    _frames[i].length = 0;
+    release(&_frames[i]);
+  }
+  _current = takeFree();
+  _pending.store(0);
+  _dropped = 0;
+  _frameCount = 0;
+  return true;
+}
+
+// Only the receiving task takes buffers, so a node cannot be taken and put
+// back between reading it and the exchange.
+SerialFrame *SerialFrameReceiver::takeFree() {
+  SerialFrame *frame = _free.load();
+  while (frame != NULL && !_free.compare_exchange_weak(frame, frame->next)) {}
+  return frame;
+}
+
+void SerialFrameReceiver::release(SerialFrame *frame) {
+  if (frame == NULL) {
+    return;
+  }
+  frame->length = 0;
+  frame->next = _free.load();
+  while (!_free.compare_exchange_weak(frame->next, frame)) {}
+}
+
+size_t SerialFrameReceiver::writeSpan(uint8_t **data) {
+  if (_current == NULL || _pending.load()) {
+    return 0;
+  }
+  *data = _current->data + _current->length;
+  return _frameSize - _current->length;
+}
+
+void SerialFrameReceiver::commit(size_t size) {
+  if (_current == NULL) {
+    return;
+  }
+  _current->length += size;
+  while (_current->length > 0) {
+    size_t frameLen = _pending.load();
+    if (frameLen == 0) {
+      int result = _parser(_current->data, _current->length);
+      if (result == 0) {
+        if (_current->length == _frameSize) {
+          // no frame ends within a buffer, start over with the next bytes
+          _dropped += _current->length;
+          _current->length = 0;
+        }
+        return;
+      }
+      if (result < 0) {
+        size_t drop = (size_t)-result < _current->length ? (size_t)-result : _current->length;
+        memmove(_current->data, _current->data + drop, _current->length - drop);
+        _current->length -= drop;
+        _dropped += drop;
+        continue;
+      }
+      frameLen = (size_t)result < _current->length ? (size_t)result : _current->length;
+    }
+
+    SerialFrame *next = takeFree();
+    if (next == NULL) {
+      // look again once waiting() is visible, a release() in between may not have seen it
+      _pending.store(frameLen);
+      next = takeFree();
+      if (next == NULL) {
+        return;
+      }
+    }
+    _pending.store(0);
+    SerialFrame *frame = _current;
+    next->length = frame->length - frameLen;
+    memcpy(next->data, frame->data + frameLen, next->length);
+    frame->length = frameLen;
+    _current = next;
+    _frameCount++;
+    _onFrame(frame);
+  }
+}
+
+SerialFrameParser SerialFrameReceiver::delimiter(uint8_t delimiter) {
+  return [delimiter](const uint8_t *data, size_t len) -> int {
+    const uint8_t *end = (const uint8_t *)memchr(data, delimiter, len);
+    return end ? end - data + 1 : 0;
+  };
+}
@@ -0,0 +1,101 @@
+/*
+ SerialFrameReceiver.h - Splits a serial byte stream into frames
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <stddef.h>
+#include <stdint.h>
+
+// A received frame. It belongs to the application from the frame callback
+// until it is given back with release(), possibly from another task.
+struct SerialFrame {
+  uint8_t *data;
+  size_t length;
+  SerialFrame *next;  // free list, used by the receiver only
+};
+
+// Looks at the bytes received so far, data[0] is the first byte of the next frame.
+// Returns the length of the complete frame at data, 0 if more bytes are needed,
+// or -n to drop n bytes that cannot start a frame.
+typedef std::function<int(const uint8_t *data, size_t len)> SerialFrameParser;
+
+typedef std::function<void(SerialFrame *frame)> OnReceiveFrameCb;
+
+// Assembles frames in a pool of fixed size buffers.
+//
+// The receiving task writes the incoming bytes straight into the buffer of the
+// frame being assembled (writeSpan() and commit()). Complete frames are handed
+// to the callback without another copy, only the bytes following a frame move
+// to the next buffer. While all buffers are handed out, writeSpan() is empty
+// and the bytes wait where they are, e.g. in the UART driver, until a frame
+// is released. release() may be called from any task.
+class SerialFrameReceiver {
+public:
+  SerialFrameReceiver() {}
+  ~SerialFrameReceiver();
+  SerialFrameReceiver(const SerialFrameReceiver &) = delete;
+  SerialFrameReceiver &operator=(const SerialFrameReceiver &) = delete;
+
+  // frameCount buffers of frameSize bytes, at least two, false if out of memory
+  bool begin(size_t frameSize, size_t frameCount, SerialFrameParser parser, OnReceiveFrameCb onFrame);
+
+  // free space for the frame being assembled, 0 while all buffers are handed out
+  size_t writeSpan(uint8_t **data);
+
+  // parses after size bytes were written to writeSpan(), hands out complete frames
+  // commit(0) retries a frame that waits for a free buffer
+  void commit(size_t size);
+
+  // gives a frame back to the pool
+  void release(SerialFrame *frame);
+
+  // bytes dropped by the parser or because a frame did not fit a buffer
+  size_t dropped() const {
+    return _dropped;
+  }
+
+  // true while a complete frame waits for a free buffer, the receiving task
+  // has to call commit(0) after the next release()
+  bool waiting() const {
+    return _pending.load() != 0;
+  }
+
+  // frames handed out since begin()
+  size_t frames() const {
+    return _frameCount;
+  }
+
+  // frame delimited by the byte delimiter, which is part of the frame
+  static SerialFrameParser delimiter(uint8_t delimiter);
+
+private:
+  SerialFrame *takeFree();
+
+  SerialFrame *_frames = NULL;
+  uint8_t *_pool = NULL;
+  size_t _frameSize = 0;
+  SerialFrameParser _parser;
+  OnReceiveFrameCb _onFrame;
+  SerialFrame *_current = NULL;     // frame being assembled
+  std::atomic<size_t> _pending{0};  // length of a complete frame in _current that waits for a free buffer
+  std::atomic<SerialFrame *> _free{NULL};
+  size_t _dropped = 0;
+  size_t _frameCount = 0;
+};
@@ -215,6 +215,30 @@ size_t Stream::readBytes(char *buffer, size_t length) {
 
 size_t Stream::readBytesUntil(char terminator, char *buffer, size_t length) {
   size_t index = 0;
+  while (index < length && hasPeekBufferAPI()) {
+    size_t avail = peekAvailable();
+    if (!avail) {
+      // wait for more data with the character path
+      int c = timedRead();
+      if (c < 0 || (char)c == terminator) {
+        return index;
+      }
+      buffer[index++] = (char)c;
+      continue;
+    }
+    if (avail > length - index) {
+      avail = length - index;
+    }
+    const char *data = peekBuffer();
+    const char *end = (const char *)memchr(data, terminator, avail);
+    size_t n = end ? end - data : avail;
+    memcpy(buffer + index, data, n);
+    index += n;
+    peekConsume(end ? n + 1 : n);
+    if (end) {
+      return index;
+    }
+  }
   while (index < length) {
     int c = timedRead();
     if (c < 0 || (char)c == terminator) {
@@ -228,6 +252,24 @@ size_t Stream::readBytesUntil(char terminator, char *buffer, size_t length) {
 
 String Stream::readString() {
   String ret;
+  if (hasPeekBufferAPI()) {
+    while (1) {
+      size_t avail = peekAvailable();
+      if (!avail) {
+        int c = timedRead();
+        if (c < 0) {
+          break;
+        }
+        ret += (char)c;
+        continue;
+      }
+      if (!ret.concat(peekBuffer(), avail)) {
+        break;
+      }
+      peekConsume(avail);
+    }
+    return ret;
+  }
   int c = timedRead();
   while (c >= 0) {
     ret += (char)c;
@@ -238,6 +280,30 @@ String Stream::readString() {
 
 String Stream::readStringUntil(char terminator) {
   String ret;
+  if (hasPeekBufferAPI()) {
+    while (1) {
+      size_t avail = peekAvailable();
+      if (!avail) {
+        int c = timedRead();
+        if (c < 0 || (char)c == terminator) {
+          break;
+        }
+        ret += (char)c;
+        continue;
+      }
+      const char *data = peekBuffer();
+      const char *end = (const char *)memchr(data, terminator, avail);
+      size_t n = end ? end - data : avail;
+      if (!ret.concat(data, n)) {
+        break;
+      }
+      peekConsume(end ? n + 1 : n);
+      if (end) {
+        break;
+      }
+    }
+    return ret;
+  }
   int c = timedRead();
   while (c >= 0 && (char)c != terminator) {
     ret += (char)c;
@@ -123,6 +123,25 @@ public:
   virtual String readString();
   String readStringUntil(char terminator);
 
+  // Peek buffer API: direct access to the received data of streams that buffer it contiguously.
+  // readString(), readStringUntil() and readBytesUntil() copy whole chunks through it instead of
+  // reading one character at a time.
+  virtual bool hasPeekBufferAPI() const {
+    return false;
+  }
+  // returns the number of bytes at peekBuffer(), may be less than available()
+  virtual size_t peekAvailable() {
+    return 0;
+  }
+  // returns a pointer to the next peekAvailable() bytes, valid until the next call changing the stream
+  virtual const char *peekBuffer() {
+    return nullptr;
+  }
+  // drops up to consume bytes from the start of peekBuffer()
+  virtual void peekConsume(size_t consume) {
+    (void)consume;
+  }
+
 protected:
   long parseInt(char ignore) {
     return parseInt(SKIP_ALL, ignore);
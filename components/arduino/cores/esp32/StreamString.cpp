@@ -62,3 +62,7 @@ int StreamString::peek() {
 }
 
 void StreamString::flush() {}
+
+void StreamString::peekConsume(size_t consume) {
+  remove(0, consume);
+}
@@ -33,6 +33,17 @@ public:
   int read() override;
   int peek() override;
   void flush() override;
+
+  bool hasPeekBufferAPI() const override {
+    return true;
+  }
+  size_t peekAvailable() override {
+    return length();
+  }
+  const char *peekBuffer() override {
+    return c_str();
+  }
+  void peekConsume(size_t consume) override;
 };
 
 #endif /* STREAMSTRING_H_ */
@@ -0,0 +1,102 @@
+/*
+ StringArena.cpp - Bump allocator for strings released all at once
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "StringArena.h"
+
+StringArena::StringArena(size_t chunkSize) : _chunkSize(chunkSize) {}
+
+StringArena::~StringArena() {
+  reset();
+  free(_chunks);
+}
+
+StringArena::Chunk *StringArena::newChunk(size_t size, Chunk *next) {
+  Chunk *chunk = (Chunk *)malloc(sizeof(Chunk) + size);
+  if (chunk != NULL) {
+    chunk->next = next;
+  }
+  return chunk;
+}
+
+void *StringArena::allocate(size_t size, size_t align) {
+  size_t pos = (_pos + align - 1) & ~(align - 1);
+  if (_chunks == NULL || pos + size > _chunkSize) {
+    // more than a quarter chunk would waste too much of the current one
+    if (size > _chunkSize / 4) {
+      Chunk *chunk = newChunk(size, _large);
+      if (chunk == NULL) {
+        return NULL;
+      }
+      _large = chunk;
+      _used += size;
+      return chunk + 1;
+    }
+    Chunk *chunk = newChunk(_chunkSize, _chunks);
+    if (chunk == NULL) {
+      return NULL;
+    }
+    _chunks = chunk;
+    pos = 0;
+  }
+  _pos = pos + size;
+  _used += size;
+  return (uint8_t *)(_chunks + 1) + pos;
+}
+
+void *StringArena::alloc(size_t size) {
+  return allocate(size, alignof(max_align_t));
+}
+
+char *StringArena::allocChars(size_t len) {
+  char *str = (char *)allocate(len + 1, 1);
+  if (str != NULL) {
+    str[len] = 0;
+  }
+  return str;
+}
+
+StringView StringArena::copy(StringView str) {
+  char *dst = allocChars(str.length());
+  if (dst == NULL) {
+    return StringView();
+  }
+  memcpy(dst, str.data(), str.length());
+  return StringView(dst, str.length());
+}
+
+void StringArena::reset() {
+  while (_large != NULL) {
+    Chunk *next = _large->next;
+    free(_large);
+    _large = next;
+  }
+  // keep the current chunk for the next round
+  if (_chunks != NULL) {
+    Chunk *chunk = _chunks->next;
+    while (chunk != NULL) {
+      Chunk *next = chunk->next;
+      free(chunk);
+      chunk = next;
+    }
+    _chunks->next = NULL;
+  }
+  _pos = 0;
+  _used = 0;
+}
@@ -0,0 +1,82 @@
+/*
+ StringArena.h - Bump allocator for strings released all at once
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+
+#include <new>
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+#include "StringView.h"
+
+// Memory for many short lived strings, e.g. everything parsed from one request.
+//
+// Allocations are carved out of chunks of chunkSize bytes and are never freed
+// one by one, reset() releases all of them. One chunk is kept across reset(),
+// so a steady load runs without touching the heap. Larger allocations get a
+// chunk of their own. Not thread safe.
+class StringArena {
+public:
+  explicit StringArena(size_t chunkSize = 256);
+  ~StringArena();
+  StringArena(const StringArena &) = delete;
+  StringArena &operator=(const StringArena &) = delete;
+
+  // size bytes aligned like malloc(), NULL if out of memory
+  void *alloc(size_t size);
+
+  // count value initialized T, NULL if out of memory
+  template<typename T> T *allocArray(size_t count) {
+    static_assert(std::is_trivially_destructible<T>::value, "arena memory is released without running destructors");
+    T *items = (T *)alloc(sizeof(T) * count);
+    if (items != NULL) {
+      for (size_t i = 0; i < count; i++) {
+        new (&items[i]) T();
+      }
+    }
+    return items;
+  }
+
+  // room for len characters and a NUL, NULL if out of memory
+  char *allocChars(size_t len);
+
+  // NUL terminated copy of str, an empty view if out of memory
+  StringView copy(StringView str);
+
+  // releases everything allocated so far
+  void reset();
+
+  // bytes handed out since the last reset()
+  size_t used() const {
+    return _used;
+  }
+
+private:
+  struct alignas(max_align_t) Chunk {
+    Chunk *next;
+  };
+
+  void *allocate(size_t size, size_t align);
+  static Chunk *newChunk(size_t size, Chunk *next);
+
+  size_t _chunkSize;
+  Chunk *_chunks = NULL;  // current chunk first
+  Chunk *_large = NULL;   // allocations that did not fit a chunk
+  size_t _pos = 0;        // next free byte in the current chunk
+  size_t _used = 0;
+};
@@ -0,0 +1,248 @@
+/*
+ StringView.h - Non-owning string views and fixed capacity strings
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+
+#include <ctype.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include "WString.h"
+#include "Print.h"
+#include "Printable.h"
+
+// Characters owned by someone else: a String, a literal, a FixedString or a
+// StringArena. The view is only valid as long as the owner keeps them, and
+// it is not NUL terminated in general, so there is no c_str().
+class StringView {
+public:
+  StringView() : _data(""), _len(0) {}
+  StringView(const char *cstr) : _data(cstr ? cstr : ""), _len(cstr ? strlen(cstr) : 0) {}
+  StringView(const char *data, size_t len) : _data(data), _len(len) {}
+  StringView(const __FlashStringHelper *str) : StringView(reinterpret_cast<const char *>(str)) {}
+  StringView(const String &str) : _data(str.c_str()), _len(str.length()) {}
+
+  const char *data() const {
+    return _data;
+  }
+  size_t length() const {
+    return _len;
+  }
+  bool isEmpty() const {
+    return _len == 0;
+  }
+  char operator[](size_t index) const {
+    return _data[index];
+  }
+  // 0 past the end, like String::charAt()
+  char charAt(size_t index) const {
+    return index < _len ? _data[index] : 0;
+  }
+
+  bool equals(StringView other) const {
+    return _len == other._len && memcmp(_data, other._data, _len) == 0;
+  }
+  bool equalsIgnoreCase(StringView other) const {
+    return _len == other._len && strncasecmp(_data, other._data, _len) == 0;
+  }
+  bool startsWith(StringView prefix) const {
+    return prefix._len <= _len && memcmp(_data, prefix._data, prefix._len) == 0;
+  }
+  bool endsWith(StringView suffix) const {
+    return suffix._len <= _len && memcmp(_data + _len - suffix._len, suffix._data, suffix._len) == 0;
+  }
+
+  // position of the first c at or after from, -1 if there is none
+  int indexOf(char c, size_t from = 0) const {
+    if (from >= _len) {
+      return -1;
+    }
+    const char *found = (const char *)memchr(_data + from, c, _len - from);
+    return found ? found - _data : -1;
+  }
+
+  // characters from..to, both are clamped to the length
+  StringView substring(size_t from, size_t to = (size_t)-1) const {
+    if (to > _len) {
+      to = _len;
+    }
+    if (from > to) {
+      from = to;
+    }
+    return StringView(_data + from, to - from);
+  }
+
+  // without leading and trailing whitespace
+  StringView trim() const {
+    size_t from = 0;
+    size_t to = _len;
+    while (from < to && isspace((unsigned char)_data[from])) {
+      from++;
+    }
+    while (to > from && isspace((unsigned char)_data[to - 1])) {
+      to--;
+    }
+    return StringView(_data + from, to - from);
+  }
+
+  // decimal number at the start, after optional whitespace, 0 if there is none
+  long toInt() const {
+    size_t i = 0;
+    while (i < _len && isspace((unsigned char)_data[i])) {
+      i++;
+    }
+    bool negative = i < _len && _data[i] == '-';
+    if (i < _len && (_data[i] == '-' || _data[i] == '+')) {
+      i++;
+    }
+    long value = 0;
+    while (i < _len && _data[i] >= '0' && _data[i] <= '9') {
+      value = value * 10 + (_data[i++] - '0');
+    }
+    return negative ? -value : value;
+  }
+
+  String toString() const {
+    return String(_data, _len);
+  }
+
+private:
+  const char *_data;
+  size_t _len;
+};
+
+inline bool operator==(StringView a, StringView b) {
+  return a.equals(b);
+}
+inline bool operator!=(StringView a, StringView b) {
+  return !a.equals(b);
+}
+
+// String of at most N characters in place, for short texts that should not
+// go to the heap. Printing to it appends, text beyond N is cut off and sets
+// the write error. Always NUL terminated.
+template<size_t N> class FixedString : public Print, public Printable {
+public:
+  FixedString() {
+    _buf[0] = 0;
+  }
+  FixedString(StringView str) : FixedString() {
+    append(str);
+  }
+  FixedString(const char *cstr) : FixedString(StringView(cstr)) {}
+  FixedString(const String &str) : FixedString(StringView(str)) {}
+
+  FixedString &operator=(StringView str) {
+    clear();
+    append(str);
+    return *this;
+  }
+  FixedString &operator=(const char *cstr) {
+    return *this = StringView(cstr);
+  }
+  FixedString &operator=(const String &str) {
+    return *this = StringView(str);
+  }
+  FixedString &operator+=(StringView str) {
+    append(str);
+    return *this;
+  }
+  FixedString &operator+=(const char *cstr) {
+    append(StringView(cstr));
+    return *this;
+  }
+  FixedString &operator+=(const String &str) {
+    append(StringView(str));
+    return *this;
+  }
+  FixedString &operator+=(char c) {
+    write((uint8_t)c);
+    return *this;
+  }
+
+  // false if str did not fit completely
+  bool append(StringView str) {
+    return write(str.data(), str.length()) == str.length();
+  }
+
+  size_t write(uint8_t c) override {
+    if (_len >= N) {
+      setWriteError();
+      return 0;
+    }
+    _buf[_len++] = c;
+    _buf[_len] = 0;
+    return 1;
+  }
+  size_t write(const uint8_t *buffer, size_t size) override {
+    size_t n = size < N - _len ? size : N - _len;
+    memcpy(_buf + _len, buffer, n);
+    _len += n;
+    _buf[_len] = 0;
+    if (n < size) {
+      setWriteError();
+    }
+    return n;
+  }
+  using Print::write;
+
+  int availableForWrite() override {
+    return N - _len;
+  }
+
+  void clear() {
+    _len = 0;
+    _buf[0] = 0;
+    clearWriteError();
+  }
+
+  const char *c_str() const {
+    return _buf;
+  }
+  size_t length() const {
+    return _len;
+  }
+  static constexpr size_t capacity() {
+    return N;
+  }
+  bool isEmpty() const {
+    return _len == 0;
+  }
+  char operator[](size_t index) const {
+    return _buf[index];
+  }
+
+  StringView view() const {
+    return StringView(_buf, _len);
+  }
+  operator StringView() const {
+    return view();
+  }
+  String toString() const {
+    return String(_buf, _len);
+  }
+
+  size_t printTo(Print &p) const override {
+    return p.write(_buf, _len);
+  }
+
+private:
+  char _buf[N + 1];
+  size_t _len = 0;
+};
@@ -23,11 +23,13 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <string.h>
-#include "sdkconfig.h"
-#include "freertos/FreeRTOS.h"
-#include "freertos/ringbuf.h"
-#include "freertos/semphr.h"
+#include "spsc_ring.h"
 
+// Circular byte buffer on top of SpscRing.
+//
+// One task (or ISR) may write while another one reads without locking, see
+// spsc_ring.h. resize(), resizeAdd() and the destructor need both sides idle.
+// The size is rounded up to a power of two.
 class cbuf {
 public:
   cbuf(size_t size);
@@ -53,13 +55,16 @@ public:
   void flush();
   size_t remove(size_t size);
 
+  // zero-copy access, see SpscRing
+  size_t readSpan(const char **data) const;
+  void consume(size_t size);
+  size_t writeSpan(char **data);
+  void commit(size_t size);
+
   cbuf *next;
-  bool has_peek;
-  uint8_t peek_byte;
+  bool has_peek;      // unused, peek() no longer takes the byte out of the buffer
+  uint8_t peek_byte;  // unused
 
 protected:
-  RingbufHandle_t _buf = NULL;
-#if !CONFIG_DISABLE_HAL_LOCKS
-  SemaphoreHandle_t _lock = NULL;
-#endif
+  SpscRing _ring;
 };
@@ -34,11 +34,17 @@
 
 #include "esp_system.h"
 #include "esp_intr_alloc.h"
+#include "esp_heap_caps.h"
+#include "esp_memory_utils.h"
 
 #if CONFIG_IDF_TARGET_ESP32  // ESP32/PICO-D4
 #include "soc/dport_reg.h"
 #include "esp32/rom/ets_sys.h"
 #include "esp32/rom/gpio.h"
+#include "esp32/rom/lldesc.h"
+#include "driver/spi_common.h"
+#include "esp_private/spi_common_internal.h"
+#include "esp_private/cache_utils.h"
 #elif CONFIG_IDF_TARGET_ESP32S2
 #include "soc/dport_reg.h"
 #include "esp32s2/rom/ets_sys.h"
@@ -609,6 +615,7 @@ void spiStopBus(spi_t *spi) {
     return;
   }
 
+  spiDmaEnd(spi);
   removeApbChangeCallback(spi, _on_apb_change);
 
   SPI_MUTEX_LOCK();
@@ -1161,13 +1168,33 @@ void spiEndTransaction(spi_t *spi) {
   if (!spi) {
     return;
   }
+  spiDmaWait(spi);
   SPI_MUTEX_UNLOCK();
 }
 
+static void spiDmaWaitISR(spi_t *spi);
+
+// Queued DMA writes use the same data registers, FIFO transfers start once they are done
+#define SPI_WAIT_DMA(spi) \
+  do {                    \
+    if (spiDmaBusy(spi)) { \
+      spiDmaWait(spi);    \
+    }                     \
+  } while (0)
+
+// Same for the ARDUINO_ISR_ATTR transfers, they must not block or leave IRAM
+#define SPI_WAIT_DMA_ISR(spi) \
+  do {                        \
+    if (spiDmaBusy(spi)) {    \
+      spiDmaWaitISR(spi);     \
+    }                         \
+  } while (0)
+
 void ARDUINO_ISR_ATTR spiWriteByteNL(spi_t *spi, uint8_t data) {
   if (!spi) {
     return;
   }
+  SPI_WAIT_DMA_ISR(spi);
   spi->dev->mosi_dlen.usr_mosi_dbitlen = 7;
 #if CONFIG_IDF_TARGET_ESP32S2 || CONFIG_IDF_TARGET_ESP32
   spi->dev->miso_dlen.usr_miso_dbitlen = 0;
@@ -1189,6 +1216,7 @@ uint8_t spiTransferByteNL(spi_t *spi, uint8_t data) {
   if (!spi) {
     return 0;
   }
+  SPI_WAIT_DMA(spi);
   spi->dev->mosi_dlen.usr_mosi_dbitlen = 7;
   spi->dev->miso_dlen.usr_miso_dbitlen = 7;
 #if CONFIG_IDF_TARGET_ESP32C6 || CONFIG_IDF_TARGET_ESP32H2 || CONFIG_IDF_TARGET_ESP32P4 || CONFIG_IDF_TARGET_ESP32C5
@@ -1214,6 +1242,7 @@ void ARDUINO_ISR_ATTR spiWriteShortNL(spi_t *spi, uint16_t data) {
   if (!spi) {
     return;
   }
+  SPI_WAIT_DMA_ISR(spi);
   if (!spi->dev->ctrl.wr_bit_order) {
     MSB_16_SET(data, data);
   }
@@ -1238,6 +1267,7 @@ uint16_t spiTransferShortNL(spi_t *spi, uint16_t data) {
   if (!spi) {
     return 0;
   }
+  SPI_WAIT_DMA(spi);
   if (!spi->dev->ctrl.wr_bit_order) {
     MSB_16_SET(data, data);
   }
@@ -1269,6 +1299,7 @@ void ARDUINO_ISR_ATTR spiWriteLongNL(spi_t *spi, uint32_t data) {
   if (!spi) {
     return;
   }
+  SPI_WAIT_DMA_ISR(spi);
   if (!spi->dev->ctrl.wr_bit_order) {
     MSB_32_SET(data, data);
   }
@@ -1293,6 +1324,7 @@ uint32_t spiTransferLongNL(spi_t *spi, uint32_t data) {
   if (!spi) {
     return 0;
   }
+  SPI_WAIT_DMA(spi);
   if (!spi->dev->ctrl.wr_bit_order) {
     MSB_32_SET(data, data);
   }
@@ -1324,6 +1356,7 @@ void spiWriteNL(spi_t *spi, const void *data_in, uint32_t len) {
   if (!spi) {
     return;
   }
+  SPI_WAIT_DMA(spi);
   size_t longs = len >> 2;
   if (len & 3) {
     longs++;
@@ -1363,6 +1396,7 @@ void spiTransferBytesNL(spi_t *spi, const void *data_in, uint8_t *data_out, uint
   if (!spi) {
     return;
   }
+  SPI_WAIT_DMA(spi);
   size_t longs = len >> 2;
   if (len & 3) {
     longs++;
@@ -1444,6 +1478,7 @@ void spiTransferBitsNL(spi_t *spi, uint32_t data, uint32_t *out, uint8_t bits) {
   if (!spi) {
     return;
   }
+  SPI_WAIT_DMA(spi);
 
   if (bits > 32) {
     bits = 32;
@@ -1494,6 +1529,7 @@ void spiTransferBitsNL(spi_t *spi, uint32_t data, uint32_t *out, uint8_t bits) {
 }
 
 void ARDUINO_ISR_ATTR spiWritePixelsNL(spi_t *spi, const void *data_in, uint32_t len) {
+  SPI_WAIT_DMA_ISR(spi);
   size_t longs = len >> 2;
   if (len & 3) {
     longs++;
@@ -1555,6 +1591,293 @@ void ARDUINO_ISR_ATTR spiWritePixelsNL(spi_t *spi, const void *data_in, uint32_t
   }
 }
 
+/*
+ * Queued DMA writes
+ *
+ * Each job is sent in chunks of up to SPI_DMA_DESC_COUNT descriptors. The
+ * transaction done interrupt of the bus starts the next chunk or job, so
+ * the CPU is free while the data is shifted out.
+ * */
+
+#if CONFIG_IDF_TARGET_ESP32
+
+#define SPI_DMA_DESC_MAX_LEN 4092  // largest word aligned length of one descriptor
+#define SPI_DMA_DESC_COUNT   8
+
+typedef struct {
+  const uint8_t *data;
+  uint32_t len;
+  uint16_t block;  // if not 0 every descriptor sends the same block of data
+  spi_dma_cb_t cb;
+  void *arg;
+} spi_dma_job_t;
+
+typedef struct {
+  lldesc_t *desc;
+  intr_handle_t intr;
+  SemaphoreHandle_t slots;  // free queue entries
+  SemaphoreHandle_t idle;   // given when the queue runs empty
+  portMUX_TYPE mux;
+  spi_dma_job_t jobs[SPI_DMA_QUEUE_LEN];
+  uint8_t head;
+  volatile uint8_t count;
+  uint32_t user;  // user register of the bus before the queue started
+} spi_dma_t;
+
+static spi_dma_t *_spi_dma[SPI_COUNT];
+
+// Called with dma->mux held and the head job not empty
+static void ARDUINO_ISR_ATTR spiDmaStartChunk(spi_t *spi, spi_dma_t *dma) {
+  spi_dma_job_t *job = &dma->jobs[dma->head];
+  uint32_t step = job->block ? job->block : SPI_DMA_DESC_MAX_LEN;
+  uint32_t chunk = (job->len > SPI_DMA_DESC_COUNT * step) ? SPI_DMA_DESC_COUNT * step : job->len;
+  uint32_t left = chunk;
+  lldesc_t *d = dma->desc;
+
+  while (left) {
+    uint32_t n = (left > step) ? step : left;
+    d->size = (n + 3) & ~3;
+    d->length = n;
+    d->offset = 0;
+    d->sosf = 0;
+    d->owner = 1;
+    d->buf = (uint8_t *)job->data + (job->block ? 0 : chunk - left);
+    left -= n;
+    d->eof = (left == 0);
+    d->qe.stqe_next = left ? d + 1 : NULL;
+    d++;
+  }
+  if (!job->block) {
+    job->data += chunk;
+  }
+  job->len -= chunk;
+
+  spi->dev->dma_conf.val |= SPI_OUT_RST | SPI_AHBM_RST | SPI_AHBM_FIFO_RST;
+  spi->dev->dma_conf.val &= ~(SPI_OUT_RST | SPI_AHBM_RST | SPI_AHBM_FIFO_RST);
+  spi->dev->dma_conf.outdscr_burst_en = 1;
+  spi->dev->dma_conf.out_data_burst_en = 1;
+  spi->dev->mosi_dlen.usr_mosi_dbitlen = (chunk * 8) - 1;
+  spi->dev->miso_dlen.usr_miso_dbitlen = 0;
+  spi->dev->dma_out_link.addr = (uint32_t)dma->desc & 0xFFFFF;
+  spi->dev->dma_out_link.start = 1;
+  spi->dev->cmd.usr = 1;
+}
+
+// Moves the queue on once the bus is done, from the interrupt or from spiDmaWaitISR()
+static void ARDUINO_ISR_ATTR spiDmaService(spi_t *spi, spi_dma_t *dma, BaseType_t *woken) {
+  portENTER_CRITICAL_ISR(&dma->mux);
+  if (!dma->count || !spi->dev->slave.trans_done) {
+    portEXIT_CRITICAL_ISR(&dma->mux);
+    return;
+  }
+  spi->dev->slave.trans_done = 0;
+  spi_dma_job_t *job = &dma->jobs[dma->head];
+  if (job->len) {
+    spiDmaStartChunk(spi, dma);
+    portEXIT_CRITICAL_ISR(&dma->mux);
+    return;
+  }
+  spi_dma_cb_t cb = job->cb;
+  void *cb_arg = job->arg;
+  dma->head = (dma->head + 1) % SPI_DMA_QUEUE_LEN;
+  bool drained = (--dma->count == 0);
+  if (drained) {
+    spi->dev->slave.trans_inten = 0;
+    spi->dev->user.val = dma->user;
+  } else {
+    spiDmaStartChunk(spi, dma);
+  }
+  portEXIT_CRITICAL_ISR(&dma->mux);
+
+  if (cb) {
+    cb(cb_arg);
+  }
+  xSemaphoreGiveFromISR(dma->slots, woken);
+  if (drained) {
+    xSemaphoreGiveFromISR(dma->idle, woken);
+  }
+}
+
+static void ARDUINO_ISR_ATTR spiDmaIsr(void *arg) {
+  spi_t *spi = (spi_t *)arg;
+  BaseType_t woken = pdFALSE;
+
+  spiDmaService(spi, _spi_dma[spi->num], &woken);
+  if (woken) {
+    portYIELD_FROM_ISR();
+  }
+}
+
+bool spiDmaBegin(spi_t *spi, uint8_t dma_chan) {
+  if (!spi) {
+    return false;
+  }
+  if (spi->num != HSPI && spi->num != VSPI) {
+    log_e("DMA is only supported on HSPI and VSPI");
+    return false;
+  }
+  if (dma_chan > 2) {
+    log_e("Invalid DMA channel %u", dma_chan);
+    return false;
+  }
+  if (_spi_dma[spi->num]) {
+    return true;
+  }
+
+  // claimed from the SPI driver, so spi_master buses (SD card) and the other bus do not get it too
+  spi_host_device_t host = (spi_host_device_t)(spi->num - 1);
+  uint32_t tx_chan, rx_chan;
+  if (spicommon_dma_chan_alloc(host, dma_chan ? (spi_dma_chan_t)dma_chan : SPI_DMA_CH_AUTO, &tx_chan, &rx_chan) != ESP_OK) {
+    log_e("DMA channel %u is in use", dma_chan);
+    return false;
+  }
+
+  spi_dma_t *dma = (spi_dma_t *)heap_caps_calloc(1, sizeof(spi_dma_t), MALLOC_CAP_INTERNAL);
+  if (!dma) {
+    spicommon_dma_chan_free(host);
+    return false;
+  }
+  dma->desc = (lldesc_t *)heap_caps_calloc(SPI_DMA_DESC_COUNT, sizeof(lldesc_t), MALLOC_CAP_DMA);
+  dma->slots = xSemaphoreCreateCounting(SPI_DMA_QUEUE_LEN, SPI_DMA_QUEUE_LEN);
+  dma->idle = xSemaphoreCreateBinary();
+  portMUX_INITIALIZE(&dma->mux);
+  if (!dma->desc || !dma->slots || !dma->idle) {
+    goto err;
+  }
+
+  SPI_MUTEX_LOCK();
+  spi->dev->slave.trans_inten = 0;
+  spi->dev->slave.trans_done = 0;
+  SPI_MUTEX_UNLOCK();
+  if (esp_intr_alloc((spi->num == HSPI) ? ETS_SPI2_INTR_SOURCE : ETS_SPI3_INTR_SOURCE, 0, spiDmaIsr, spi, &dma->intr) != ESP_OK) {
+    log_e("SPI DMA interrupt allocation failed");
+    goto err;
+  }
+
+  _spi_dma[spi->num] = dma;
+  return true;
+
+err:
+  if (dma->slots) {
+    vSemaphoreDelete(dma->slots);
+  }
+  if (dma->idle) {
+    vSemaphoreDelete(dma->idle);
+  }
+  heap_caps_free(dma->desc);
+  heap_caps_free(dma);
+  spicommon_dma_chan_free(host);
+  return false;
+}
+
+void spiDmaEnd(spi_t *spi) {
+  spi_dma_t *dma = spi ? _spi_dma[spi->num] : NULL;
+  if (!dma) {
+    return;
+  }
+  spiDmaWait(spi);
+  _spi_dma[spi->num] = NULL;
+  esp_intr_free(dma->intr);
+  spicommon_dma_chan_free((spi_host_device_t)(spi->num - 1));
+  vSemaphoreDelete(dma->slots);
+  vSemaphoreDelete(dma->idle);
+  heap_caps_free(dma->desc);
+  heap_caps_free(dma);
+}
+
+static bool spiDmaQueue(spi_t *spi, const void *data, uint32_t len, uint16_t block, spi_dma_cb_t cb, void *arg) {
+  spi_dma_t *dma = spi ? _spi_dma[spi->num] : NULL;
+  if (!dma || !len || !esp_ptr_dma_capable(data) || ((uintptr_t)data & 3)) {
+    return false;
+  }
+
+  xSemaphoreTake(dma->slots, portMAX_DELAY);
+  portENTER_CRITICAL(&dma->mux);
+  spi_dma_job_t *job = &dma->jobs[(dma->head + dma->count) % SPI_DMA_QUEUE_LEN];
+  job->data = (const uint8_t *)data;
+  job->len = len;
+  job->block = block;
+  job->cb = cb;
+  job->arg = arg;
+  if (dma->count++ == 0) {
+    dma->user = spi->dev->user.val;
+    spi->dev->user.usr_miso = 0;
+    spi->dev->slave.trans_done = 0;
+    spi->dev->slave.trans_inten = 1;
+    spiDmaStartChunk(spi, dma);
+  }
+  portEXIT_CRITICAL(&dma->mux);
+  return true;
+}
+
+bool spiWriteDmaNL(spi_t *spi, const void *data, uint32_t len, spi_dma_cb_t cb, void *arg) {
+  return spiDmaQueue(spi, data, len, 0, cb, arg);
+}
+
+bool spiWriteRepeatDmaNL(spi_t *spi, const void *data, uint16_t data_len, uint32_t len, spi_dma_cb_t cb, void *arg) {
+  if (!data_len || data_len > SPI_DMA_DESC_MAX_LEN) {
+    return false;
+  }
+  return spiDmaQueue(spi, data, len, data_len, cb, arg);
+}
+
+void spiDmaWait(spi_t *spi) {
+  spi_dma_t *dma = spi ? _spi_dma[spi->num] : NULL;
+  if (!dma) {
+    return;
+  }
+  // A stale give from an earlier drain only costs one more loop
+  while (dma->count) {
+    xSemaphoreTake(dma->idle, portMAX_DELAY);
+  }
+}
+
+bool ARDUINO_ISR_ATTR spiDmaBusy(spi_t *spi) {
+  spi_dma_t *dma = spi ? _spi_dma[spi->num] : NULL;
+  return dma && dma->count;
+}
+
+// In interrupt context, or with the flash cache disabled and so the DMA interrupt
+// masked, the queue is run here by polling. Tasks sleep in spiDmaWait().
+static void ARDUINO_ISR_ATTR spiDmaWaitISR(spi_t *spi) {
+  spi_dma_t *dma = _spi_dma[spi->num];
+  BaseType_t woken = pdFALSE;
+
+  if (!xPortInIsrContext() && spi_flash_cache_enabled()) {
+    spiDmaWait(spi);
+    return;
+  }
+  while (dma && dma->count) {
+    spiDmaService(spi, dma, &woken);
+  }
+}
+
+#else
+
+bool spiDmaBegin(spi_t *spi, uint8_t dma_chan) {
+  return false;
+}
+
+void spiDmaEnd(spi_t *spi) {}
+
+bool spiWriteDmaNL(spi_t *spi, const void *data, uint32_t len, spi_dma_cb_t cb, void *arg) {
+  return false;
+}
+
+bool spiWriteRepeatDmaNL(spi_t *spi, const void *data, uint16_t data_len, uint32_t len, spi_dma_cb_t cb, void *arg) {
+  return false;
+}
+
+void spiDmaWait(spi_t *spi) {}
+
+bool ARDUINO_ISR_ATTR spiDmaBusy(spi_t *spi) {
+  return false;
+}
+
+static void spiDmaWaitISR(spi_t *spi) {}
+
+#endif
+
 /*
  * Clock Calculators
  *
@@ -130,6 +130,32 @@ void spiWriteShortNL(spi_t *spi, uint16_t data);
 void spiWriteLongNL(spi_t *spi, uint32_t data);
 void spiWritePixelsNL(spi_t *spi, const void *data_in, uint32_t len);
 
+/*
+ * Queued DMA writes (ESP32 HSPI and VSPI only, other targets return false)
+ *
+ * spiWriteDmaNL() must be called inside a transaction. The data is sent as
+ * stored and must stay untouched until its callback ran or spiDmaWait()
+ * returned. The callback runs in interrupt context. spiEndTransaction()
+ * and the FIFO transfers above wait for all queued writes. The
+ * ARDUINO_ISR_ATTR writes poll the queue instead of sleeping when called
+ * from an interrupt or with the flash cache disabled, callbacks then run
+ * in the caller and have to be in IRAM as well.
+ *
+ * spiDmaBegin() claims dma_chan (1 or 2, 0 for any free one) from the IDF
+ * SPI driver and fails if a spi_master bus or the other bus has it.
+ * */
+#define SPI_DMA_QUEUE_LEN 4
+
+typedef void (*spi_dma_cb_t)(void *arg);
+
+bool spiDmaBegin(spi_t *spi, uint8_t dma_chan);
+void spiDmaEnd(spi_t *spi);
+bool spiWriteDmaNL(spi_t *spi, const void *data, uint32_t len, spi_dma_cb_t cb, void *arg);
+// Sends len bytes by reading the first data_len bytes of data over and over
+bool spiWriteRepeatDmaNL(spi_t *spi, const void *data, uint16_t data_len, uint32_t len, spi_dma_cb_t cb, void *arg);
+void spiDmaWait(spi_t *spi);
+bool spiDmaBusy(spi_t *spi);
+
 #define spiTransferNL(spi, data, len) spiTransferBytesNL(spi, data, data, len)
 uint8_t spiTransferByteNL(spi_t *spi, uint8_t data);
 uint16_t spiTransferShortNL(spi_t *spi, uint16_t data);
@@ -0,0 +1,184 @@
+/*
+ spsc_ring.h - Lock-free single producer, single consumer byte ring
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Byte ring for exactly one producer and one consumer, without locks.
+//
+// The capacity is a power of two. Head and tail count bytes without wrapping
+// to the capacity, so all of it is usable and the fill level is head - tail.
+// The producer may call room(), writeSpan(), commit() and write(), the consumer
+// available(), readSpan(), consume(), peek() and read(), each from its own task
+// or ISR. begin(), reset() and swap() need both sides to be idle.
+//
+// writeSpan() and readSpan() give direct access to the contiguous part of the
+// free or filled space, commit() and consume() publish what was written or read.
+class SpscRing {
+public:
+  SpscRing() {}
+  explicit SpscRing(size_t capacity) {
+    begin(capacity);
+  }
+  ~SpscRing() {
+    free(_buf);
+  }
+  SpscRing(const SpscRing &) = delete;
+  SpscRing &operator=(const SpscRing &) = delete;
+
+  // allocates the buffer, capacity is rounded up to the next power of two
+  // previous contents are dropped, returns false if out of memory
+  bool begin(size_t capacity) {
+    size_t cap = 1;
+    while (cap < capacity) {
+      cap <<= 1;
+    }
+    uint8_t *buf = (uint8_t *)malloc(cap);
+    if (buf == NULL) {
+      return false;
+    }
+    free(_buf);
+    _buf = buf;
+    _mask = cap - 1;
+    reset();
+    return true;
+  }
+
+  // drops the contents
+  void reset() {
+    _head.store(0, std::memory_order_relaxed);
+    _tail.store(0, std::memory_order_relaxed);
+  }
+
+  // exchanges buffers and contents with another ring
+  void swap(SpscRing &other) {
+    uint8_t *buf = _buf;
+    size_t mask = _mask;
+    size_t head = _head.load(std::memory_order_relaxed);
+    size_t tail = _tail.load(std::memory_order_relaxed);
+    _buf = other._buf;
+    _mask = other._mask;
+    _head.store(other._head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    _tail.store(other._tail.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    other._buf = buf;
+    other._mask = mask;
+    other._head.store(head, std::memory_order_relaxed);
+    other._tail.store(tail, std::memory_order_relaxed);
+  }
+
+  size_t capacity() const {
+    return _buf ? _mask + 1 : 0;
+  }
+
+  // bytes ready to read
+  size_t available() const {
+    return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+  }
+
+  // bytes free to write
+  size_t room() const {
+    return capacity() - available();
+  }
+
+  // contiguous readable bytes at *data, may be less than available() at the wrap
+  size_t readSpan(const uint8_t **data) const {
+    size_t tail = _tail.load(std::memory_order_relaxed);
+    size_t filled = _head.load(std::memory_order_acquire) - tail;
+    size_t offset = tail & _mask;
+    *data = _buf + offset;
+    return (filled < _mask + 1 - offset) ? filled : _mask + 1 - offset;
+  }
+
+  // releases size bytes from the start of readSpan(), at most available()
+  void consume(size_t size) {
+    _tail.store(_tail.load(std::memory_order_relaxed) + size, std::memory_order_release);
+  }
+
+  // contiguous writable bytes at *data, may be less than room() at the wrap
+  size_t writeSpan(uint8_t **data) {
+    size_t head = _head.load(std::memory_order_relaxed);
+    size_t free_bytes = capacity() - (head - _tail.load(std::memory_order_acquire));
+    size_t offset = head & _mask;
+    *data = _buf + offset;
+    return (free_bytes < _mask + 1 - offset) ? free_bytes : _mask + 1 - offset;
+  }
+
+  // publishes size bytes written to writeSpan(), at most room()
+  void commit(size_t size) {
+    _head.store(_head.load(std::memory_order_relaxed) + size, std::memory_order_release);
+  }
+
+  // returns the next byte without consuming it, -1 if empty
+  int peek() const {
+    const uint8_t *data;
+    return readSpan(&data) ? *data : -1;
+  }
+
+  // copies up to size bytes into dst, or drops them if dst is NULL
+  size_t read(void *dst, size_t size) {
+    uint8_t *out = (uint8_t *)dst;
+    size_t done = 0;
+    while (done < size) {
+      const uint8_t *data;
+      size_t n = readSpan(&data);
+      if (n == 0) {
+        break;
+      }
+      if (n > size - done) {
+        n = size - done;
+      }
+      if (out != NULL) {
+        memcpy(out + done, data, n);
+      }
+      done += n;
+      consume(n);
+    }
+    return done;
+  }
+
+  // copies up to size bytes from src, returns the number written
+  size_t write(const void *src, size_t size) {
+    const uint8_t *in = (const uint8_t *)src;
+    size_t done = 0;
+    while (done < size) {
+      uint8_t *data;
+      size_t n = writeSpan(&data);
+      if (n == 0) {
+        break;
+      }
+      if (n > size - done) {
+        n = size - done;
+      }
+      memcpy(data, in + done, n);
+      done += n;
+      commit(n);
+    }
+    return done;
+  }
+
+private:
+  uint8_t *_buf = NULL;
+  size_t _mask = 0;
+  std::atomic<size_t> _head{0};  // written by the producer only
+  std::atomic<size_t> _tail{0};  // written by the consumer only
+};
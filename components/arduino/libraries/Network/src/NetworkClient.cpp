@@ -148,6 +148,21 @@ public:
     return _fill - _pos + r_available();
   }
 
+  size_t peekAvailable() {
+    if (_pos == _fill && !fillBuffer()) {
+      return 0;
+    }
+    return _fill - _pos;
+  }
+
+  const char *peekBuffer() {
+    return (const char *)_buffer + _pos;
+  }
+
+  void peekConsume(size_t len) {
+    _pos += (len < _fill - _pos) ? len : _fill - _pos;
+  }
+
   void clear() {
     if (r_available()) {
       _pos = _fill;
@@ -531,6 +546,29 @@ int NetworkClient::peek() {
   return res;
 }
 
+size_t NetworkClient::peekAvailable() {
+  size_t res = 0;
+  if (fd() >= 0 && _rxBuffer) {
+    res = _rxBuffer->peekAvailable();
+    if (_rxBuffer->failed()) {
+      log_e("fail on fd %d, errno: %d, \"%s\"", fd(), errno, strerror(errno));
+      stop();
+      res = 0;
+    }
+  }
+  return res;
+}
+
+const char *NetworkClient::peekBuffer() {
+  return _rxBuffer ? _rxBuffer->peekBuffer() : nullptr;
+}
+
+void NetworkClient::peekConsume(size_t consume) {
+  if (_rxBuffer) {
+    _rxBuffer->peekConsume(consume);
+  }
+}
+
 int NetworkClient::available() {
   if (fd() < 0 || !_rxBuffer) {
     return 0;
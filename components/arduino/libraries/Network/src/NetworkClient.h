@@ -67,6 +67,12 @@ public:
     return readBytes((char *)buffer, length);
   }
   int peek();
+  bool hasPeekBufferAPI() const override {
+    return true;
+  }
+  size_t peekAvailable() override;
+  const char *peekBuffer() override;
+  void peekConsume(size_t consume) override;
   void clear();  // clear rx
   void stop();
   uint8_t connected();
@@ -400,6 +400,33 @@ int NetworkUDP::peek() {
   return rx_buffer->peek();
 }
 
+size_t NetworkUDP::peekAvailable() {
+  if (!rx_buffer) {
+    return 0;
+  }
+  const char *data;
+  return rx_buffer->readSpan(&data);
+}
+
+const char *NetworkUDP::peekBuffer() {
+  if (!rx_buffer) {
+    return nullptr;
+  }
+  const char *data;
+  rx_buffer->readSpan(&data);
+  return data;
+}
+
+void NetworkUDP::peekConsume(size_t consume) {
+  if (!rx_buffer) {
+    return;
+  }
+  rx_buffer->remove(consume);
+  if (!rx_buffer->available()) {
+    clear();
+  }
+}
+
 void NetworkUDP::clear() {
   if (!rx_buffer) {
     return;
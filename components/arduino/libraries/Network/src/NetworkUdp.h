@@ -72,6 +72,12 @@ public:
   int read(unsigned char *buffer, size_t len);
   int read(char *buffer, size_t len);
   int peek();
+  bool hasPeekBufferAPI() const override {
+    return true;
+  }
+  size_t peekAvailable() override;
+  const char *peekBuffer() override;
+  void peekConsume(size_t consume) override;
   void clear();  // clear rx
   IPAddress remoteIP();
   uint16_t remotePort();
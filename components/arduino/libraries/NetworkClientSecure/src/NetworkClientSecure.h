@@ -58,6 +58,9 @@ public:
   int connect(const char *host, uint16_t port, const char *pskIdent, const char *psKey);
   int connect(IPAddress ip, uint16_t port, const char *host, const char *CA_cert, const char *cert, const char *private_key);
   int peek();
+  bool hasPeekBufferAPI() const override {
+    return false;  // the socket buffer holds encrypted data
+  }
   size_t write(uint8_t data);
   size_t write(const uint8_t *buf, size_t size);
   int available();
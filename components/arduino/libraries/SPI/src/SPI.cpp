@@ -296,47 +296,90 @@ void SPIClass::transferBytes(const uint8_t *data, uint8_t *out, uint32_t size) {
 }
 
 /**
+ * Fills the pattern buffer once and sends it repeatedly, as a single
+ * repeating DMA transfer if available, else in FIFO sized writes.
  * @param data uint8_t *
  * @param size uint8_t  max for size is 64Byte
  * @param repeat uint32_t
  */
 void SPIClass::writePattern(const uint8_t *data, uint8_t size, uint32_t repeat) {
-  if (size > 64) {
+  if (size > 64 || !size) {
     return;  //max Hardware FIFO
   }
 
-  uint32_t byte = (size * repeat);
-  uint8_t r = (64 / size);
-  const uint8_t max_bytes_FIFO = r * size;  // Max number of whole patterns (in bytes) that can fit into the hardware FIFO
+  uint32_t bytes = (size * repeat);
+  uint16_t fill = (SPI_PATTERN_BUFFER_SIZE / size) * size;  // whole patterns in the buffer
+  if (fill > bytes) {
+    fill = bytes;
+  }
+  for (uint16_t i = 0; i < fill; i++) {
+    _pattern[i] = data[i % size];
+  }
 
-  while (byte) {
-    if (byte > max_bytes_FIFO) {
-      writePattern_(data, size, r);
-      byte -= max_bytes_FIFO;
+  if (bytes > 64) {
+    bool queued;
+    if (_inTransaction) {
+      queued = spiWriteRepeatDmaNL(_spi, _pattern, fill, bytes, NULL, NULL);
+      spiDmaWait(_spi);  // _pattern is reused by the next call
     } else {
-      writePattern_(data, size, (byte / size));
-      byte = 0;
+      spiSimpleTransaction(_spi);
+      queued = spiWriteRepeatDmaNL(_spi, _pattern, fill, bytes, NULL, NULL);
+      spiEndTransaction(_spi);
+    }
+    if (queued) {
+      return;
     }
   }
+
+  const uint8_t max_bytes_FIFO = (64 / size) * size;  // Max number of whole patterns (in bytes) that can fit into the hardware FIFO
+  while (bytes) {
+    uint8_t chunk = (bytes > max_bytes_FIFO) ? max_bytes_FIFO : bytes;
+    writeBytes(_pattern, chunk);
+    bytes -= chunk;
+  }
 }
 
-void SPIClass::writePattern_(const uint8_t *data, uint8_t size, uint8_t repeat) {
-  uint8_t bytes = (size * repeat);
-  uint8_t buffer[64];
-  uint8_t *bufferPtr = &buffer[0];
-  const uint8_t *dataPtr;
-  uint8_t dataSize = bytes;
-  for (uint8_t i = 0; i < repeat; i++) {
-    dataSize = size;
-    dataPtr = data;
-    while (dataSize--) {
-      *bufferPtr = *dataPtr;
-      dataPtr++;
-      bufferPtr++;
-    }
+/**
+ * @param dmaChannel uint8_t DMA channel 1 or 2, 0 for any channel no other bus or driver uses
+ * @return true if writeDMA() can queue transfers
+ */
+bool SPIClass::dmaBegin(uint8_t dmaChannel) {
+  if (!_spi) {
+    return false;
   }
+  return spiDmaBegin(_spi, dmaChannel);
+}
+
+void SPIClass::dmaEnd() {
+  spiDmaEnd(_spi);
+}
+
+/**
+ * Queues data for a DMA write. Inside a transaction the call returns once
+ * the data is queued, the buffer must stay valid until cb ran or dmaWait()
+ * returned. Outside a transaction it waits for the transfer.
+ * @param data void * sent as stored, no byte swapping
+ * @param size uint32_t
+ * @param cb spi_dma_cb_t called from interrupt context once the data is sent
+ * @param arg void * passed to cb
+ * @return false if nothing was queued, send the data with writeBytes() instead
+ */
+bool SPIClass::writeDMA(const void *data, uint32_t size, spi_dma_cb_t cb, void *arg) {
+  if (_inTransaction) {
+    return spiWriteDmaNL(_spi, data, size, cb, arg);
+  }
+  spiSimpleTransaction(_spi);
+  bool queued = spiWriteDmaNL(_spi, data, size, cb, arg);
+  spiEndTransaction(_spi);
+  return queued;
+}
+
+void SPIClass::dmaWait() {
+  spiDmaWait(_spi);
+}
 
-  writeBytes(&buffer[0], bytes);
+bool SPIClass::dmaBusy() {
+  return spiDmaBusy(_spi);
 }
 
 #if CONFIG_IDF_TARGET_ESP32
@@ -32,6 +32,11 @@
 
 #define SPI_HAS_TRANSACTION
 
+// Bytes of repeated pattern writePattern() sends per DMA descriptor
+#ifndef SPI_PATTERN_BUFFER_SIZE
+#define SPI_PATTERN_BUFFER_SIZE 256
+#endif
+
 class SPISettings {
 public:
   SPISettings() : _clock(1000000), _bitOrder(SPI_MSBFIRST), _dataMode(SPI_MODE0) {}
@@ -56,7 +61,7 @@ private:
 #if !CONFIG_DISABLE_HAL_LOCKS
   SemaphoreHandle_t paramLock = NULL;
 #endif
-  void writePattern_(const uint8_t *data, uint8_t size, uint8_t repeat);
+  uint8_t _pattern[SPI_PATTERN_BUFFER_SIZE] __attribute__((aligned(4)));  // source of writePattern()
 
 public:
   SPIClass(uint8_t spi_bus = HSPI);
@@ -90,6 +95,14 @@ public:
   void writePixels(const void *data, uint32_t size);  //ili9341 compatible
   void writePattern(const uint8_t *data, uint8_t size, uint32_t repeat);
 
+  // Queued DMA writes, see spiWriteDmaNL(). writeDMA() returns false if the
+  // data was not queued (no DMA, or buffer not DMA capable or word aligned)
+  bool dmaBegin(uint8_t dmaChannel = 0);
+  void dmaEnd();
+  bool writeDMA(const void *data, uint32_t size, spi_dma_cb_t cb = NULL, void *arg = NULL);
+  void dmaWait();
+  bool dmaBusy();
+
   spi_t *bus() {
     return _spi;
   }
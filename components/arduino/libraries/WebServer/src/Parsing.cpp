@@ -73,20 +73,28 @@ static char *readBytesWithTimeout(NetworkClient &client, size_t maxLength, size_
   return buf;
 }
 
+void WebServer::_resetRequest() {
+  // arguments and header values of the previous request go all at once
+  _requestArena.reset();
+  _currentArgs = nullptr;
+  _currentArgCount = 0;
+  _postArgs = nullptr;
+  _postArgsLen = 0;
+  // drop the headers collected from that request only, forget the values of the others
+  if (_lastHeaderKey) {
+    _lastHeaderKey->next = nullptr;
+  }
+  for (RequestField *header = _currentHeaders; header; header = header->next) {
+    header->value = StringView();
+  }
+  _headerKeysCount = _headerKeysConfigured;
+}
+
 bool WebServer::_parseRequest(NetworkClient &client) {
   // Read the first line of HTTP request
   String req = client.readStringUntil('\r');
   client.readStringUntil('\n');
-  //reset header value
-  if (_collectAllHeaders) {
-    // clear previous headers
-    collectAllHeaders();
-  } else {
-    // clear previous headers
-    for (RequestArgument *header = _currentHeaders; header; header = header->next) {
-      header->value = String();
-    }
-  }
+  _resetRequest();
 
   // First line of HTTP request looks like "GET /path HTTP/1.1"
   // Retrieve the "/path" part by finding the spaces
@@ -140,8 +148,6 @@ bool WebServer::_parseRequest(NetworkClient &client) {
   // below is needed only when POST type request
   if (method == HTTP_POST || method == HTTP_PUT || method == HTTP_PATCH || method == HTTP_DELETE) {
     String boundaryStr;
-    String headerName;
-    String headerValue;
     bool isForm = false;
     bool isEncoded = false;
     //parse headers
@@ -155,10 +161,9 @@ bool WebServer::_parseRequest(NetworkClient &client) {
       if (headerDiv == -1) {
         break;
       }
-      headerName = req.substring(0, headerDiv);
-      headerValue = req.substring(headerDiv + 1);
-      headerValue.trim();
-      _collectHeader(headerName.c_str(), headerValue.c_str());
+      StringView headerName = StringView(req).substring(0, headerDiv);
+      StringView headerValue = StringView(req).substring(headerDiv + 1).trim();
+      _collectHeader(headerName, headerValue);
 
       if (headerName.equalsIgnoreCase(FPSTR(Content_Type))) {
         using namespace mime;
@@ -168,14 +173,14 @@ bool WebServer::_parseRequest(NetworkClient &client) {
           isForm = false;
           isEncoded = true;
         } else if (headerValue.startsWith(F("multipart/"))) {
-          boundaryStr = headerValue.substring(headerValue.indexOf('=') + 1);
+          boundaryStr = headerValue.substring(headerValue.indexOf('=') + 1).toString();
           boundaryStr.replace("\"", "");
           isForm = true;
         }
       } else if (headerName.equalsIgnoreCase(F("Content-Length"))) {
         _clientContentLength = headerValue.toInt();
       } else if (headerName.equalsIgnoreCase(F("Host"))) {
-        _hostHeader = headerValue;
+        _hostHeader = headerValue.toString();
       }
     }
 
@@ -219,11 +224,11 @@ bool WebServer::_parseRequest(NetworkClient &client) {
           searchStr += plainBuf;
         }
         _parseArguments(searchStr);
-        if (!isEncoded) {
+        if (!isEncoded && _currentArgs) {
           //plain post json or other data
-          RequestArgument &arg = _currentArgs[_currentArgCount++];
+          RequestField &arg = _currentArgs[_currentArgCount++];
           arg.key = F("plain");
-          arg.value = String(plainBuf);
+          arg.value = _requestArena.copy(plainBuf);
         }
 
         log_v("Plain: %s", plainBuf);
@@ -240,8 +245,6 @@ bool WebServer::_parseRequest(NetworkClient &client) {
       }
     }
   } else {
-    String headerName;
-    String headerValue;
     //parse headers
     while (1) {
       req = client.readStringUntil('\r');
@@ -253,12 +256,12 @@ bool WebServer::_parseRequest(NetworkClient &client) {
       if (headerDiv == -1) {
         break;
       }
-      headerName = req.substring(0, headerDiv);
-      headerValue = req.substring(headerDiv + 2);
-      _collectHeader(headerName.c_str(), headerValue.c_str());
+      StringView headerName = StringView(req).substring(0, headerDiv);
+      StringView headerValue = StringView(req).substring(headerDiv + 2);
+      _collectHeader(headerName, headerValue);
 
       if (headerName.equalsIgnoreCase("Host")) {
-        _hostHeader = headerValue;
+        _hostHeader = headerValue.toString();
       }
     }
     _parseArguments(searchStr);
@@ -271,82 +274,77 @@ bool WebServer::_parseRequest(NetworkClient &client) {
   return true;
 }
 
-bool WebServer::_collectHeader(const char *headerName, const char *headerValue) {
-  RequestArgument *last = nullptr;
-  for (RequestArgument *header = _currentHeaders; header; header = header->next) {
+bool WebServer::_collectHeader(StringView headerName, StringView headerValue) {
+  RequestField *last = nullptr;
+  for (RequestField *header = _currentHeaders; header; header = header->next) {
     if (header->next == nullptr) {
       last = header;
     }
     if (header->key.equalsIgnoreCase(headerName)) {
-      header->value = headerValue;
-      log_v("header collected: %s: %s", headerName, headerValue);
+      header->value = _requestArena.copy(headerValue);
+      log_v("header collected: %s: %s", header->key.data(), header->value.data());
       return true;
     }
   }
   assert(last);
   if (_collectAllHeaders) {
-    last->next = new RequestArgument();
-    last->next->key = headerName;
-    last->next->value = headerValue;
+    RequestField *header = _requestArena.allocArray<RequestField>(1);
+    if (!header) {
+      log_e("No memory for header");
+      return false;
+    }
+    header->key = _requestArena.copy(headerName);
+    header->value = _requestArena.copy(headerValue);
+    last->next = header;
     _headerKeysCount++;
-    log_v("header collected: %s: %s", headerName, headerValue);
+    log_v("header collected: %s: %s", header->key.data(), header->value.data());
     return true;
   }
 
-  log_v("header skipped: %s: %s", headerName, headerValue);
+  log_v("header skipped: %.*s: %.*s", (int)headerName.length(), headerName.data(), (int)headerValue.length(), headerValue.data());
 
   return false;
 }
 
 void WebServer::_parseArguments(const String &data) {
   log_v("args: %s", data.c_str());
-  if (_currentArgs) {
-    delete[] _currentArgs;
-  }
-  _currentArgs = 0;
-  if (data.length() == 0) {
-    _currentArgCount = 0;
-    _currentArgs = new RequestArgument[1];
-    return;
+  StringView args(data);
+  // one more slot than arguments for the body of a plain POST
+  int count = args.isEmpty() ? 0 : 1;
+  for (int i = args.indexOf('&'); i != -1; i = args.indexOf('&', i + 1)) {
+    ++count;
   }
-  _currentArgCount = 1;
+  log_v("args count: %d", count);
 
-  for (int i = 0; i < (int)data.length();) {
-    i = data.indexOf('&', i);
-    if (i == -1) {
-      break;
-    }
-    ++i;
-    ++_currentArgCount;
+  _currentArgCount = 0;
+  _currentArgs = _requestArena.allocArray<RequestField>(count + 1);
+  if (!_currentArgs) {
+    log_e("No memory for %d args", count);
+    return;
   }
-  log_v("args count: %d", _currentArgCount);
-
-  _currentArgs = new RequestArgument[_currentArgCount + 1];
   int pos = 0;
-  int iarg;
-  for (iarg = 0; iarg < _currentArgCount;) {
-    int equal_sign_index = data.indexOf('=', pos);
-    int next_arg_index = data.indexOf('&', pos);
+  while (_currentArgCount < count) {
+    int equal_sign_index = args.indexOf('=', pos);
+    int next_arg_index = args.indexOf('&', pos);
     log_v("pos %d =@%d &@%d", pos, equal_sign_index, next_arg_index);
     if ((equal_sign_index == -1) || ((equal_sign_index > next_arg_index) && (next_arg_index != -1))) {
-      log_e("arg missing value: %d", iarg);
+      log_e("arg missing value: %d", _currentArgCount);
       if (next_arg_index == -1) {
         break;
       }
       pos = next_arg_index + 1;
       continue;
     }
-    RequestArgument &arg = _currentArgs[iarg];
-    arg.key = urlDecode(data.substring(pos, equal_sign_index));
-    arg.value = urlDecode(data.substring(equal_sign_index + 1, next_arg_index));
-    log_v("arg %d key: %s value: %s", iarg, arg.key.c_str(), arg.value.c_str());
-    ++iarg;
+    RequestField &arg = _currentArgs[_currentArgCount];
+    arg.key = _urlDecode(args.substring(pos, equal_sign_index));
+    arg.value = _urlDecode(args.substring(equal_sign_index + 1, next_arg_index == -1 ? args.length() : next_arg_index));
+    log_v("arg %d key: %s value: %s", _currentArgCount, arg.key.data(), arg.value.data());
+    ++_currentArgCount;
     if (next_arg_index == -1) {
       break;
     }
     pos = next_arg_index + 1;
   }
-  _currentArgCount = iarg;
   log_v("args count: %d", _currentArgCount);
 }
 
@@ -418,11 +416,12 @@ bool WebServer::_parseForm(NetworkClient &client, const String &boundary, uint32
   client.readStringUntil('\n');
   //start reading the form
   if (line == ("--" + boundary)) {
-    if (_postArgs) {
-      delete[] _postArgs;
-    }
-    _postArgs = new RequestArgument[WEBSERVER_MAX_POST_ARGS];
+    _postArgs = _requestArena.allocArray<RequestField>(WEBSERVER_MAX_POST_ARGS);
     _postArgsLen = 0;
+    if (!_postArgs) {
+      log_e("No memory for PostArgs");
+      return false;
+    }
     while (1) {
       String argName;
       String argValue;
@@ -477,9 +476,9 @@ bool WebServer::_parseForm(NetworkClient &client, const String &boundary, uint32
             }
             log_v("PostArg Value: %s", argValue.c_str());
 
-            RequestArgument &arg = _postArgs[_postArgsLen++];
-            arg.key = argName;
-            arg.value = argValue;
+            RequestField &arg = _postArgs[_postArgsLen++];
+            arg.key = _requestArena.copy(argName);
+            arg.value = _requestArena.copy(argValue);
 
             if (line == ("--" + boundary + "--")) {
               log_v("Done Parsing POST");
@@ -563,25 +562,13 @@ bool WebServer::_parseForm(NetworkClient &client, const String &boundary, uint32
     int iarg;
     int totalArgs = ((WEBSERVER_MAX_POST_ARGS - _postArgsLen) < _currentArgCount) ? (WEBSERVER_MAX_POST_ARGS - _postArgsLen) : _currentArgCount;
     for (iarg = 0; iarg < totalArgs; iarg++) {
-      RequestArgument &arg = _postArgs[_postArgsLen++];
-      arg.key = _currentArgs[iarg].key;
-      arg.value = _currentArgs[iarg].value;
-    }
-    if (_currentArgs) {
-      delete[] _currentArgs;
-    }
-    _currentArgs = new RequestArgument[_postArgsLen];
-    for (iarg = 0; iarg < _postArgsLen; iarg++) {
-      RequestArgument &arg = _currentArgs[iarg];
-      arg.key = _postArgs[iarg].key;
-      arg.value = _postArgs[iarg].value;
-    }
-    _currentArgCount = iarg;
-    if (_postArgs) {
-      delete[] _postArgs;
-      _postArgs = nullptr;
-      _postArgsLen = 0;
+      _postArgs[_postArgsLen++] = _currentArgs[iarg];
     }
+    // the texts stay where they are in the arena, only the list changes
+    _currentArgs = _postArgs;
+    _currentArgCount = _postArgsLen;
+    _postArgs = nullptr;
+    _postArgsLen = 0;
     return true;
   }
   log_e("Error: line: %s", line.c_str());
@@ -613,6 +600,37 @@ String WebServer::urlDecode(const String &text) {
   return decoded;
 }
 
+StringView WebServer::_urlDecode(StringView text) {
+  // decoding never makes the text longer
+  char *decoded = _requestArena.allocChars(text.length());
+  if (!decoded) {
+    return StringView();
+  }
+  char temp[] = "0x00";
+  size_t len = text.length();
+  size_t i = 0;
+  size_t n = 0;
+  while (i < len) {
+    char decodedChar;
+    char encodedChar = text[i++];
+    if ((encodedChar == '%') && (i + 1 < len)) {
+      temp[2] = text[i++];
+      temp[3] = text[i++];
+
+      decodedChar = strtol(temp, NULL, 16);
+    } else {
+      if (encodedChar == '+') {
+        decodedChar = ' ';
+      } else {
+        decodedChar = encodedChar;  // normal ascii char
+      }
+    }
+    decoded[n++] = decodedChar;
+  }
+  decoded[n] = 0;
+  return StringView(decoded, n);
+}
+
 bool WebServer::_parseFormUploadAborted() {
   _currentUpload->status = UPLOAD_FILE_ABORTED;
   if (_currentHandler && _currentHandler->canUpload(*this, _currentUri)) {
@@ -446,6 +446,8 @@ void WebServer::handleClient() {
             } else {
               _handleRequest();
             }
+            // arguments and headers are gone with the request
+            _resetRequest();
 
             if (_currentClient.isSSE()) {
               _currentStatus = HC_WAIT_CLOSE;
@@ -782,6 +784,10 @@ String WebServer::pathArg(unsigned int i) const {
 }
 
 String WebServer::arg(const String &name) const {
+  return argView(name).toString();
+}
+
+StringView WebServer::argView(StringView name) const {
   for (int j = 0; j < _postArgsLen; ++j) {
     if (_postArgs[j].key == name) {
       return _postArgs[j].value;
@@ -792,19 +798,19 @@ String WebServer::arg(const String &name) const {
       return _currentArgs[i].value;
     }
   }
-  return "";
+  return StringView();
 }
 
 String WebServer::arg(int i) const {
   if (i < _currentArgCount) {
-    return _currentArgs[i].value;
+    return _currentArgs[i].value.toString();
   }
   return "";
 }
 
 String WebServer::argName(int i) const {
   if (i < _currentArgCount) {
-    return _currentArgs[i].key;
+    return _currentArgs[i].key.toString();
   }
   return "";
 }
@@ -828,43 +834,41 @@ bool WebServer::hasArg(const String &name) const {
 }
 
 String WebServer::header(const String &name) const {
-  for (RequestArgument *current = _currentHeaders; current; current = current->next) {
+  return headerView(name).toString();
+}
+
+StringView WebServer::headerView(StringView name) const {
+  for (RequestField *current = _currentHeaders; current; current = current->next) {
     if (current->key.equalsIgnoreCase(name)) {
       return current->value;
     }
   }
-  return "";
+  return StringView();
 }
 
 void WebServer::collectHeaders(const char *headerKeys[], const size_t headerKeysCount) {
   collectAllHeaders();
   _collectAllHeaders = false;
 
-  _headerKeysCount += headerKeysCount;
-
-  RequestArgument *last = _currentHeaders->next;
-
-  for (int i = 2; i < _headerKeysCount; i++) {
-    last->next = new RequestArgument();
-    last->next->key = headerKeys[i - 2];
-    last = last->next;
+  for (size_t i = 0; i < headerKeysCount; i++) {
+    _addHeaderKey(headerKeys[i]);
   }
 }
 
 String WebServer::header(int i) const {
-  RequestArgument *current = _currentHeaders;
+  RequestField *current = _currentHeaders;
   while (current && i--) {
     current = current->next;
   }
-  return current ? current->value : emptyString;
+  return current ? current->value.toString() : emptyString;
 }
 
 String WebServer::headerName(int i) const {
-  RequestArgument *current = _currentHeaders;
+  RequestField *current = _currentHeaders;
   while (current && i--) {
     current = current->next;
   }
-  return current ? current->key : emptyString;
+  return current ? current->key.toString() : emptyString;
 }
 
 int WebServer::headers() const {
@@ -979,25 +983,35 @@ void WebServer::_clearResponseHeaders() {
 
 void WebServer::_clearRequestHeaders() {
   _headerKeysCount = 0;
-  RequestArgument *current = _currentHeaders;
-  while (current) {
-    RequestArgument *next = current->next;
-    delete current;
-    current = next;
-  }
+  _headerKeysConfigured = 0;
   _currentHeaders = nullptr;
+  _lastHeaderKey = nullptr;
+  _headerKeyArena.reset();
+}
+
+void WebServer::_addHeaderKey(StringView key) {
+  RequestField *header = _headerKeyArena.allocArray<RequestField>(1);
+  if (!header) {
+    log_e("No memory for header key");
+    return;
+  }
+  header->key = _headerKeyArena.copy(key);
+  if (_lastHeaderKey) {
+    _lastHeaderKey->next = header;
+  } else {
+    _currentHeaders = header;
+  }
+  _lastHeaderKey = header;
+  _headerKeysConfigured++;
+  _headerKeysCount = _headerKeysConfigured;
 }
 
 void WebServer::collectAllHeaders() {
   _clearRequestHeaders();
 
-  _currentHeaders = new RequestArgument();
-  _currentHeaders->key = FPSTR(AUTHORIZATION_HEADER);
-
-  _currentHeaders->next = new RequestArgument();
-  _currentHeaders->next->key = FPSTR(ETAG_HEADER);
+  _addHeaderKey(FPSTR(AUTHORIZATION_HEADER));
+  _addHeaderKey(FPSTR(ETAG_HEADER));
 
-  _headerKeysCount = 2;
   _collectAllHeaders = true;
 }
 
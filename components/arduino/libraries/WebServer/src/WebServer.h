@@ -29,6 +29,7 @@
 #include "Network.h"
 #include "HTTP_Method.h"
 #include "Uri.h"
+#include "StringArena.h"
 
 enum HTTPUploadStatus {
   UPLOAD_FILE_START,
@@ -69,6 +70,10 @@ enum HTTPAuthMethod {
 #define HTTP_MAX_CLOSE_WAIT     5000  //ms to wait for the client to close the connection
 #define HTTP_MAX_BASIC_AUTH_LEN 256   // maximum length of a basic Auth base64 encoded username:password string
 
+#ifndef WEBSERVER_ARENA_CHUNK_SIZE
+#define WEBSERVER_ARENA_CHUNK_SIZE 512  // request arguments and headers are allocated in chunks of this size
+#endif
+
 #define CONTENT_LENGTH_UNKNOWN ((size_t) - 1)
 #define CONTENT_LENGTH_NOT_SET ((size_t) - 2)
 
@@ -196,6 +201,8 @@ public:
   String headerName(int i) const;                                               // get request header name by number
   int headers() const;                                                          // get header count
   bool hasHeader(const String &name) const;                                     // check if header exists
+  StringView argView(StringView name) const;                                    // argument value without a copy, valid while the request is handled
+  StringView headerView(StringView name) const;                                 // header value without a copy, valid while the request is handled
 
   int clientContentLength() const;  // return "content-length" of incoming HTTP header from "_currentClient"
   const String version() const;     // get the HTTP version string
@@ -267,7 +274,7 @@ protected:
   void _uploadWriteByte(uint8_t b);
   int _uploadReadByte(NetworkClient &client);
   void _prepareHeader(String &response, int code, const char *content_type, size_t contentLength);
-  bool _collectHeader(const char *headerName, const char *headerValue);
+  bool _collectHeader(StringView headerName, StringView headerValue);
 
   void _streamFileCore(const size_t fileSize, const String &fileName, const String &contentType, const int code = 200);
 
@@ -277,6 +284,9 @@ protected:
 
   void _clearResponseHeaders();
   void _clearRequestHeaders();
+  void _addHeaderKey(StringView key);
+  void _resetRequest();
+  StringView _urlDecode(StringView text);
 
   struct RequestArgument {
     String key;
@@ -284,6 +294,13 @@ protected:
     RequestArgument *next;
   };
 
+  // request argument or header, the text lives in _requestArena or _headerKeyArena
+  struct RequestField {
+    StringView key;
+    StringView value;
+    RequestField *next;
+  };
+
   boolean _corsEnabled = false;
   NetworkServer _server;
 
@@ -301,16 +318,21 @@ protected:
   THandlerFunction _notFoundHandler = nullptr;
   THandlerFunction _fileUploadHandler = nullptr;
 
+  StringArena _requestArena{WEBSERVER_ARENA_CHUNK_SIZE};  // released at the end of each request
+  StringArena _headerKeyArena{128};                       // keys of the headers to collect
+
   int _currentArgCount = 0;
-  RequestArgument *_currentArgs = nullptr;
+  RequestField *_currentArgs = nullptr;
   int _postArgsLen = 0;
-  RequestArgument *_postArgs = nullptr;
+  RequestField *_postArgs = nullptr;
 
   std::unique_ptr<HTTPUpload> _currentUpload;
   std::unique_ptr<HTTPRaw> _currentRaw;
 
   int _headerKeysCount = 0;
-  RequestArgument *_currentHeaders = nullptr;
+  RequestField *_currentHeaders = nullptr;
+  RequestField *_lastHeaderKey = nullptr;  // headers after it were collected from the current request only
+  int _headerKeysConfigured = 0;
   size_t _contentLength = 0;
   int _clientContentLength = 0;  // "Content-Length" from header of incoming POST or GET request
   RequestArgument *_responseHeaders = nullptr;
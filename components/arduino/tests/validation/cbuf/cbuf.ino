@@ -0,0 +1,138 @@
+/* cbuf / SpscRing test */
+#include <unity.h>
+#include <cbuf.h>
+
+#define STRESS_BYTES 1000000
+
+static uint8_t pattern(size_t i) {
+  return (uint8_t)(i * 2654435761u >> 13);
+}
+
+static SpscRing *ring = NULL;
+static volatile bool producer_done;
+
+/* setUp / tearDown functions are intended to be called before / after each test. */
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void cbuf_api_test(void) {
+  cbuf b(100);
+  char out[16];
+
+  TEST_ASSERT_EQUAL(128, b.size());
+  TEST_ASSERT_TRUE(b.empty());
+  TEST_ASSERT_EQUAL(11, b.write("hello world", 11));
+  TEST_ASSERT_EQUAL('h', b.peek());
+  TEST_ASSERT_EQUAL(11, b.available());
+  TEST_ASSERT_EQUAL('h', b.read());
+  TEST_ASSERT_EQUAL(4, b.read(out, 4));
+  TEST_ASSERT_EQUAL_MEMORY("ello", out, 4);
+  TEST_ASSERT_EQUAL(5, b.remove(1));
+
+  // resize keeps the data and refuses to drop any
+  TEST_ASSERT_EQUAL(128, b.resize(4));
+  TEST_ASSERT_EQUAL(8, b.resize(8));
+  TEST_ASSERT_EQUAL(5, b.read(out, sizeof(out)));
+  TEST_ASSERT_EQUAL_MEMORY("world", out, 5);
+
+  memset(out, 0xff, sizeof(out));
+  TEST_ASSERT_EQUAL(8, b.write(out, sizeof(out)));
+  TEST_ASSERT_TRUE(b.full());
+  TEST_ASSERT_EQUAL(255, b.read());
+  TEST_ASSERT_EQUAL(16, b.resizeAdd(8));
+  TEST_ASSERT_EQUAL(7, b.available());
+  b.flush();
+  TEST_ASSERT_TRUE(b.empty());
+}
+
+void cbuf_span_test(void) {
+  cbuf b(8);
+  char *w;
+  const char *r;
+
+  // fill across the wrap
+  TEST_ASSERT_EQUAL(6, b.write("abcdef", 6));
+  TEST_ASSERT_EQUAL(0, b.remove(6));
+  TEST_ASSERT_EQUAL(2, b.writeSpan(&w));
+  memcpy(w, "gh", 2);
+  b.commit(2);
+  TEST_ASSERT_EQUAL(6, b.writeSpan(&w));
+  memcpy(w, "ij", 2);
+  b.commit(2);
+  TEST_ASSERT_EQUAL(2, b.readSpan(&r));
+  TEST_ASSERT_EQUAL_MEMORY("gh", r, 2);
+  b.consume(2);
+  TEST_ASSERT_EQUAL(2, b.readSpan(&r));
+  TEST_ASSERT_EQUAL_MEMORY("ij", r, 2);
+}
+
+static void producer_task(void *arg) {
+  size_t sent = 0;
+  uint32_t seed = 1;
+  while (sent < STRESS_BYTES) {
+    uint8_t *data;
+    size_t n = ring->writeSpan(&data);
+    seed = seed * 1103515245 + 12345;
+    size_t want = (seed >> 16) % 200;
+    if (n > want) {
+      n = want;
+    }
+    if (n > STRESS_BYTES - sent) {
+      n = STRESS_BYTES - sent;
+    }
+    for (size_t i = 0; i < n; i++) {
+      data[i] = pattern(sent + i);
+    }
+    ring->commit(n);
+    sent += n;
+    if (n == 0) {
+      taskYIELD();
+    }
+  }
+  producer_done = true;
+  vTaskDelete(NULL);
+}
+
+void spsc_stress_test(void) {
+  ring = new SpscRing(256);
+  producer_done = false;
+#if CONFIG_FREERTOS_NUMBER_OF_CORES > 1
+  xTaskCreatePinnedToCore(producer_task, "producer", 4096, NULL, uxTaskPriorityGet(NULL), NULL, 1 - xPortGetCoreID());
+#else
+  xTaskCreate(producer_task, "producer", 4096, NULL, uxTaskPriorityGet(NULL), NULL);
+#endif
+
+  size_t got = 0;
+  uint8_t buf[64];
+  while (got < STRESS_BYTES) {
+    size_t n = ring->read(buf, sizeof(buf));
+    for (size_t i = 0; i < n; i++) {
+      TEST_ASSERT_EQUAL_UINT8(pattern(got + i), buf[i]);
+    }
+    got += n;
+    if (n == 0) {
+      taskYIELD();
+    }
+  }
+  while (!producer_done) {
+    delay(1);
+  }
+  TEST_ASSERT_EQUAL(0, ring->available());
+  delete ring;
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {
+    ;
+  }
+
+  UNITY_BEGIN();
+  RUN_TEST(cbuf_api_test);
+  RUN_TEST(cbuf_span_test);
+  RUN_TEST(spsc_stress_test);
+  UNITY_END();
+}
+
+void loop() {}
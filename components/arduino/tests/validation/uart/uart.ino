@@ -156,6 +156,53 @@ void basic_transmission_test(void) {
   Serial.println("Basic transmission test successful");
 }
 
+// This test checks if the received bytes are split into frames, by a delimiter and by a length in the frame header
+void frame_receive_test(void) {
+  for (auto *ref : uart_test_configs) {
+    UARTTestConfig &config = *ref;
+    String frames;
+    log_d("Receiving frames delimited by ';' on UART%d", config.uart_num);
+    bool ret = config.serial.onReceiveFrame(
+      [&](SerialFrame *frame) {
+        frames += String((const char *)frame->data, frame->length) + "|";
+        config.serial.releaseFrame(frame);
+      },
+      SerialFrameReceiver::delimiter(';'), 16, 2
+    );
+    TEST_ASSERT_TRUE(ret);
+    config.serial.print("one;two;three;");
+    config.serial.flush();
+    delay(100);
+    TEST_ASSERT_EQUAL_STRING("one;|two;|three;|", frames.c_str());
+
+    log_d("Receiving frames with a length byte on UART%d", config.uart_num);
+    frames = "";
+    ret = config.serial.onReceiveFrame(
+      [&](SerialFrame *frame) {
+        frames += String((const char *)frame->data + 1, frame->length - 1) + "|";
+        config.serial.releaseFrame(frame);
+      },
+      [](const uint8_t *data, size_t len) -> int {
+        if (data[0] < 2 || data[0] > 16) {
+          return -1;  // not a length, skip it
+        }
+        return len >= data[0] ? data[0] : 0;
+      },
+      16, 2
+    );
+    TEST_ASSERT_TRUE(ret);
+    const uint8_t stream[] = {0xFF, 4, 'a', 'b', 'c', 3, 'd', 'e'};
+    config.serial.write(stream, sizeof(stream));
+    config.serial.flush();
+    delay(100);
+    TEST_ASSERT_EQUAL_STRING("abc|de|", frames.c_str());
+
+    config.serial.onReceiveFrame(NULL);
+  }
+
+  Serial.println("Frame receive test successful");
+}
+
 // This test checks if the baudrate can be changed and if the message can be transmitted and received correctly after the change
 void change_baudrate_test(void) {
   for (auto *ref : uart_test_configs) {
@@ -539,6 +586,7 @@ void setup() {
   UNITY_BEGIN();
   RUN_TEST(begin_when_running_test);
   RUN_TEST(basic_transmission_test);
+  RUN_TEST(frame_receive_test);
   RUN_TEST(resize_buffers_test);
   RUN_TEST(change_baudrate_test);
   RUN_TEST(change_cpu_frequency_test);
@@ -1,42 +1,185 @@
 #include "Arduino.h"
 #include "MQ2.h"
 
+//the baseline moves once per second of samples, whatever the window length
+#define BASELINE_STEP_MS 1000
+//EWMA weights (as shifts) of the baseline steps, rising towards cleaner air is faster
+#define BASELINE_RISE_SHIFT 3
+#define BASELINE_FALL_SHIFT 8
+//steps up to Ro/8 below the baseline still count as clean air
+#define BASELINE_CLEAN_BAND_SHIFT 3
+
+//frames signalled by the ADC DMA interrupt, consumed by MQ2::update()
+static volatile uint32_t framesReady = 0;
+
+static void ARDUINO_ISR_ATTR MQFrameReady() {
+  framesReady = framesReady + 1;
+}
+
 MQ2::MQ2(int pin) {
   _pin = pin;
 }
 void MQ2::begin(){
-    Ro = MQCalibration();
-    Serial.print("Ro: ");
-    Serial.print(Ro);
-    Serial.println(" kohm");
+    MQSetRo(MQCalibration());
+    Serial.print("Ro: {} kohm\r\n", Ro);
+}
+
+/*
+ * Starts DMA driven sampling of the sensor pin. The ADC fills its ring buffer
+ * in the background, update() folds finished frames into a window and computes
+ * Rs once per window. Replaces begin().
+ * Pass a previously saved Ro (see getRo()) to skip the calibration, otherwise
+ * Ro is taken from the first window and the sensor has to be in clean air
+ * while it is collected. Afterwards Ro follows the clean air baseline.
+ */
+bool MQ2::beginContinuous(uint32_t sampling_freq_hz, uint16_t window_frames, float ro){
+    uint8_t pins[] = { (uint8_t)_pin };
+
+    analogContinuousSetWidth(MQ2_ADC_BITS);
+    if (!analogContinuous(pins, 1, MQ2_FRAME_CONVERSIONS, sampling_freq_hz, &MQFrameReady)) {
+        return false;
+    }
+    _windowFrames = window_frames > 0 ? window_frames : 1;
+    _frameCount = 0;
+    _rawSum = 0;
+    _baselineFrames = (uint64_t)sampling_freq_hz * BASELINE_STEP_MS / 1000 / MQ2_FRAME_CONVERSIONS;
+    _baselineFrames = _baselineFrames > 0 ? _baselineFrames : 1;
+    _baselineCount = 0;
+    _baselineRawSum = 0;
+    _framesConsumed = framesReady;
+    _calibrated = ro > 0;
+    if (_calibrated) {
+        MQSetRo(ro);
+    }
+    _continuous = analogContinuousStart();
+    return _continuous;
+}
+
+/*
+ * Stops the acquisition started by beginContinuous() and releases the ADC,
+ * so beginContinuous() can be called again.
+ */
+void MQ2::endContinuous(){
+    if (!_continuous) {
+        return;
+    }
+    analogContinuousStop();
+    analogContinuousDeinit();
+    _continuous = false;
+}
+
+/*
+ * Collects the frames finished since the last call without waiting for the ADC.
+ * Returns true when a window was completed and lpg, co and smoke were updated.
+ * A frame takes MQ2_FRAME_CONVERSIONS / sampling_freq_hz (25 ms at 20 kHz) and
+ * the driver keeps only two, so this has to be called at least once a frame.
+ */
+bool MQ2::update(){
+    if (!_continuous) {
+        return false;
+    }
+    bool updated = false;
+    uint32_t pending = framesReady - _framesConsumed;
+
+    //the driver only keeps two frames, older ones are already overwritten
+    if (pending > 2) {
+        pending = 2;
+    }
+    while (pending-- > 0) {
+        adc_continuous_data_t *result = NULL;
+        if (!analogContinuousRead(&result, 0)) {
+            break;
+        }
+        _rawSum += result[0].avg_read_raw;
+        _baselineRawSum += result[0].avg_read_raw;
+        if (++_frameCount >= _windowFrames) {
+            uint32_t rs = MQ2Kernel::rs(_rawSum / _frameCount);
+            _rawSum = 0;
+            _frameCount = 0;
+            if (!_calibrated) {
+                MQSetRo(MQ2Kernel::toFloat(MQ2Kernel::ro(rs, MQ2Kernel::fromFloat(RO_CLEAN_AIR_FACTOR))));
+                _calibrated = true;
+            }
+            MQUpdateGases(rs);
+            updated = true;
+        }
+        if (++_baselineCount >= _baselineFrames) {
+            if (_calibrated) {
+                MQTrackBaseline(MQ2Kernel::rs(_baselineRawSum / _baselineCount));
+            }
+            _baselineRawSum = 0;
+            _baselineCount = 0;
+        }
+    }
+    _framesConsumed = framesReady;
+    return updated;
+}
+
+float MQ2::getRo(){
+    return Ro;
+}
+
+/*
+ * Online baseline estimation, one step per BASELINE_STEP_MS of samples. Gas
+ * lowers Rs, so a step that would give a higher Ro than the current one is
+ * cleaner air and is followed quickly. Steps slightly below the baseline let
+ * Ro drift down slowly with sensor aging, steps further below are treated as
+ * gas and leave Ro untouched.
+ */
+void MQ2::MQTrackBaseline(uint32_t rs_q16){
+    uint32_t ro = MQ2Kernel::fromFloat(Ro);
+    uint32_t target = MQ2Kernel::ro(rs_q16, MQ2Kernel::fromFloat(RO_CLEAN_AIR_FACTOR));
+
+    if (target > ro) {
+        ro += (target - ro) >> BASELINE_RISE_SHIFT;
+    } else if (target > ro - (ro >> BASELINE_CLEAN_BAND_SHIFT)) {
+        ro -= (ro - target) >> BASELINE_FALL_SHIFT;
+    } else {
+        return;
+    }
+    MQSetRo(MQ2Kernel::toFloat(ro));
+}
+
+void MQ2::MQSetRo(float ro){
+    Ro = ro;
+    _invRo = MQ2Kernel::inverse(MQ2Kernel::fromFloat(ro));
+}
+
+/*
+ * Integer-only path from Rs to ppm, only the results are converted to float.
+ */
+void MQ2::MQUpdateGases(uint32_t rs_q16){
+    uint32_t ratio = MQ2Kernel::ratio(rs_q16, _invRo);
+    lpg = MQ2Kernel::toFloat(LPGTable.lookupQ16(ratio));
+    co = MQ2Kernel::toFloat(COTable.lookupQ16(ratio));
+    smoke = MQ2Kernel::toFloat(SmokeTable.lookupQ16(ratio));
 }
 
 float* MQ2::read(bool print){
 
-   lpg = MQGetGasPercentage(MQRead()/Ro,GAS_LPG);
-   co = MQGetGasPercentage(MQRead()/Ro,GAS_CO);
-   smoke = MQGetGasPercentage(MQRead()/Ro,GAS_SMOKE);
+   if (_continuous){
+       update();
+   }else{
+       lpg = MQGetGasPercentage(MQRead()/Ro,GAS_LPG);
+       co = MQGetGasPercentage(MQRead()/Ro,GAS_CO);
+       smoke = MQGetGasPercentage(MQRead()/Ro,GAS_SMOKE);
+   }
 
    if (print){
-       Serial.print("LPG:");
-       Serial.print(lpg);
-       Serial.print( "ppm" );
-       Serial.print("    ");
-       Serial.print("CO:");
-       Serial.print(co);
-       Serial.print( "ppm" );
-       Serial.print("    ");
-       Serial.print("SMOKE:");
-       Serial.print(smoke);
-       Serial.print( "ppm" );
-       Serial.print("\n");
+       Serial.print("LPG:{}ppm    CO:{}ppm    SMOKE:{}ppm\n", lpg, co, smoke);
    }
    lastReadTime = millis();
-   static float values[3] = {lpg,co,smoke};
+   values[0] = lpg;
+   values[1] = co;
+   values[2] = smoke;
    return values;
 }
 
 float MQ2::readLPG(){
+    if (_continuous){
+        update();
+        return lpg;
+    }
     if (millis()<(lastReadTime + 10000) && lpg != 0){
         return lpg;
     }else{
@@ -45,6 +188,10 @@ float MQ2::readLPG(){
 }
 
 float MQ2::readCO(){
+    if (_continuous){
+        update();
+        return co;
+    }
     if (millis()<(lastReadTime + 10000) && co != 0){
         return co;
     }else{
@@ -53,6 +200,10 @@ float MQ2::readCO(){
 }
 
 float MQ2::readSmoke(){
+    if (_continuous){
+        update();
+        return smoke;
+    }
     if (millis()<(lastReadTime + 10000) && smoke != 0){
         return smoke;
     }else{
@@ -61,7 +212,7 @@ float MQ2::readSmoke(){
 }
 
 float MQ2::MQResistanceCalculation(int raw_adc) {
-   return (((float)RL_VALUE*(1023-raw_adc)/raw_adc));
+   return MQ2Kernel::toFloat(MQ2Kernel::rs(raw_adc));
 }
 
 float MQ2::MQCalibration() {
@@ -92,14 +243,18 @@ float MQ2::MQRead() {
 }
 float MQ2::MQGetGasPercentage(float rs_ro_ratio, int gas_id) {
   if ( gas_id == GAS_LPG ) {
-     return MQGetPercentage(rs_ro_ratio,LPGCurve);
+     return MQGetPercentage(rs_ro_ratio,LPGTable);
   } else if ( gas_id == GAS_CO ) {
-     return MQGetPercentage(rs_ro_ratio,COCurve);
+     return MQGetPercentage(rs_ro_ratio,COTable);
   } else if ( gas_id == GAS_SMOKE ) {
-     return MQGetPercentage(rs_ro_ratio,SmokeCurve);
+     return MQGetPercentage(rs_ro_ratio,SmokeTable);
   }    
   return 0;
 }
-int MQ2::MQGetPercentage(float rs_ro_ratio, float *pcurve) {
-  return (pow(10,(((log(rs_ro_ratio)-pcurve[1])/pcurve[2]) + pcurve[0])));
+/*
+ * Converts the ratio with the precomputed curve table (see MQ2Curves.h)
+ * instead of evaluating log() and pow() in double precision on every read.
+ */
+float MQ2::MQGetPercentage(float rs_ro_ratio, const MQ2CurveTable &table) {
+  return table.lookup(rs_ro_ratio);
 }
@@ -9,6 +9,21 @@
 
 #endif
 
+#include "MQ2Curves.h"
+#include "MQ2Fixed.h"
+
+#ifndef MQ2_ADC_BITS
+#define MQ2_ADC_BITS 12     //resolution of analogRead() and of the continuous ADC
+#endif
+#ifndef MQ2_FRAME_CONVERSIONS
+#define MQ2_FRAME_CONVERSIONS 500 //conversions the ADC DMA averages into one frame (2 bytes each, frame must stay below 4092 bytes)
+#endif
+#ifndef MQ2_RL_OHMS
+#define MQ2_RL_OHMS 5000    //define the load resistance on the board, in ohms
+#endif
+
+typedef MQ2FixedKernel<MQ2_ADC_BITS, MQ2_RL_OHMS> MQ2Kernel;
+
 class MQ2 {
 public: 
 	MQ2(int pin);
@@ -17,19 +32,20 @@ public:
 	float readCO();
 	float readSmoke();
 	void begin();
+	bool beginContinuous(uint32_t sampling_freq_hz = 20000, uint16_t window_frames = 40, float ro = 0);
+	void endContinuous();
+	bool update();
+	float getRo();
 private:
 	int _pin;
-	int RL_VALUE = 5;     //define the load resistance on the board, in kilo ohms
-	int RO_CLEAN_AIR_FACTOR = 9.83;  
+	float RO_CLEAN_AIR_FACTOR = 9.83;  
 	int CALIBARAION_SAMPLE_TIMES = 5; 
 	int CALIBRATION_SAMPLE_INTERVAL = 50;
 	int READ_SAMPLE_INTERVAL = 50;
 	int READ_SAMPLE_TIMES = 5;
 
-	float LPGCurve[3]  =  {2.3,0.21,-0.47}; 
-	float COCurve[3]  =  {2.3,0.72,-0.34};   
-	float SmokeCurve[3] = {2.3,0.53,-0.44};                                                       
 	float Ro = 10;             
+	uint32_t _invRo = MQ2Kernel::inverse(MQ2Kernel::fromFloat(10));
  
     	int GAS_LPG = 0;
 	int GAS_CO = 1;
@@ -38,14 +54,29 @@ private:
 	float lpg = 0;
 	float co = 0;
 	float smoke = 0;
+	float values[3] = {0, 0, 0}; //returned by read(), valid until the next call
 	
 	float MQRead();
 	float MQGetGasPercentage(float rs_ro_ratio, int gas_id);
-	int MQGetPercentage(float rs_ro_ratio, float *pcurve);
+	float MQGetPercentage(float rs_ro_ratio, const MQ2CurveTable &table);
 	float MQCalibration();
 	float MQResistanceCalculation(int raw_adc);
 
 	int lastReadTime = 0;
+
+	bool _continuous = false;   //ADC continuous (DMA) acquisition is running
+	bool _calibrated = false;   //Ro was taken from the first continuous window
+	uint16_t _windowFrames = 0; //frames averaged into one Rs value
+	uint16_t _frameCount = 0;
+	uint32_t _rawSum = 0;
+	uint32_t _framesConsumed = 0;
+	uint16_t _baselineFrames = 0; //frames per baseline step, one second of samples
+	uint16_t _baselineCount = 0;
+	uint32_t _baselineRawSum = 0;
+
+	void MQSetRo(float ro);
+	void MQTrackBaseline(uint32_t rs_q16);
+	void MQUpdateGases(uint32_t rs_q16);
 };
 
 //#endif
@@ -0,0 +1,153 @@
+#ifndef MQ2Curves_h
+#define MQ2Curves_h
+
+#include <stdint.h>
+#include <string.h>
+#include <array>
+
+/*
+ * Gas curves of the MQ-2 datasheet, given as {x, y, slope} of the log-log line:
+ * ppm = 10^(((log(rs_ro_ratio) - y) / slope) + x)
+ */
+struct MQ2Curve {
+	double x;
+	double y;
+	double slope;
+};
+
+constexpr MQ2Curve LPGCurve   = {2.3, 0.21, -0.47};
+constexpr MQ2Curve COCurve    = {2.3, 0.72, -0.34};
+constexpr MQ2Curve SmokeCurve = {2.3, 0.53, -0.44};
+
+/*
+ * Lookup table of one gas curve, generated at compile time.
+ *
+ * The table is indexed by the Rs/Ro ratio quantized in the log2 domain: the
+ * exponent and the top STEP_BITS mantissa bits of the float ratio select a
+ * segment, the remaining mantissa bits interpolate linearly inside of it.
+ * Ratios outside of [2^MIN_EXP, 2^MAX_EXP] are clamped to the table ends.
+ */
+class MQ2CurveTable {
+public:
+	static constexpr int MIN_EXP = -4;
+	static constexpr int MAX_EXP = 4;
+	static constexpr int STEP_BITS = 5;
+	static constexpr int SIZE = ((MAX_EXP - MIN_EXP) << STEP_BITS) + 1;
+
+	constexpr explicit MQ2CurveTable(const MQ2Curve &curve) : _ppm(), _ppmQ16(), _satIndex(-1), _satPpmQ16(0) {
+		for (int i = 0; i < SIZE; i++) {
+			int e = (i >> STEP_BITS) + MIN_EXP;
+			double m = 1.0 + (double)(i & ((1 << STEP_BITS) - 1)) / (1 << STEP_BITS);
+			double ln_ratio = (double)e * LN2 + cln1p(m - 1.0);
+			double ppm = cexp(LN10 * (((ln_ratio - curve.y) / curve.slope) + curve.x));
+			_ppm[i] = (float)ppm;
+			if (ppm * 65536.0 >= 4294967295.0) {
+				_ppmQ16[i] = 0xFFFFFFFFu;
+				_satIndex = i;
+				_satPpmQ16 = ppm * 65536.0 < (double)(1ull << 44) ? (uint64_t)(ppm * 65536.0 + 0.5) : 1ull << 44;
+			} else {
+				_ppmQ16[i] = (uint32_t)(ppm * 65536.0 + 0.5);
+			}
+		}
+	}
+
+	float lookup(float rs_ro_ratio) const {
+		int32_t bits;
+		memcpy(&bits, &rs_ro_ratio, sizeof(bits));
+		if (bits <= LO_BITS) {
+			return _ppm[0];
+		}
+		if (bits >= HI_BITS) {
+			return _ppm[SIZE - 1];
+		}
+		uint32_t pos = (uint32_t)(bits - LO_BITS);
+		uint32_t i = pos >> FRAC_BITS;
+		float t = (float)(pos & ((1u << FRAC_BITS) - 1)) * (1.0f / (1u << FRAC_BITS));
+		return _ppm[i] + (_ppm[i + 1] - _ppm[i]) * t;
+	}
+
+	/*
+	 * Integer-only variant for a Q16.16 ratio, returns ppm in Q16.16
+	 * saturated at 65535.99 ppm. The ratio is normalized with a count of
+	 * leading zeros so the same segment index as for floats results. The
+	 * segment in which ppm crosses the saturation interpolates from the
+	 * unsaturated value of its first node, so it does not dip below it.
+	 */
+	uint32_t lookupQ16(uint32_t rs_ro_ratio_q16) const {
+		if (rs_ro_ratio_q16 <= LO_Q16) {
+			return _ppmQ16[0];
+		}
+		if (rs_ro_ratio_q16 >= HI_Q16) {
+			return _ppmQ16[SIZE - 1];
+		}
+		int lz = __builtin_clz(rs_ro_ratio_q16);
+		uint32_t e = (uint32_t)(15 - lz - MIN_EXP);
+		uint32_t mantissa = ((rs_ro_ratio_q16 << lz) << 1) >> 9;
+		uint32_t pos = (e << 23) | mantissa;
+		uint32_t i = pos >> FRAC_BITS;
+		int64_t left = (int32_t)i == _satIndex ? (int64_t)_satPpmQ16 : (int64_t)_ppmQ16[i];
+		int64_t delta = (int64_t)_ppmQ16[i + 1] - left;
+		int64_t ppm = left + ((delta * (int64_t)(pos & ((1u << FRAC_BITS) - 1))) >> FRAC_BITS);
+		return ppm < 0xFFFFFFFF ? (uint32_t)ppm : 0xFFFFFFFFu;
+	}
+
+	float operator[](int i) const {
+		return _ppm[i];
+	}
+
+private:
+	static constexpr int FRAC_BITS = 23 - STEP_BITS;
+	//IEEE 754 bit patterns of 2^MIN_EXP and 2^MAX_EXP
+	static constexpr int32_t LO_BITS = (127 + MIN_EXP) << 23;
+	static constexpr int32_t HI_BITS = (127 + MAX_EXP) << 23;
+	//2^MIN_EXP and 2^MAX_EXP in Q16.16
+	static constexpr uint32_t LO_Q16 = 1u << (16 + MIN_EXP);
+	static constexpr uint32_t HI_Q16 = 1u << (16 + MAX_EXP);
+
+	static constexpr double LN2 = 0.69314718055994530942;
+	static constexpr double LN10 = 2.30258509299404568402;
+
+	//exp(x) by range reduction to |r| <= ln2/2 and a Taylor series
+	static constexpr double cexp(double x) {
+		int n = (int)(x / LN2 + (x < 0 ? -0.5 : 0.5));
+		double r = x - n * LN2;
+		double term = 1.0;
+		double sum = 1.0;
+		for (int k = 1; k < 24; k++) {
+			term *= r / k;
+			sum += term;
+		}
+		for (; n > 0; n--) {
+			sum *= 2.0;
+		}
+		for (; n < 0; n++) {
+			sum *= 0.5;
+		}
+		return sum;
+	}
+
+	//log(1 + x) for 0 <= x < 1 via the atanh series
+	static constexpr double cln1p(double x) {
+		double z = x / (2.0 + x);
+		double z2 = z * z;
+		double term = z;
+		double sum = 0.0;
+		for (int k = 1; k < 60; k += 2) {
+			sum += term / k;
+			term *= z2;
+		}
+		return 2.0 * sum;
+	}
+
+	std::array<float, SIZE> _ppm;
+	std::array<uint32_t, SIZE> _ppmQ16;
+	//last saturated node and its value before the saturation, -1 if none is
+	int32_t _satIndex;
+	uint64_t _satPpmQ16;
+};
+
+inline constexpr MQ2CurveTable LPGTable(LPGCurve);
+inline constexpr MQ2CurveTable COTable(COCurve);
+inline constexpr MQ2CurveTable SmokeTable(SmokeCurve);
+
+#endif
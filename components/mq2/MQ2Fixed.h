@@ -0,0 +1,60 @@
+#ifndef MQ2Fixed_h
+#define MQ2Fixed_h
+
+#include <stdint.h>
+
+/*
+ * Integer-only conversion chain from raw ADC counts to Rs, Rs/Ro and ppm.
+ * All values are Q16.16 fixed point, resistances in kilo ohms.
+ *
+ * ADC_BITS is the resolution of the raw readings and RL_OHMS the load
+ * resistor of the board, so every board variant gets its own kernel with
+ * the constants folded in.
+ */
+template <unsigned ADC_BITS, uint32_t RL_OHMS>
+class MQ2FixedKernel {
+public:
+	static constexpr uint32_t ADC_MAX = (1u << ADC_BITS) - 1;
+	static constexpr uint32_t RL_Q16 = (uint32_t)(((uint64_t)RL_OHMS << 16) / 1000);
+
+	static_assert(ADC_BITS >= 8 && ADC_BITS <= 16, "unsupported ADC resolution");
+	static_assert((uint64_t)RL_Q16 * ADC_MAX <= 0xFFFFFFFFu, "load resistor too large for 32 bit math");
+
+	/*
+	 * Rs = RL * (ADC_MAX - raw) / raw. A raw value of 0 is treated as 1 and
+	 * values above ADC_MAX as ADC_MAX, both without branches.
+	 */
+	static uint32_t rs(uint32_t raw) {
+		raw += (raw == 0);
+		raw -= (raw > ADC_MAX) * (raw - ADC_MAX);
+		return (RL_Q16 * (ADC_MAX - raw)) / raw;
+	}
+
+	/*
+	 * Reciprocal of Ro as 2^24 / Ro, computed once per calibration so the
+	 * per sample ratio is a multiply and a shift.
+	 */
+	static uint32_t inverse(uint32_t ro_q16) {
+		ro_q16 += (ro_q16 == 0);
+		return (uint32_t)((1ull << 40) / ro_q16);
+	}
+
+	static uint32_t ratio(uint32_t rs_q16, uint32_t inv_ro) {
+		return (uint32_t)(((uint64_t)rs_q16 * inv_ro) >> 24);
+	}
+
+	//Ro = Rs / clean air factor, the factor given in Q16.16
+	static uint32_t ro(uint32_t rs_q16, uint32_t clean_air_factor_q16) {
+		return (uint32_t)(((uint64_t)rs_q16 << 16) / clean_air_factor_q16);
+	}
+
+	static constexpr float toFloat(uint32_t q16) {
+		return q16 * (1.0f / 65536);
+	}
+
+	static constexpr uint32_t fromFloat(float value) {
+		return (uint32_t)(value * 65536.0f + 0.5f);
+	}
+};
+
+#endif
@@ -0,0 +1,38 @@
+/*
+ * Checks of the host tests. A failed check prints its location and the
+ * test fails once main() returns check_result().
+ */
+#pragma once
+
+#include <math.h>
+#include <stdio.h>
+
+static int check_failures = 0;
+
+#define CHECK(cond)                                                        \
+  do {                                                                     \
+    if (!(cond)) {                                                         \
+      check_failures++;                                                    \
+      printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);      \
+    }                                                                      \
+  } while (0)
+
+// |actual - expected| <= tolerance, printed with both values on failure
+#define CHECK_NEAR(actual, expected, tolerance)                                                         \
+  do {                                                                                                  \
+    double check_a = (actual), check_e = (expected);                                                    \
+    if (!(fabs(check_a - check_e) <= (tolerance))) {                                                    \
+      check_failures++;                                                                                 \
+      printf("%s:%d: %s = %.9g, expected %.9g +- %g\n", __FILE__, __LINE__, #actual, check_a, check_e, \
+             (double)(tolerance));                                                                      \
+    }                                                                                                   \
+  } while (0)
+
+static inline int check_result(void) {
+  if (check_failures) {
+    printf("%d checks failed\n", check_failures);
+    return 1;
+  }
+  printf("all checks passed\n");
+  return 0;
+}
@@ -0,0 +1,4 @@
+/*
+ * Host stand-in, the GFX core only needs the name.
+ */
+#pragma once
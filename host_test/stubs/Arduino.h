@@ -0,0 +1,57 @@
+/*
+ * Host stand-in for the Arduino core header. Declares only what the host
+ * tests compile against: the string and stream classes of the real core,
+ * time functions and the continuous ADC API used by the MQ2 driver.
+ */
+#pragma once
+
+#include <math.h>
+#include <algorithm>
+#include <cmath>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pgmspace.h"
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+#include "StringView.h"
+
+#define ARDUINO_ISR_ATTR
+
+typedef bool boolean;
+
+#define _min(a, b)                ((a) < (b) ? (a) : (b))
+#define _max(a, b)                ((a) > (b) ? (a) : (b))
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+using std::abs;
+using std::max;
+using std::min;
+using std::round;
+
+unsigned long millis(void);
+void delay(uint32_t ms);
+void yield(void);
+
+// Writes to stdout
+extern Print &Serial;
+
+// Continuous ADC, implemented by the tests that need it
+typedef struct {
+  uint8_t pin;
+  uint8_t channel;
+  int avg_read_raw;
+  int avg_read_mvolts;
+} adc_continuous_data_t;
+
+uint16_t analogRead(uint8_t pin);
+bool analogContinuous(const uint8_t pins[], size_t pins_count, uint32_t conversions_per_pin, uint32_t sampling_freq_hz, void (*userFunc)(void));
+bool analogContinuousRead(adc_continuous_data_t **buffer, uint32_t timeout_ms);
+bool analogContinuousStart();
+bool analogContinuousStop();
+bool analogContinuousDeinit();
+void analogContinuousSetWidth(uint8_t bits);
@@ -0,0 +1,42 @@
+/*
+ * Host implementations of the Arduino time functions and of Serial.
+ */
+#include <chrono>
+#include <thread>
+#include "Arduino.h"
+#include "stdlib_noniso.h"
+
+unsigned long millis(void) {
+  using namespace std::chrono;
+  return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void delay(uint32_t ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void yield(void) {
+  std::this_thread::yield();
+}
+
+class StdoutPrint : public Print {
+public:
+  size_t write(uint8_t c) override {
+    return fwrite(&c, 1, 1, stdout);
+  }
+  size_t write(const uint8_t *buffer, size_t size) override {
+    return fwrite(buffer, 1, size, stdout);
+  }
+};
+
+static StdoutPrint stdoutPrint;
+Print &Serial = stdoutPrint;
+
+// newlib provides these on the ESP32, the core's stdlib_noniso.c the rest
+extern "C" char *itoa(int val, char *s, int radix) {
+  return ltoa(val, s, radix);
+}
+
+extern "C" char *utoa(unsigned int val, char *s, int radix) {
+  return ultoa(val, s, radix);
+}
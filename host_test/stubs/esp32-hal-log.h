@@ -0,0 +1,12 @@
+/*
+ * Host stand-in for the core log macros, errors and warnings go to stderr.
+ */
+#pragma once
+
+#include <stdio.h>
+
+#define log_e(format, ...) fprintf(stderr, "[E] " format "\n", ##__VA_ARGS__)
+#define log_w(format, ...) fprintf(stderr, "[W] " format "\n", ##__VA_ARGS__)
+#define log_i(format, ...)
+#define log_d(format, ...)
+#define log_v(format, ...)
@@ -0,0 +1,109 @@
+/*
+ * GFXcanvasBanded16 against GFXcanvas16: the same scene rendered band by
+ * band has to give the full canvas image pixel for pixel, for every
+ * rotation and band height, including a last band shorter than the rest.
+ * Also checks the ping-pong strips and the dirty tracking of rectangles.
+ */
+#include "Adafruit_GFX.h"
+#include "Fonts/SourceCodePro_Bold10pt7b_aa4.h"
+#include "check.h"
+
+#define TFT_W 128
+#define TFT_H 160
+
+static void scene(Adafruit_GFX &g) {
+  g.fillScreen(0x1234);
+  g.fillCircle(60, 70, 40, 0xF800);
+  g.drawLine(0, 0, 127, 159, 0x07E0);
+  g.fillRect(10, 100, 90, 33, 0x001F);
+  g.drawRoundRect(3, 5, 100, 120, 9, 0xFFFF);
+  g.setCursor(5, 20);
+  g.setTextSize(2);
+  g.setTextColor(0xFFE0, 0x8410);
+  g.print("Band 42");
+  g.drawAAText(20, 150, "12.5", &SourceCodePro_Bold10pt7b_aa4, 0x07FF, 0);
+  g.fillTriangle(100, 2, 127, 150, 50, 159, 0xABCD);
+  g.drawPixel(-1, 5, 0xFFFF);
+  g.drawFastHLine(-10, 159, 300, 0x5555);
+}
+
+static void checkBands(uint8_t rotation, uint16_t bandH) {
+  GFXcanvas16 ref(TFT_W, TFT_H);
+  ref.setRotation(rotation);
+  scene(ref);
+
+  GFXcanvasBanded16 banded(TFT_W, TFT_H, bandH);
+  CHECK(banded.bands() == (TFT_H + bandH - 1) / bandH);
+  banded.setRotation(rotation);
+
+  long mismatches = 0;
+  uint16_t *previous = nullptr;
+  for (uint16_t band = 0; band < banded.bands(); band++) {
+    CHECK(banded.isDirty(band));
+    banded.selectBand(band);
+    // the strip not used by the previous band, that one may still be in transfer
+    CHECK(banded.getBuffer() != previous || banded.bands() == 1);
+    previous = banded.getBuffer();
+    scene(banded);
+    banded.clearDirty(band);
+    CHECK(!banded.isDirty(band));
+
+    CHECK(banded.bandY() == band * bandH);
+    CHECK(banded.bandHeight() == (band + 1 < banded.bands() ? bandH : TFT_H - band * bandH));
+    for (int y = 0; y < banded.bandHeight(); y++) {
+      for (int x = 0; x < TFT_W; x++) {
+        // bands are in display byte order
+        uint16_t pixel = __builtin_bswap16(banded.getBuffer()[y * TFT_W + x]);
+        mismatches += pixel != ref.getBuffer()[(banded.bandY() + y) * TFT_W + x];
+      }
+    }
+  }
+  if (mismatches) {
+    printf("rotation %u, band height %u: %ld pixels differ\n", rotation, bandH, mismatches);
+  }
+  CHECK(mismatches == 0);
+}
+
+// the bands marked for a rectangle are exactly those its pixels land in
+static void checkDirty(uint8_t rotation, uint16_t bandH, int16_t x, int16_t y, int16_t w, int16_t h) {
+  GFXcanvas16 ref(TFT_W, TFT_H);
+  ref.setRotation(rotation);
+  ref.fillRect(x, y, w, h, 0xFFFF);
+
+  // a new canvas has every band dirty, it was never sent
+  GFXcanvasBanded16 banded(TFT_W, TFT_H, bandH);
+  for (uint16_t band = 0; band < banded.bands(); band++) {
+    CHECK(banded.isDirty(band));
+    banded.clearDirty(band);
+  }
+  banded.setRotation(rotation);
+  banded.markDirty(x, y, w, h);
+  for (uint16_t band = 0; band < banded.bands(); band++) {
+    bool touched = false;
+    for (int row = band * bandH; row < (band + 1) * bandH && row < TFT_H; row++) {
+      for (int col = 0; col < TFT_W; col++) {
+        touched |= ref.getBuffer()[row * TFT_W + col] != 0;
+      }
+    }
+    if (touched != banded.isDirty(band)) {
+      printf("rotation %u, band height %u, rect %d,%d %dx%d: band %u\n", rotation, bandH, x, y, w, h, band);
+    }
+    CHECK(touched == banded.isDirty(band));
+  }
+}
+
+int main() {
+  const uint16_t bandHeights[] = {1, 7, 16, 33, 160, 200};
+
+  for (uint8_t rotation = 0; rotation < 4; rotation++) {
+    for (uint16_t bandH : bandHeights) {
+      checkBands(rotation, bandH);
+      checkDirty(rotation, bandH, 20, 30, 5, 4);
+      checkDirty(rotation, bandH, 0, 0, 1, 1);
+      checkDirty(rotation, bandH, -5, 15, 40, 100);
+      checkDirty(rotation, bandH, 100, 120, 100, 100);
+    }
+  }
+
+  return check_result();
+}
@@ -0,0 +1,147 @@
+/*
+ * main/event_detector.c on a committed sample trace and on short made up
+ * sequences: the start and end of every event in the trace, that a bump
+ * below h_on and a slow drift do not start one, and the exact sample an
+ * event ends with after hold quiet samples, also when the score comes
+ * back above h_off in between.
+ */
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "event_detector.h"
+#include "check.h"
+
+struct Event {
+  unsigned long timestampMs;
+  std::string channel;
+  evd_result_t result;
+
+  bool operator==(const Event &other) const {
+    return timestampMs == other.timestampMs && channel == other.channel && result == other.result;
+  }
+};
+
+// the events of a trace in the format of tools/telemetry_client.py, as tools/replay_events.c finds them
+static std::vector<Event> replay(const char *path) {
+  std::ifstream in(path);
+  CHECK(in.good());
+  evd_config_t config = evd_default_config();
+  std::map<std::string, evd_state_t> detectors;
+  std::vector<Event> events;
+  std::string line;
+  while (std::getline(in, line)) {
+    std::istringstream fields(line);
+    unsigned long timestampMs;
+    std::string channel;
+    float value;
+    if (line[0] == '#' || !(fields >> timestampMs >> channel >> value)) {
+      continue;
+    }
+    if (!detectors.count(channel)) {
+      evd_init(&detectors[channel], &config);
+    }
+    evd_result_t result = evd_update(&detectors[channel], value);
+    if (result != EVD_NONE) {
+      events.push_back({timestampMs, channel, result});
+    }
+  }
+  return events;
+}
+
+// a detector past the warm-up on a flat 0, so sigma is min_sigma and every sample at the baseline takes k off the score
+static evd_state_t learned(const evd_config_t &config) {
+  evd_state_t state;
+  evd_init(&state, &config);
+  for (int i = 0; i < config.warmup; i++) {
+    CHECK(evd_update(&state, 0) == EVD_NONE);
+  }
+  return state;
+}
+
+// samples of value until the detector ends the event, 0 if it did not within limit
+static int samplesToEnd(evd_state_t &state, float value, int limit = 1000) {
+  for (int n = 1; n <= limit; n++) {
+    evd_result_t result = evd_update(&state, value);
+    CHECK(result != EVD_START);
+    if (result == EVD_END) {
+      return n;
+    }
+  }
+  return 0;
+}
+
+int main() {
+  evd_config_t config = evd_default_config();
+
+  // LPG puff from 15 s held until 20 s and decaying with 1 s: it starts with the first
+  // rising sample, the decay falls within k sigma of the baseline at about 26 s, then the
+  // capped score needs (h_on - h_off) / k = 12 samples to drop below h_off and hold 10
+  // more. The 2 s puff at 40 s ends 12 + 10 samples after it. The bump at 32 s adds
+  // about 7.5 to the score, less than h_on, and the drift of CO stays within k.
+  std::vector<Event> events = replay("data/event_trace.txt");
+  std::vector<Event> expected = {
+    {15100, "lpg", EVD_START},
+    {29000, "lpg", EVD_END},
+    {40000, "lpg", EVD_START},
+    {44000, "lpg", EVD_END},
+  };
+  CHECK(events == expected);
+  for (const Event &event : events) {
+    printf("%lu %s %s\n", event.timestampMs, event.channel.c_str(), event.result == EVD_START ? "start" : "end");
+  }
+
+  // a step starts an event with the first sample, the baseline stays where it was
+  evd_state_t state = learned(config);
+  CHECK(evd_update(&state, 20) == EVD_START);
+  CHECK(state.active);
+  CHECK_NEAR(state.score, 20 - config.k, 1e-5);
+  float baseline = state.mean;
+  for (int i = 0; i < 50; i++) {
+    CHECK(evd_update(&state, 20) == EVD_NONE);
+  }
+  CHECK(state.mean == baseline);
+  CHECK_NEAR(state.peak, 20, 1e-5);
+  // the score was capped at h_on: 13 samples at the baseline bring it below h_off, the 10th quiet one ends the event
+  CHECK_NEAR(state.score, config.h_on, 1e-5);
+  int quietFrom = (int)((config.h_on - config.h_off) / config.k) + 1;
+  CHECK(samplesToEnd(state, 0) == quietFrom + config.hold - 1);
+  CHECK(!state.active);
+  CHECK(state.score == 0);
+
+  // one sample back above h_off just before the end starts the hold over
+  state = learned(config);
+  CHECK(evd_update(&state, 20) == EVD_START);
+  CHECK(evd_update(&state, 20) == EVD_NONE);
+  for (int i = 0; i < quietFrom + config.hold - 2; i++) {
+    CHECK(evd_update(&state, 0) == EVD_NONE);
+  }
+  CHECK(state.quiet == config.hold - 1);
+  CHECK(evd_update(&state, config.h_off + 2 * config.k) == EVD_NONE);
+  CHECK(state.quiet == 0 && state.active);
+  // from h_off + k: one more sample at h_off, then below it
+  CHECK(samplesToEnd(state, 0) == 2 + config.hold - 1);
+
+  // a score between h_off and h_on neither starts an event nor stays high
+  state = learned(config);
+  for (int i = 0; i < 3; i++) {
+    CHECK(evd_update(&state, 3) == EVD_NONE);
+  }
+  CHECK(state.score > config.h_off && state.score < config.h_on);
+  for (int i = 0; i < 100; i++) {
+    CHECK(evd_update(&state, 0) == EVD_NONE);
+  }
+  CHECK(state.score == 0 && !state.active);
+
+  // after an event the baseline follows the signal again
+  state = learned(config);
+  CHECK(evd_update(&state, 20) == EVD_START);
+  CHECK(samplesToEnd(state, 0) > 0);
+  for (int i = 0; i < 10; i++) {
+    evd_update(&state, 0.5f);
+  }
+  CHECK(state.mean > 0.05f);
+
+  return check_result();
+}
@@ -0,0 +1,76 @@
+/*
+ * Accuracy of the constexpr gas curve tables of MQ2Curves.h against the
+ * log()/pow() formula they replace, and a benchmark of both.
+ */
+#include <math.h>
+#include <chrono>
+#include "MQ2Curves.h"
+#include "check.h"
+
+struct Gas {
+  const char *name;
+  const MQ2Curve &curve;
+  const MQ2CurveTable &table;
+};
+
+static const Gas gases[] = {
+  {"LPG", LPGCurve, LPGTable},
+  {"CO", COCurve, COTable},
+  {"smoke", SmokeCurve, SmokeTable},
+};
+
+static double formula(double rs_ro_ratio, const MQ2Curve &curve) {
+  return pow(10, (((log(rs_ro_ratio) - curve.y) / curve.slope) + curve.x));
+}
+
+// the conversion of the original driver, truncated to int
+static int formulaInt(float rs_ro_ratio, const MQ2Curve &curve) {
+  return (int)formula(rs_ro_ratio, curve);
+}
+
+static void checkAccuracy(const Gas &gas) {
+  const float lo = 1.0f / 16, hi = 16.0f;
+  double maxError = 0;
+
+  for (float ratio = lo; ratio <= hi; ratio *= 1.0003f) {
+    double expected = formula(ratio, gas.curve);
+    double error = fabs(gas.table.lookup(ratio) / expected - 1);
+    maxError = fmax(maxError, error);
+  }
+  // linear interpolation over 1/32 of an octave, worst for the steep CO curve
+  CHECK(maxError < 7e-3);
+  printf("%-5s max relative error %.2e\n", gas.name, maxError);
+
+  // clamped to the table ends outside of [1/16, 16]
+  CHECK(gas.table.lookup(lo / 4) == gas.table.lookup(lo));
+  CHECK(gas.table.lookup(hi * 4) == gas.table.lookup(hi));
+  CHECK(gas.table.lookup(0) == gas.table.lookup(lo));
+
+  // ppm falls with a rising ratio
+  for (int i = 1; i < MQ2CurveTable::SIZE; i++) {
+    CHECK(gas.table[i] < gas.table[i - 1]);
+  }
+}
+
+template<typename F> static double nsPerCall(F f, int calls) {
+  volatile float sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < calls; i++) {
+    sink = sink + f(0.1f + i * (15.0f / calls));
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() / calls;
+}
+
+int main() {
+  for (const Gas &gas : gases) {
+    checkAccuracy(gas);
+  }
+
+  const int calls = 2000000;
+  printf("table lookup      %6.1f ns\n", nsPerCall([](float r) { return LPGTable.lookup(r); }, calls));
+  printf("Q16.16 lookup     %6.1f ns\n", nsPerCall([](float r) { return (float)LPGTable.lookupQ16((uint32_t)(r * 65536)); }, calls));
+  printf("log()/pow()       %6.1f ns\n", nsPerCall([](float r) { return (float)formulaInt(r, LPGCurve); }, calls));
+
+  return check_result();
+}
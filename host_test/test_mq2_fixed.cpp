@@ -0,0 +1,103 @@
+/*
+ * The Q16.16 kernel of MQ2Fixed.h and the integer curve lookup against a
+ * double precision reference, for the board's kernel and for other ADC
+ * resolutions and load resistors.
+ */
+#include <math.h>
+#include "MQ2Curves.h"
+#include "MQ2Fixed.h"
+#include "check.h"
+
+#define Q16 65536.0
+#define PPM_MAX (0xFFFFFFFFu / Q16)
+
+static double refPpm(double ratio, const MQ2Curve &curve) {
+  return pow(10, ((log(ratio) - curve.y) / curve.slope) + curve.x);
+}
+
+template<unsigned ADC_BITS, uint32_t RL_OHMS> static void checkKernel() {
+  typedef MQ2FixedKernel<ADC_BITS, RL_OHMS> K;
+  const double adcMax = (1u << ADC_BITS) - 1;
+  const double rl = RL_OHMS / 1000.0;
+
+  // Rs for every raw value, 0 counts as 1 and values above the maximum as the maximum
+  for (uint32_t raw = 0; raw <= K::ADC_MAX + 16; raw++) {
+    double r = fmin(fmax(raw, 1), adcMax);
+    CHECK_NEAR(K::rs(raw) / Q16, rl * (adcMax - r) / r, 1 / Q16);
+  }
+
+  for (double ro = 0.5; ro < 200; ro *= 1.37) {
+    uint32_t roQ16 = K::fromFloat(ro);
+    uint32_t invRo = K::inverse(roQ16);
+    for (uint32_t raw = 1; raw < K::ADC_MAX; raw += K::ADC_MAX / 97) {
+      uint32_t rs = K::rs(raw);
+      double ratio = (rs / Q16) / (roQ16 / Q16);
+      // the reciprocal has 24 fractional bits, the ratio 16
+      if (ratio < 32768) {
+        CHECK_NEAR(K::ratio(rs, invRo) / Q16, ratio, ratio * 1e-5 + 2 / Q16);
+      }
+    }
+    CHECK_NEAR(K::toFloat(roQ16), ro, 1 / Q16);
+    CHECK_NEAR(K::ro(K::fromFloat(ro * 9.83), K::fromFloat(9.83)) / Q16, ro, ro * 1e-5 + 2 / Q16);
+  }
+}
+
+/*
+ * lookupQ16() for every ratio from 1/16 to 16 in Q16.16 steps, it has to
+ * follow the formula clamped at PPM_MAX and must never rise with the ratio.
+ */
+static void checkLookup(const char *name, const MQ2Curve &curve, const MQ2CurveTable &table) {
+  uint32_t previous = 0xFFFFFFFFu;
+  double maxError = 0, edgeError = 0;
+
+  for (uint32_t ratio = 1 << 12; ratio <= 1 << 20; ratio++) {
+    uint32_t ppm = table.lookupQ16(ratio);
+    CHECK(ppm <= previous);
+    previous = ppm;
+
+    double expected = fmin(refPpm(ratio / Q16, curve), PPM_MAX);
+    double error = fabs(ppm / Q16 - expected) / expected;
+    // 0.7% of the table interpolation, plus the Q16.16 steps of small values
+    if (error > 7e-3 && fabs(ppm / Q16 - expected) > 2 / Q16) {
+      CHECK_NEAR(ppm / Q16, expected, expected * 7e-3);
+    }
+    maxError = fmax(maxError, expected > 1 ? error : 0);
+    if (expected > PPM_MAX / 2 && expected < PPM_MAX) {
+      edgeError = fmax(edgeError, error);
+    }
+  }
+  printf("%-5s max relative error %.2e, %.2e next to the saturation\n", name, maxError, edgeError);
+  CHECK(table.lookupQ16(0) == table.lookupQ16(1 << 12));
+  CHECK(table.lookupQ16(0xFFFFFFFFu) == table.lookupQ16(1 << 20));
+}
+
+/*
+ * Where ppm crosses 65535.99, the result has to be saturated exactly when
+ * the formula is beyond it, up to the interpolation error.
+ */
+static void checkSaturation(const MQ2Curve &curve, const MQ2CurveTable &table) {
+  double crossing = exp(curve.slope * (log10(PPM_MAX) - curve.x) + curve.y);
+  if (crossing < 1.0 / 16) {
+    return;
+  }
+  uint32_t crossingQ16 = (uint32_t)(crossing * Q16);
+  CHECK(table.lookupQ16(crossingQ16 - crossingQ16 / 100) == 0xFFFFFFFFu);
+  CHECK(table.lookupQ16(crossingQ16 + crossingQ16 / 100) < 0xFFFFFFFFu);
+  CHECK_NEAR(table.lookupQ16(crossingQ16 + crossingQ16 / 100) / Q16, refPpm((crossingQ16 + crossingQ16 / 100) / Q16, curve), PPM_MAX * 7e-3);
+}
+
+int main() {
+  checkKernel<12, 5000>();
+  checkKernel<10, 1000>();
+  checkKernel<12, 10000>();
+  checkKernel<8, 20000>();
+
+  checkLookup("LPG", LPGCurve, LPGTable);
+  checkLookup("CO", COCurve, COTable);
+  checkLookup("smoke", SmokeCurve, SmokeTable);
+  checkSaturation(LPGCurve, LPGTable);
+  checkSaturation(COCurve, COTable);
+  checkSaturation(SmokeCurve, SmokeTable);
+
+  return check_result();
+}
@@ -0,0 +1,199 @@
+/*
+ * Replays recorded ADC frame averages through MQ2::beginContinuous() and
+ * update() and compares every window with the datasheet formula evaluated
+ * in double precision.
+ *
+ * The ADC driver is replaced by a pool of two frames like the one of
+ * esp32-hal-adc.c: a frame that finds the pool full is dropped, but the
+ * interrupt callback still runs for it.
+ */
+#include <math.h>
+#include <deque>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "Arduino.h"
+#include "MQ2.h"
+#include "check.h"
+
+#define ADC_HZ 20000
+#define FRAME_MS (MQ2_FRAME_CONVERSIONS * 1000 / ADC_HZ)
+#define WINDOW_FRAMES 4
+#define BASELINE_FRAMES (1000 / FRAME_MS)
+#define DRIVER_POOL_FRAMES 2
+
+static void (*frameCallback)(void);
+static std::deque<int> pool;
+static adc_continuous_data_t readResult;
+static unsigned framesDropped;
+// LPG of the first window and the highest LPG of the last replay
+static double lpgClean, lpgPeak;
+
+bool analogContinuous(const uint8_t pins[], size_t pins_count, uint32_t conversions_per_pin, uint32_t sampling_freq_hz, void (*userFunc)(void)) {
+  frameCallback = userFunc;
+  pool.clear();
+  framesDropped = 0;
+  readResult.pin = pins[0];
+  return pins_count == 1 && conversions_per_pin == MQ2_FRAME_CONVERSIONS && sampling_freq_hz == ADC_HZ;
+}
+
+bool analogContinuousRead(adc_continuous_data_t **buffer, uint32_t timeout_ms) {
+  if (pool.empty()) {
+    return false;
+  }
+  readResult.avg_read_raw = pool.front();
+  pool.pop_front();
+  *buffer = &readResult;
+  return true;
+}
+
+bool analogContinuousStart() {
+  return true;
+}
+bool analogContinuousStop() {
+  return true;
+}
+bool analogContinuousDeinit() {
+  return true;
+}
+void analogContinuousSetWidth(uint8_t bits) {}
+uint16_t analogRead(uint8_t pin) {
+  return 0;
+}
+
+static void adcFrameDone(int raw) {
+  if (pool.size() < DRIVER_POOL_FRAMES) {
+    pool.push_back(raw);
+  } else {
+    framesDropped++;
+  }
+  frameCallback();
+}
+
+static std::vector<int> loadTrace(const char *path) {
+  std::vector<int> frames;
+  std::ifstream in(path);
+  std::string line;
+  while (std::getline(in, line)) {
+    if (!line.empty() && line[0] != '#') {
+      frames.push_back(std::stoi(line));
+    }
+  }
+  return frames;
+}
+
+// Rs in kilo ohms and ppm as in the original floating point driver
+static double refRs(double raw) {
+  return MQ2_RL_OHMS / 1000.0 * (4095 - raw) / raw;
+}
+
+static double refPpm(double ratio, const MQ2Curve &curve) {
+  return pow(10, ((log(ratio) - curve.y) / curve.slope) + curve.x);
+}
+
+// Ro estimate of the reference, same rules as MQ2::MQTrackBaseline()
+static double refTrackBaseline(double ro, double rs) {
+  double target = rs / 9.83;
+  if (target > ro) {
+    return ro + (target - ro) / 8;
+  }
+  if (target > ro - ro / 8) {
+    return ro - (ro - target) / 256;
+  }
+  return ro;
+}
+
+static void checkPpm(double ppm, double expected) {
+  CHECK_NEAR(ppm, expected, expected * 0.01 + 2.0 / 65536);
+}
+
+/*
+ * Runs the trace with update() called every poll_ms and returns the number
+ * of windows that were completed.
+ */
+static unsigned replay(const std::vector<int> &trace, unsigned poll_ms, bool compare) {
+  MQ2 mq2(34);
+  CHECK(mq2.beginContinuous(ADC_HZ, WINDOW_FRAMES));
+
+  double ro = 0;
+  double windowSum = 0, baselineSum = 0;
+  unsigned baselineCount = 0, windows = 0;
+  size_t next = 0;
+  lpgClean = 0;
+  lpgPeak = 0;
+
+  for (unsigned ms = 1; next < trace.size() || !pool.empty(); ms++) {
+    if (ms % FRAME_MS == 0 && next < trace.size()) {
+      adcFrameDone(trace[next++]);
+    }
+    if (ms % poll_ms != 0 || !mq2.update()) {
+      continue;
+    }
+    windows++;
+    if (!compare) {
+      continue;
+    }
+    // the reference consumes the same frames, the window is evaluated
+    // before the baseline step of its last frame like in update()
+    double ratio = 0;
+    for (unsigned i = 0; i < WINDOW_FRAMES; i++) {
+      int raw = trace[(windows - 1) * WINDOW_FRAMES + i];
+      windowSum += raw;
+      baselineSum += raw;
+      if (i == WINDOW_FRAMES - 1) {
+        double rs = refRs(windowSum / WINDOW_FRAMES);
+        windowSum = 0;
+        if (ro == 0) {
+          ro = rs / 9.83;
+        }
+        ratio = rs / ro;
+      }
+      if (++baselineCount == BASELINE_FRAMES) {
+        ro = refTrackBaseline(ro, refRs(baselineSum / baselineCount));
+        baselineSum = 0;
+        baselineCount = 0;
+      }
+    }
+    float *ppm = mq2.read(false);
+    CHECK_NEAR(mq2.getRo(), ro, ro * 0.005);
+    checkPpm(ppm[0], refPpm(ratio, LPGCurve));
+    checkPpm(ppm[1], refPpm(ratio, COCurve));
+    checkPpm(ppm[2], refPpm(ratio, SmokeCurve));
+    if (windows == 1) {
+      lpgClean = ppm[0];
+    }
+    lpgPeak = fmax(lpgPeak, ppm[0]);
+  }
+  mq2.endContinuous();
+  return windows;
+}
+
+int main() {
+  std::vector<int> trace = loadTrace("data/mq2_lpg_puff.txt");
+  CHECK(trace.size() >= 2 * BASELINE_FRAMES);
+  trace.resize(trace.size() / WINDOW_FRAMES * WINDOW_FRAMES);
+
+  // polled faster than frames arrive, as the sensor scheduler does
+  unsigned windows = replay(trace, 20, true);
+  CHECK(framesDropped == 0);
+  CHECK(windows == trace.size() / WINDOW_FRAMES);
+  // the puff has to stand out clearly against the clean air at the start
+  CHECK(lpgPeak > 100 * lpgClean);
+  printf("%u frames, %u windows, %u dropped\n", (unsigned)trace.size(), windows, framesDropped);
+
+  // the clean air part followed by cleaner air, Ro has to rise with it
+  std::vector<int> cleaner(trace.begin(), trace.begin() + 20 * BASELINE_FRAMES);
+  for (int i = 0; i < 20 * BASELINE_FRAMES; i++) {
+    cleaner.push_back(trace[i] - 40);
+  }
+  windows = replay(cleaner, 20, true);
+  CHECK(windows == cleaner.size() / WINDOW_FRAMES);
+
+  // polled too slowly the driver drops frames, update() only reads the kept ones
+  windows = replay(trace, 60, false);
+  CHECK(framesDropped > 0);
+  CHECK(windows == (trace.size() - framesDropped) / WINDOW_FRAMES);
+  printf("polled every 60 ms: %u windows, %u dropped\n", windows, framesDropped);
+
+  return check_result();
+}
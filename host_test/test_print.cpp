@@ -0,0 +1,196 @@
+/*
+ * Print::printf() of Print.cpp against snprintf() of the C library: every
+ * conversion has to give the same text and the same count, including the
+ * ones longer than the stack buffer. The benchmark compares it with the
+ * previous implementation, which formatted the whole line into a buffer.
+ * On the host vprintf() formats into a glibc fopencookie() stream, which
+ * costs one allocation per call, the newlib stream of the target is on
+ * the stack.
+ */
+#include <chrono>
+#include <string>
+#include "Arduino.h"
+#include "check.h"
+
+#ifdef __GLIBC__
+// counts the heap allocations of the benchmark
+static size_t mallocs = 0;
+extern "C" void *__libc_malloc(size_t size);
+void *malloc(size_t size) {
+  mallocs++;
+  return __libc_malloc(size);
+}
+#endif
+
+class Sink : public Print {
+public:
+  size_t write(uint8_t c) override {
+    text += (char)c;
+    writes++;
+    return 1;
+  }
+  size_t write(const uint8_t *buffer, size_t size) override {
+    text.append((const char *)buffer, size);
+    writes++;
+    return size;
+  }
+  using Print::write;
+
+  std::string text;
+  size_t writes = 0;
+};
+
+// previous implementation: the whole line through vsnprintf, on the heap if it is longer than 64 characters
+static size_t old_vprintf(Print &p, const char *format, va_list arg) {
+  char loc_buf[64];
+  char *temp = loc_buf;
+  va_list copy;
+  va_copy(copy, arg);
+  int len = vsnprintf(temp, sizeof(loc_buf), format, copy);
+  va_end(copy);
+  if (len < 0) {
+    return 0;
+  }
+  if (len >= (int)sizeof(loc_buf)) {
+    temp = (char *)malloc(len + 1);
+    if (temp == NULL) {
+      return 0;
+    }
+    len = vsnprintf(temp, len + 1, format, arg);
+  }
+  len = p.write((uint8_t *)temp, len);
+  if (temp != loc_buf) {
+    free(temp);
+  }
+  return len;
+}
+
+static size_t old_printf(Print &p, const char *format, ...) {
+  va_list arg;
+  va_start(arg, format);
+  size_t len = old_vprintf(p, format, arg);
+  va_end(arg);
+  return len;
+}
+
+// Print::printf() gives what snprintf() gives
+#define CHECK_PRINTF(...)                                                             \
+  do {                                                                                \
+    Sink sink;                                                                        \
+    char expected[2048];                                                              \
+    int expected_len = snprintf(expected, sizeof(expected), __VA_ARGS__);             \
+    size_t len = sink.printf(__VA_ARGS__);                                            \
+    if (sink.text != std::string(expected, expected_len) || (int)len != expected_len) { \
+      check_failures++;                                                               \
+      printf("%s:%d: printf(%s)\n  gives    [%s] %zu\n  expected [%s] %d\n", __FILE__, __LINE__, #__VA_ARGS__, \
+             sink.text.c_str(), len, expected, expected_len);                         \
+    }                                                                                 \
+  } while (0)
+
+int main() {
+  CHECK_PRINTF("plain text");
+  CHECK_PRINTF("%d %i %u %x %X %o", -42, 17, 3000000000u, 255, 255, 8);
+  CHECK_PRINTF("[%5d][%-5d][%05d][%+d][% d][%+05d][%-+5d]", 42, 42, -42, 42, 42, 42, 42);
+  CHECK_PRINTF("[%.3d][%8.3d][%08.3d][%#x][%#08x][%#o][%#X]", 7, -7, 7, 255, 255, 8, 0xabc);
+  CHECK_PRINTF("[%ld][%lu][%lld][%llu][%llx][%hd][%hhu][%zu][%zd]", -5L, 5UL, -1234567890123LL, 18446744073709551615ULL,
+               0xdeadbeefcafeULL, (short)-3, (unsigned char)200, (size_t)77, (ssize_t)-77);
+  CHECK_PRINTF("[%d][%d][%ld][%lld][%hd][%hhd][%hu][%hhx][%zd][%i]", -2147483647 - 1, 0, -2147483647L - 1,
+               -9223372036854775807LL - 1, 40000, 200, 70000, 0x1ff, (ssize_t)-5, 12);
+  CHECK_PRINTF("[%x][%X][%o][%lx][%llX][%u][%lu]", 0xdeadbeefu, 0xabcu, 0777u, 0x12345678UL, 0xfedcba9876543210ULL, 4294967295u,
+               4294967295UL);
+  CHECK_PRINTF("[%f][%.2f][%10.3f][%-10.1f][%010.2f][%+.1f][%e][%E][%g][%G][%a]", 3.14159, 2.5, -1.0 / 3, 9.99, -3.5, 2.0, 12345.678,
+               0.000123, 1e-5, 1e20, 1.0);
+  CHECK_PRINTF("[%Lf][%.3Le]", (long double)1.5, (long double)12345.0);
+  CHECK_PRINTF("[%s][%10s][%-10s][%.3s][%10.2s][%s]", "abc", "abc", "abc", "abcdef", "abcdef", "");
+  CHECK_PRINTF("[%c][%3c][%-3c]", 'x', 'y', 'z');
+  CHECK_PRINTF("[%*d][%-*d][%*d][%.*f][%.*s]", 6, 42, 6, 42, -6, 42, 3, 1.23456, 2, "xyz");
+  CHECK_PRINTF("100%% done %d%%", 5);
+  CHECK_PRINTF("[%p]", (void *)0x1234);
+  CHECK_PRINTF("LPG:%.2fppm    CO:%.2fppm    SMOKE:%.2fppm\n", 12.3456, 7.0, 101.5);
+
+  // conversions longer than the stack buffer
+  CHECK_PRINTF("[%f][%.0f][%#.0f]", 1e60, 2.5, 2.0);
+  CHECK_PRINTF("[%.70f]", 1.0 / 3);
+  CHECK_PRINTF("[%0200.150f]", 1.0 / 7);
+  CHECK_PRINTF("[%100d]", 5);
+  CHECK_PRINTF("[%.70d][%.70lld][%80.70x][%-80.70u]", 1, -5LL, 0xabu, 7u);
+  CHECK_PRINTF("%s", std::string(300, 'q').c_str());
+
+  // inf and nan are padded with spaces even with the 0 flag
+  CHECK_PRINTF("[%010f][%010f][%010e][%010g][%-010f][%010f]", INFINITY, -INFINITY, INFINITY, -INFINITY, INFINITY, NAN);
+  CHECK_PRINTF("[%010Lf][%+010.2f]", (long double)INFINITY, -NAN);
+
+  {
+    Sink sink;
+    int count = 0;
+    sink.printf("abc%n def", &count);
+    CHECK(count == 3);
+    CHECK(sink.text == "abc def");
+  }
+
+  // typed print
+  {
+    Sink sink;
+    float lpg = 12.3456f;
+    int co = 7;
+    sink.print("LPG:{}ppm CO:{} {{x}} {}\n", lpg, co, "end");
+    CHECK(sink.text == "LPG:12.35ppm CO:7 {x} end\n");
+  }
+  {
+    Sink sink;
+    String str("S");
+    unsigned long ul = 4000000000UL;
+    sink.print("{}{}{}{}", str, ul, 'c', 1.5);
+    CHECK(sink.text == "S4000000000c1.50");
+  }
+
+  const int lines = 200000;
+  double lpg = 12.3456, co = 7.25, smoke = 101.5;
+  const char *names[] = {"old vprintf", "new vprintf", "typed print", "separate prints", "old long ints", "new long ints", "old short", "new short"};
+  for (int variant = 0; variant < 8; variant++) {
+    Sink sink;
+    sink.text.reserve(1 << 20);
+#ifdef __GLIBC__
+    mallocs = 0;
+#endif
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < lines; i++) {
+      if (sink.text.size() > 1000000) {
+        sink.text.clear();
+      }
+      switch (variant) {
+        case 0: old_printf(sink, "LPG:%.2fppm    CO:%.2fppm    SMOKE:%.2fppm  t=%lu ms\n", lpg, co, smoke, (unsigned long)i); break;
+        case 1: sink.printf("LPG:%.2fppm    CO:%.2fppm    SMOKE:%.2fppm  t=%lu ms\n", lpg, co, smoke, (unsigned long)i); break;
+        case 2: sink.print("LPG:{}ppm    CO:{}ppm    SMOKE:{}ppm  t={} ms\n", lpg, co, smoke, (unsigned long)i); break;
+        case 3:
+          sink.print("LPG:");
+          sink.print(lpg);
+          sink.print("ppm    CO:");
+          sink.print(co);
+          sink.print("ppm    SMOKE:");
+          sink.print(smoke);
+          sink.print("ppm  t=");
+          sink.print((unsigned long)i);
+          sink.print(" ms\n");
+          break;
+        case 4:
+          old_printf(sink, "[%lu] heap %u free, largest %u, wifi rssi %d dBm, clients %d, uptime %lu s\n", (unsigned long)i, 123456u, 65536u,
+                     -67, 2, (unsigned long)i / 10);
+          break;
+        case 5:
+          sink.printf("[%lu] heap %u free, largest %u, wifi rssi %d dBm, clients %d, uptime %lu s\n", (unsigned long)i, 123456u, 65536u, -67,
+                      2, (unsigned long)i / 10);
+          break;
+        case 6: old_printf(sink, "%s %d\n", "short", i); break;
+        case 7: sink.printf("%s %d\n", "short", i); break;
+      }
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / lines;
+#ifdef __GLIBC__
+    printf("%-16s %6.0f ns/line, %.2f mallocs/line, %.2f writes/line\n", names[variant], ns, (double)mallocs / lines, (double)sink.writes / lines);
+#else
+    printf("%-16s %6.0f ns/line, %.2f writes/line\n", names[variant], ns, (double)sink.writes / lines);
+#endif
+  }
+  return check_result();
+}
@@ -0,0 +1,245 @@
+/*
+ * SerialFrameReceiver.cpp on a simulated byte stream: the bytes arrive in
+ * chunks of random size, as from the UART driver, and writeSpan()/commit()
+ * have to hand out every frame once, in order and unchanged. Covers a
+ * delimiter and a binary parser with garbage between frames, a line longer
+ * than a buffer, and frames held by the application while all buffers are
+ * handed out, in the same task and from another thread.
+ */
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <string.h>
+#include "SerialFrameReceiver.h"
+#include "check.h"
+
+static std::mt19937 rng(1);
+
+// feeds in to the receiver in chunks of 1..maxChunk bytes, false if writeSpan() stayed empty
+static bool feed(SerialFrameReceiver &receiver, const std::string &in, size_t maxChunk) {
+  size_t pos = 0;
+  while (pos < in.size()) {
+    uint8_t *data;
+    size_t room = receiver.writeSpan(&data);
+    if (room == 0) {
+      return false;
+    }
+    size_t n = std::min<size_t>({room, in.size() - pos, 1 + rng() % maxChunk});
+    memcpy(data, in.data() + pos, n);
+    pos += n;
+    receiver.commit(n);
+  }
+  return true;
+}
+
+// MH-Z19 style answer: 0xFF 0x86, six bytes and a checksum
+static int ndirParser(const uint8_t *data, size_t len) {
+  if (data[0] != 0xFF) {
+    const uint8_t *start = (const uint8_t *)memchr(data, 0xFF, len);
+    return start ? -(int)(start - data) : -(int)len;
+  }
+  if (len < 9) {
+    return 0;
+  }
+  uint8_t sum = 0;
+  for (int i = 1; i < 8; i++) {
+    sum += data[i];
+  }
+  return (uint8_t)(0xFF - sum + 1) == data[8] ? 9 : -1;
+}
+
+static std::string ndirFrame(int i) {
+  uint8_t frame[9] = {0xFF, 0x86, (uint8_t)i, (uint8_t)(i >> 8), 1, 2, 3, 4, 0};
+  uint8_t sum = 0;
+  for (int k = 1; k < 8; k++) {
+    sum += frame[k];
+  }
+  frame[8] = 0xFF - sum + 1;
+  return std::string((const char *)frame, sizeof(frame));
+}
+
+int main() {
+  // lines, released right away
+  {
+    SerialFrameReceiver receiver;
+    std::vector<std::string> got;
+    CHECK(receiver.begin(16, 2, SerialFrameReceiver::delimiter('\n'), [&](SerialFrame *frame) {
+      got.emplace_back((const char *)frame->data, frame->length);
+      receiver.release(frame);
+    }));
+    std::string in;
+    std::vector<std::string> expected;
+    for (int i = 0; i < 1000; i++) {
+      expected.push_back(std::string(rng() % 14, 'a' + i % 26) + "\n");
+      in += expected.back();
+    }
+    CHECK(feed(receiver, in, 20));
+    CHECK(got == expected);
+    CHECK(receiver.dropped() == 0);
+    CHECK(receiver.frames() == 1000);
+  }
+
+  // binary frames with garbage in between, the garbage is dropped
+  {
+    SerialFrameReceiver receiver;
+    std::vector<std::string> got;
+    receiver.begin(32, 3, ndirParser, [&](SerialFrame *frame) {
+      got.emplace_back((const char *)frame->data, frame->length);
+      receiver.release(frame);
+    });
+    std::string in;
+    std::vector<std::string> expected;
+    size_t garbage = 0;
+    for (int i = 0; i < 500; i++) {
+      for (int n = rng() % 4; n > 0; n--, garbage++) {
+        in += (char)(rng() % 0xFE);
+      }
+      expected.push_back(ndirFrame(i));
+      in += expected.back();
+    }
+    CHECK(feed(receiver, in, 40));
+    CHECK(got == expected);
+    CHECK(receiver.dropped() == garbage);
+  }
+
+  // a line longer than a buffer is dropped, the next one is received
+  {
+    SerialFrameReceiver receiver;
+    std::vector<std::string> got;
+    receiver.begin(8, 2, SerialFrameReceiver::delimiter('\n'), [&](SerialFrame *frame) {
+      got.emplace_back((const char *)frame->data, frame->length);
+      receiver.release(frame);
+    });
+    CHECK(feed(receiver, "0123456789abcdef\nok\n", 8));
+    CHECK(receiver.dropped() == 16);
+    CHECK(got.size() == 2 && got.back() == "ok\n");
+  }
+
+  // the application holds frames, the bytes wait until it releases them
+  {
+    SerialFrameReceiver receiver;
+    std::vector<std::string> got;
+    std::vector<SerialFrame *> held;
+    receiver.begin(32, 3, SerialFrameReceiver::delimiter('\n'), [&](SerialFrame *frame) {
+      got.emplace_back((const char *)frame->data, frame->length);
+      held.push_back(frame);
+    });
+    auto releaseAll = [&] {
+      for (SerialFrame *frame : held) {
+        receiver.release(frame);
+      }
+      held.clear();
+      if (receiver.waiting()) {
+        receiver.commit(0);
+      }
+    };
+    std::string in;
+    std::vector<std::string> expected;
+    for (int i = 0; i < 2000; i++) {
+      std::string line;
+      for (int n = rng() % 20; n > 0; n--) {
+        line += (char)('a' + rng() % 26);
+      }
+      expected.push_back(line + "\n");
+      in += expected.back();
+    }
+    size_t pos = 0;
+    size_t stalls = 0;
+    while (pos < in.size()) {
+      uint8_t *data;
+      size_t room = receiver.writeSpan(&data);
+      if (room == 0) {
+        CHECK(receiver.waiting() && held.size() == 2);
+        stalls++;
+        releaseAll();
+        continue;
+      }
+      size_t n = std::min<size_t>({room, in.size() - pos, 1 + rng() % 40});
+      memcpy(data, in.data() + pos, n);
+      pos += n;
+      receiver.commit(n);
+      if (rng() % 2) {
+        releaseAll();
+      }
+    }
+    releaseAll();
+    CHECK(stalls > 0);
+    CHECK(got == expected);
+    CHECK(receiver.dropped() == 0);
+  }
+
+  // frames released by another thread
+  {
+    SerialFrameReceiver receiver;
+    std::atomic<SerialFrame *> slots[4];
+    for (auto &slot : slots) {
+      slot = nullptr;
+    }
+    std::atomic<bool> done{false};
+    bool noSlot = false;
+    receiver.begin(12, 4, SerialFrameReceiver::delimiter(';'), [&](SerialFrame *frame) {
+      for (auto &slot : slots) {
+        SerialFrame *empty = nullptr;
+        if (slot.compare_exchange_strong(empty, frame)) {
+          return;
+        }
+      }
+      noSlot = true;
+    });
+    std::vector<std::string> seen;
+    std::thread consumer([&] {
+      for (;;) {
+        bool finished = done;
+        bool any = false;
+        for (auto &slot : slots) {
+          SerialFrame *frame = slot.exchange(nullptr);
+          if (frame) {
+            seen.emplace_back((const char *)frame->data, frame->length);
+            receiver.release(frame);
+            any = true;
+          }
+        }
+        if (!any && finished) {
+          break;
+        }
+        std::this_thread::yield();
+      }
+    });
+    std::string in;
+    std::vector<std::string> expected;
+    for (int i = 0; i < 20000; i++) {
+      expected.push_back(std::to_string(i) + ";");
+      in += expected.back();
+    }
+    size_t pos = 0;
+    while (pos < in.size()) {
+      uint8_t *data;
+      size_t room = receiver.writeSpan(&data);
+      if (room == 0) {
+        receiver.commit(0);
+        std::this_thread::yield();
+        continue;
+      }
+      size_t n = std::min<size_t>({room, in.size() - pos, 1 + rng() % 30});
+      memcpy(data, in.data() + pos, n);
+      pos += n;
+      receiver.commit(n);
+    }
+    while (receiver.waiting()) {
+      receiver.commit(0);
+      std::this_thread::yield();
+    }
+    done = true;
+    consumer.join();
+    CHECK(!noSlot);
+    // handed out in order, the consumer may pick them up in slot order
+    std::sort(seen.begin(), seen.end());
+    std::sort(expected.begin(), expected.end());
+    CHECK(seen == expected);
+    CHECK(receiver.dropped() == 0);
+  }
+  return check_result();
+}
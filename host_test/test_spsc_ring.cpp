@@ -0,0 +1,135 @@
+/*
+ * Two-thread stress test of SpscRing (spsc_ring.h) and the cbuf API on
+ * top of it. A producer thread writes a known byte sequence through
+ * write() and writeSpan()/commit() in random chunk sizes, the consumer
+ * reads it back through read(), readSpan()/consume() and peek() and
+ * checks every byte arrives once and in order.
+ */
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include "cbuf.h"
+#include "check.h"
+
+static uint8_t pattern(size_t i) {
+  return (uint8_t)(i * 2654435761u >> 13);
+}
+
+// next pseudo random number, each thread has its own state
+static unsigned next(unsigned &seed) {
+  seed = seed * 1103515245 + 12345;
+  return seed;
+}
+
+static void produce(SpscRing &ring, size_t total) {
+  size_t sent = 0;
+  unsigned seed = 1;
+  while (sent < total) {
+    unsigned r = next(seed);
+    size_t n;
+    if (r & 0x10000) {
+      uint8_t *data;
+      n = std::min({ring.writeSpan(&data), (size_t)(r >> 17) % 300, total - sent});
+      for (size_t i = 0; i < n; i++) {
+        data[i] = pattern(sent + i);
+      }
+      ring.commit(n);
+    } else {
+      uint8_t buf[256];
+      size_t want = std::min((size_t)(r >> 17) % sizeof(buf), total - sent);
+      for (size_t i = 0; i < want; i++) {
+        buf[i] = pattern(sent + i);
+      }
+      // what did not fit is generated again from sent
+      n = ring.write(buf, want);
+    }
+    sent += n;
+    if (n == 0) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+// takes all total bytes, returns the position of the first wrong one or total
+static size_t consume(SpscRing &ring, size_t total) {
+  size_t got = 0, error = total;
+  unsigned seed = 7;
+  while (got < total) {
+    unsigned r = next(seed);
+    uint8_t buf[256];
+    const uint8_t *data = buf;
+    size_t n = 0;
+    if (r & 0x20000) {
+      n = ring.readSpan(&data);
+    } else if (r & 0x40000) {
+      int c = ring.peek();
+      if (c >= 0 && c != pattern(got)) {
+        error = std::min(error, got);
+      }
+    } else {
+      n = ring.read(buf, (r >> 17) % sizeof(buf));
+    }
+    for (size_t i = 0; i < n; i++) {
+      if (data[i] != pattern(got + i)) {
+        error = std::min(error, got + i);
+      }
+    }
+    if (data != buf) {
+      ring.consume(n);
+    }
+    got += n;
+    if (n == 0) {
+      std::this_thread::yield();
+    }
+  }
+  return error;
+}
+
+static void checkTwoThreads(size_t capacity, size_t total) {
+  SpscRing ring(capacity);
+  CHECK(ring.capacity() >= capacity);
+  CHECK((ring.capacity() & (ring.capacity() - 1)) == 0);
+
+  auto start = std::chrono::steady_clock::now();
+  std::thread producer(produce, std::ref(ring), total);
+  size_t error = consume(ring, total);
+  producer.join();
+  double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+  if (error != total) {
+    printf("capacity %zu: byte %zu out of order\n", ring.capacity(), error);
+  }
+  CHECK(error == total);
+  CHECK(ring.available() == 0);
+  printf("capacity %5zu: %9zu bytes, %.0f MB/s\n", ring.capacity(), total, total / ms / 1000);
+}
+
+static void checkCbuf() {
+  cbuf b(100);
+  CHECK(b.size() == 128 && b.empty());
+  CHECK(b.write("hello world", 11) == 11 && b.available() == 11);
+  CHECK(b.peek() == 'h' && b.available() == 11 && b.read() == 'h');
+  char out[16];
+  CHECK(b.read(out, 4) == 4 && !memcmp(out, "ello", 4));
+  CHECK(b.remove(1) == 5);
+  // too small for the data, unchanged
+  CHECK(b.resize(4) == 128);
+  CHECK(b.resize(8) == 8 && b.available() == 5 && b.read(out, 16) == 5 && !memcmp(out, "world", 5));
+  char big[20];
+  memset(big, 0xff, sizeof(big));
+  CHECK(b.write(big, 20) == 8 && b.full() && b.read() == 255);
+  CHECK(b.resizeAdd(8) == 16 && b.available() == 7 && b.room() == 9);
+  b.flush();
+  CHECK(b.empty());
+}
+
+int main() {
+  checkTwoThreads(1, 100000);
+  checkTwoThreads(7, 200000);
+  checkTwoThreads(64, 2000000);
+  checkTwoThreads(1000, 10000000);
+  checkTwoThreads(4096, 10000000);
+  checkCbuf();
+
+  return check_result();
+}
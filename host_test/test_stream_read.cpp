@@ -0,0 +1,134 @@
+/*
+ * readString(), readStringUntil() and readBytesUntil() of Stream.cpp on a
+ * mock Stream, once per character and once through the peek buffer API.
+ * Both paths have to return the same data for any peek window size, and
+ * the benchmark prints the time of each.
+ */
+#include <chrono>
+#include <string>
+#include <vector>
+#include "Arduino.h"
+#include "StreamString.h"
+#include "check.h"
+
+// socket client stand-in: fixed data, seen through a window of at most window bytes
+class MockStream : public Stream {
+public:
+  MockStream(const std::string &data, bool peekApi, size_t window = 1436) : _data(data), _peekApi(peekApi), _window(window) {
+    setTimeout(0);
+  }
+
+  int available() override {
+    return _data.size() - _pos;
+  }
+  int read() override {
+    return _pos < _data.size() ? (unsigned char)_data[_pos++] : -1;
+  }
+  int peek() override {
+    return _pos < _data.size() ? (unsigned char)_data[_pos] : -1;
+  }
+  size_t write(uint8_t) override {
+    return 0;
+  }
+
+  bool hasPeekBufferAPI() const override {
+    return _peekApi;
+  }
+  size_t peekAvailable() override {
+    return std::min(_data.size() - _pos, _window);
+  }
+  const char *peekBuffer() override {
+    return _data.data() + _pos;
+  }
+  void peekConsume(size_t consume) override {
+    _pos += std::min(consume, peekAvailable());
+  }
+
+private:
+  const std::string &_data;
+  size_t _pos = 0;
+  bool _peekApi;
+  size_t _window;
+};
+
+// everything the three functions return while draining the stream
+static std::vector<std::string> drain(const std::string &data, bool peekApi, size_t window) {
+  std::vector<std::string> out;
+  MockStream s(data, peekApi, window);
+  char buf[24];
+  for (int i = 0; s.available(); i++) {
+    switch (i % 3) {
+      case 0: out.push_back(s.readStringUntil('\n').c_str()); break;
+      case 1: out.push_back(std::string(buf, s.readBytesUntil('\n', buf, sizeof(buf)))); break;
+      default: out.push_back(s.readStringUntil(':').c_str()); break;
+    }
+  }
+  MockStream rest(data, peekApi, window);
+  rest.readStringUntil('\n');
+  out.push_back(rest.readString().c_str());
+  return out;
+}
+
+template<typename F> static double ms(F f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+  // HTTP like request: 20 header lines and an empty one
+  std::string request = "GET /index.html?a=1 HTTP/1.1\r\n";
+  for (int i = 0; i < 20; i++) {
+    request += "X-Header-" + std::to_string(i) + ": some value of moderate length here\r\n";
+  }
+  request += "\r\n";
+  std::string longLine = std::string(16384, 'x') + "\n";
+  std::string mixed = request + "no terminator at the end:" + longLine + "\n\n::" + std::string(100, 'y');
+
+  for (const std::string *data : {&request, &longLine, &mixed}) {
+    std::vector<std::string> reference = drain(*data, false, 0);
+    for (size_t window : {1, 2, 3, 7, 64, 1436, 100000}) {
+      CHECK(drain(*data, true, window) == reference);
+    }
+  }
+
+  // StreamString provides the API through its string
+  StreamString ss;
+  ss.print("line one\nline two\n");
+  CHECK(ss.readStringUntil('\n') == "line one");
+  CHECK(ss.readString() == "line two\n");
+  CHECK(ss.available() == 0);
+
+  for (bool peekApi : {false, true}) {
+    size_t total = 0;
+    double headers = ms([&] {
+      for (int r = 0; r < 2000; r++) {
+        MockStream s(request, peekApi);
+        while (s.available()) {
+          total += s.readStringUntil('\r').length();
+          s.readStringUntil('\n');
+        }
+      }
+    });
+    double line = ms([&] {
+      for (int r = 0; r < 500; r++) {
+        MockStream s(longLine, peekApi);
+        total += s.readStringUntil('\n').length();
+      }
+    });
+    double bytes = ms([&] {
+      char buf[64];
+      for (int r = 0; r < 2000; r++) {
+        MockStream s(request, peekApi);
+        while (s.available()) {
+          total += s.readBytesUntil('\n', buf, sizeof(buf));
+        }
+      }
+    });
+    CHECK(total == 2000 * (request.size() - 2 * 22) + 500 * 16384 + 2000 * (request.size() - 22));
+    printf("%-14s 2000 headers %6.1f ms, 500 16 KB lines %6.1f ms, readBytesUntil %6.1f ms\n",
+           peekApi ? "peek window" : "per character", headers, line, bytes);
+  }
+
+  return check_result();
+}
@@ -0,0 +1,320 @@
+/*
+ * Loopback test of the binary telemetry framing of main/telemetry.c.
+ *
+ * A host server built on the framing code listens on 127.0.0.1 and answers
+ * like the TCP server of the device: subscribe, stats and power requests,
+ * acks with the status. The sample stream is received through the socket
+ * and parsed with tlm_parse_header(), so frames arrive split and merged at
+ * arbitrary TCP boundaries. The stats and power replies are also fetched
+ * with the Python reference client when it is available.
+ */
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <string.h>
+#include <unistd.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include "telemetry.h"
+#include "check.h"
+
+#define STREAM_RECORDS 100000
+
+static const tlm_stats_t stats[] = {
+  {0, 256, 1.5f, 0.25f, 1.0f, 2.0f, 1.5f, 1.875f},
+  {1, 256, 0.5f, 0.125f, 0.25f, 0.75f, 0.5f, 0.625f},
+  {2, 128, 3.0f, 1.0f, 2.0f, 4.0f, 3.0f, 3.5f},
+};
+
+static const tlm_power_t power = {12, 3456, 78000, 900000, 850, 1200, 6400, 0x05, 5, {1000, 2000, 3000, 4000, 5000}};
+
+static tlm_record_t streamRecord(uint32_t i) {
+  return {i * 10, (uint8_t)(i % 3), i * 0.25f};
+}
+
+static bool sendAll(int fd, const uint8_t *data, size_t len) {
+  while (len > 0) {
+    ssize_t n = send(fd, data, len, MSG_NOSIGNAL);
+    if (n <= 0) {
+      return false;
+    }
+    data += n;
+    len -= n;
+  }
+  return true;
+}
+
+static void sendAck(int fd, uint32_t seq, tlm_status_t status) {
+  uint8_t frame[TLM_HEADER_SIZE + 1];
+  uint8_t code = status;
+  sendAll(fd, frame, tlm_encode_frame(frame, TLM_TYPE_ACK, seq, &code, 1));
+}
+
+// sample frames as the device batches them, one send() per frame
+static void sendStream(int fd) {
+  uint8_t frame[TLM_MAX_FRAME_SIZE];
+  tlm_batch_t batch;
+  uint32_t seq = 0;
+
+  tlm_batch_init(&batch, frame, sizeof(frame));
+  for (uint32_t i = 0; i < STREAM_RECORDS; i++) {
+    tlm_record_t record = streamRecord(i);
+    if (!tlm_batch_add(&batch, &record)) {
+      sendAll(fd, frame, tlm_batch_finish(&batch, seq++));
+      tlm_batch_init(&batch, frame, sizeof(frame));
+      tlm_batch_add(&batch, &record);
+    }
+  }
+  sendAll(fd, frame, tlm_batch_finish(&batch, seq));
+}
+
+static void handleFrame(int fd, const tlm_header_t &header, const uint8_t *payload) {
+  uint8_t frame[TLM_MAX_FRAME_SIZE];
+  tlm_subscribe_t sub;
+  uint32_t mask;
+
+  switch (header.type) {
+    case TLM_TYPE_SUBSCRIBE:
+      if (!tlm_decode_subscribe(payload, header.length, &sub)) {
+        sendAck(fd, header.seq, TLM_STATUS_BAD_REQUEST);
+        break;
+      }
+      sendAck(fd, header.seq, TLM_STATUS_OK);
+      sendStream(fd);
+      break;
+    case TLM_TYPE_STATS_REQUEST: {
+      if (!tlm_decode_stats_request(payload, header.length, &mask)) {
+        sendAck(fd, header.seq, TLM_STATUS_BAD_REQUEST);
+        break;
+      }
+      tlm_stats_t selected[3];
+      uint8_t count = 0;
+      for (const tlm_stats_t &s : stats) {
+        if (mask & (1u << s.channel)) {
+          selected[count++] = s;
+        }
+      }
+      sendAll(fd, frame, tlm_encode_stats(frame, header.seq, selected, count));
+      break;
+    }
+    case TLM_TYPE_POWER_REQUEST:
+      sendAll(fd, frame, tlm_encode_power(frame, header.seq, &power));
+      break;
+    default:
+      sendAck(fd, header.seq, TLM_STATUS_UNSUPPORTED);
+      break;
+  }
+}
+
+// receive handling of tcp_server.c: invalid bytes are dropped with a BAD_REQUEST ack
+static void serveClient(int fd) {
+  uint8_t rx[256];
+  size_t rxLen = 0;
+
+  for (;;) {
+    ssize_t n = recv(fd, rx + rxLen, sizeof(rx) - rxLen, 0);
+    if (n <= 0) {
+      break;
+    }
+    rxLen += n;
+    size_t offset = 0;
+    while (offset < rxLen) {
+      tlm_header_t header;
+      tlm_parse_result_t result = tlm_parse_header(rx + offset, rxLen - offset, &header);
+      if (result == TLM_PARSE_NEED_MORE) {
+        break;
+      }
+      if (result != TLM_PARSE_OK) {
+        offset = rxLen;
+        sendAck(fd, 0, TLM_STATUS_BAD_REQUEST);
+        break;
+      }
+      handleFrame(fd, header, rx + offset + TLM_HEADER_SIZE);
+      offset += TLM_HEADER_SIZE + header.length;
+    }
+    memmove(rx, rx + offset, rxLen - offset);
+    rxLen -= offset;
+  }
+  close(fd);
+}
+
+static int startServer(uint16_t *port) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t len = sizeof(addr);
+  if (fd < 0 || bind(fd, (sockaddr *)&addr, len) != 0 || listen(fd, 4) != 0 || getsockname(fd, (sockaddr *)&addr, &len) != 0) {
+    return -1;
+  }
+  *port = ntohs(addr.sin_port);
+  std::thread([fd] {
+    int client;
+    while ((client = accept(fd, NULL, NULL)) >= 0) {
+      std::thread(serveClient, client).detach();
+    }
+  }).detach();
+  return fd;
+}
+
+static int connectTo(uint16_t port) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (connect(fd, (sockaddr *)&addr, sizeof(addr)) != 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+// reads one frame from the stream, rx keeps the bytes received beyond it
+static bool readFrame(int fd, std::string &rx, tlm_header_t *header, std::string *payload) {
+  for (;;) {
+    tlm_parse_result_t result = rx.empty() ? TLM_PARSE_NEED_MORE : tlm_parse_header((const uint8_t *)rx.data(), rx.size(), header);
+    if (result == TLM_PARSE_OK) {
+      *payload = rx.substr(TLM_HEADER_SIZE, header->length);
+      rx.erase(0, TLM_HEADER_SIZE + header->length);
+      return true;
+    }
+    if (result == TLM_PARSE_BAD) {
+      return false;
+    }
+    char buf[4096];
+    ssize_t n = recv(fd, buf, sizeof(buf), 0);
+    if (n <= 0) {
+      return false;
+    }
+    rx.append(buf, n);
+  }
+}
+
+static uint32_t getU32(const std::string &s, size_t pos) {
+  const uint8_t *p = (const uint8_t *)s.data() + pos;
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void sendRequest(int fd, uint8_t type, uint32_t seq, const uint8_t *payload, uint16_t len) {
+  uint8_t frame[TLM_HEADER_SIZE + 16];
+  sendAll(fd, frame, tlm_encode_frame(frame, type, seq, payload, len));
+}
+
+static void expectAck(int fd, std::string &rx, uint32_t seq, tlm_status_t status) {
+  tlm_header_t header;
+  std::string payload;
+  CHECK(readFrame(fd, rx, &header, &payload));
+  CHECK(header.type == TLM_TYPE_ACK && header.seq == seq);
+  CHECK(payload.size() == 1 && payload[0] == status);
+}
+
+static void checkStream(uint16_t port) {
+  int fd = connectTo(port);
+  CHECK(fd >= 0);
+  std::string rx;
+
+  const uint8_t badRate[] = {0, 0, 7, 0, 0, 0};
+  sendRequest(fd, TLM_TYPE_SUBSCRIBE, 1, badRate, sizeof(badRate));
+  expectAck(fd, rx, 1, TLM_STATUS_BAD_REQUEST);
+  sendRequest(fd, 0x7f, 2, NULL, 0);
+  expectAck(fd, rx, 2, TLM_STATUS_UNSUPPORTED);
+
+  auto start = std::chrono::steady_clock::now();
+  const uint8_t subscribe[] = {0xe8, 0x03, 7, 0, 0, 0};
+  sendRequest(fd, TLM_TYPE_SUBSCRIBE, 3, subscribe, sizeof(subscribe));
+  expectAck(fd, rx, 3, TLM_STATUS_OK);
+
+  uint32_t received = 0, frames = 0;
+  tlm_header_t header;
+  std::string payload;
+  while (received < STREAM_RECORDS && readFrame(fd, rx, &header, &payload)) {
+    CHECK(header.type == TLM_TYPE_SAMPLES && header.seq == frames);
+    CHECK(TLM_HEADER_SIZE + payload.size() <= TLM_MAX_FRAME_SIZE);
+    CHECK(payload.size() % TLM_RECORD_SIZE == 0);
+    for (size_t pos = 0; pos + TLM_RECORD_SIZE <= payload.size(); pos += TLM_RECORD_SIZE) {
+      tlm_record_t expected = streamRecord(received++);
+      uint32_t value = getU32(payload, pos + 5);
+      float f;
+      memcpy(&f, &value, sizeof(f));
+      CHECK(getU32(payload, pos) == expected.timestamp_ms);
+      CHECK((uint8_t)payload[pos + 4] == expected.channel);
+      CHECK(f == expected.value);
+    }
+    frames++;
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  CHECK(received == STREAM_RECORDS);
+  CHECK(frames == (STREAM_RECORDS + TLM_MAX_RECORDS - 1) / TLM_MAX_RECORDS);
+  printf("%u records in %u frames, %.0f records/s\n", received, frames, received / seconds);
+
+  // garbage in front of a request is dropped with a BAD_REQUEST ack
+  const uint8_t garbage[] = {'h', 'i', '\n'};
+  sendAll(fd, garbage, sizeof(garbage));
+  expectAck(fd, rx, 0, TLM_STATUS_BAD_REQUEST);
+  close(fd);
+}
+
+static void checkParser() {
+  uint8_t frame[TLM_HEADER_SIZE + 6];
+  const uint8_t subscribe[] = {10, 0, 1, 0, 0, 0};
+  size_t len = tlm_encode_frame(frame, TLM_TYPE_SUBSCRIBE, 42, subscribe, sizeof(subscribe));
+  tlm_header_t header;
+
+  for (size_t i = 1; i < len; i++) {
+    CHECK(tlm_parse_header(frame, i, &header) == TLM_PARSE_NEED_MORE);
+  }
+  CHECK(tlm_parse_header(frame, len, &header) == TLM_PARSE_OK);
+  CHECK(header.type == TLM_TYPE_SUBSCRIBE && header.seq == 42 && header.length == sizeof(subscribe));
+
+  frame[2] = TLM_VERSION + 1;
+  CHECK(tlm_parse_header(frame, len, &header) == TLM_PARSE_BAD);
+  frame[2] = TLM_VERSION;
+  frame[4] = 0xff;
+  frame[5] = 0xff;
+  CHECK(tlm_parse_header(frame, len, &header) == TLM_PARSE_BAD);
+  frame[1] = 0;
+  CHECK(tlm_parse_header(frame, 2, &header) == TLM_PARSE_BAD);
+}
+
+// output of the Python reference client, empty if it did not run
+static std::string runClient(uint16_t port, const char *args) {
+  std::string command = std::string(PYTHON3 " ../tools/telemetry_client.py --host 127.0.0.1 --port ") + std::to_string(port) + " " + args;
+  FILE *pipe = popen(command.c_str(), "r");
+  std::string output;
+  char buf[256];
+  while (pipe && fgets(buf, sizeof(buf), pipe)) {
+    output += buf;
+  }
+  if (!pipe || pclose(pipe) != 0) {
+    return "";
+  }
+  return output;
+}
+
+static void checkClient(uint16_t port) {
+#ifdef PYTHON3
+  CHECK(runClient(port, "--stats --channels 0x5")
+        == "lpg n=256 mean=1.500 sd=0.250 min=1.000 max=2.000 p50=1.500 p95=1.875\n"
+           "smoke n=128 mean=3.000 sd=1.000 min=2.000 max=4.000 p50=3.000 p95=3.500\n");
+  std::string out = runClient(port, "--power");
+  CHECK(out.find("wakes full=12 sample=3456\n") != std::string::npos);
+  CHECK(out.find("wake latency 850 us max 1200 us, sample wake 6400 us\n") != std::string::npos);
+  CHECK(out.find("lease co2") == std::string::npos);
+  CHECK(out.find("lease boot 1.0 s held\nlease tcp 2.0 s\nlease display 3.0 s held\n") != std::string::npos);
+#else
+  printf("python3 not found, reference client not run\n");
+#endif
+}
+
+int main() {
+  checkParser();
+
+  uint16_t port;
+  CHECK(startServer(&port) >= 0);
+  checkStream(port);
+  checkClient(port);
+
+  return check_result();
+}
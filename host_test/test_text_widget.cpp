@@ -0,0 +1,140 @@
+/*
+ * Pixel-count benchmark of the retained text widgets of main/text_widget.cpp
+ * against the full-screen clear and redraw they replaced. Every pixel that
+ * reaches the canvas is counted, on the ST7735 each of them is 2 bytes of
+ * SPI traffic. The widgets must also leave the same picture as drawing the
+ * final text from scratch.
+ */
+#include <stdlib.h>
+#include <string>
+#include "Adafruit_GFX.h"
+#include "text_widget.h"
+#include "Fonts/SourceCodePro_Bold10pt7b_aa4.h"
+#include "check.h"
+
+#define TFT_W 128
+#define TFT_H 160
+#define UPDATES 1000
+
+// layout of main/display.cpp
+#define BANNER_COLS 21
+#define PANEL_Y(i) (12 + (i) * 49)
+#define VALUE_COLS 5
+#define VALUE_X (TFT_W - 2 - VALUE_COLS * 12)
+#define VALUE_BASELINE(i) (PANEL_Y(i) + SourceCodePro_Bold10pt7b_aa4.ascent)
+
+static const uint16_t colors[3] = {0xFFE0, 0x07FF, 0xFD20};
+
+// canvas that counts the pixels drawn into it
+class PixelCounter : public GFXcanvas16 {
+public:
+  PixelCounter() : GFXcanvas16(TFT_W, TFT_H) {}
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+    pixels++;
+    GFXcanvas16::drawPixel(x, y, color);
+  }
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override {
+    pixels += w;
+    GFXcanvas16::drawFastHLine(x, y, w, color);
+  }
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override {
+    pixels += h;
+    GFXcanvas16::drawFastVLine(x, y, h, color);
+  }
+  void fillScreen(uint16_t color) override {
+    pixels += TFT_W * TFT_H;
+    GFXcanvas16::fillScreen(color);
+  }
+
+  bool samePicture(const PixelCounter &other) const {
+    return memcmp(getBuffer(), other.getBuffer(), TFT_W * TFT_H * 2) == 0;
+  }
+
+  long pixels = 0;
+};
+
+// sensor values as a random walk with an occasional jump, like a gas puff
+static void nextValues(float values[3]) {
+  for (int i = 0; i < 3; i++) {
+    values[i] += (rand() % 21 - 10) * 0.1f;
+    if (rand() % 50 == 0) {
+      values[i] *= 8;
+    }
+    values[i] = values[i] < 0 ? 0 : values[i] > 99999 ? 99999 : values[i];
+  }
+}
+
+static void formatValue(char *text, float ppm) {
+  snprintf(text, 16, ppm < 100.0f ? "%.1f" : "%.0f", ppm);
+}
+
+// the display task before the widgets: clear the screen, then draw everything
+static void fullRedraw(PixelCounter &tft, const char *banner, const float values[3]) {
+  tft.fillRect(0, 0, TFT_W, TFT_H, 0);
+  tft.setTextSize(1);
+  tft.setTextColor(0x07E0, 0);
+  tft.setCursor(1, 2);
+  tft.print(banner);
+  for (int i = 0; i < 3; i++) {
+    char text[16];
+    formatValue(text, values[i]);
+    int16_t width = Adafruit_GFX::getAATextWidth(text, &SourceCodePro_Bold10pt7b_aa4);
+    tft.drawAAText(TFT_W - 2 - width, VALUE_BASELINE(i), text, &SourceCodePro_Bold10pt7b_aa4, colors[i], 0);
+  }
+}
+
+struct Widgets {
+  TextField banner;
+  NumberField values[3];
+
+  explicit Widgets(Adafruit_GFX &tft)
+    : banner(tft, 1, 2, BANNER_COLS, 1, 1, 0x07E0, 0),
+      values{
+        NumberField(tft, VALUE_X, VALUE_BASELINE(0), VALUE_COLS, &SourceCodePro_Bold10pt7b_aa4, colors[0], 0),
+        NumberField(tft, VALUE_X, VALUE_BASELINE(1), VALUE_COLS, &SourceCodePro_Bold10pt7b_aa4, colors[1], 0),
+        NumberField(tft, VALUE_X, VALUE_BASELINE(2), VALUE_COLS, &SourceCodePro_Bold10pt7b_aa4, colors[2], 0),
+      } {}
+
+  uint16_t show(const char *text, const float ppm[3]) {
+    uint16_t cells = banner.setText(text);
+    for (int i = 0; i < 3; i++) {
+      char value[16];
+      formatValue(value, ppm[i]);
+      cells += values[i].setText(value);
+    }
+    return cells;
+  }
+};
+
+int main() {
+  PixelCounter full, retained;
+  Widgets widgets(retained);
+  float values[3] = {12.5f, 3.0f, 40.0f};
+  std::string banner = "LPG 12.5 ppm";
+  long cells = 0;
+
+  srand(1);
+  for (int i = 0; i < UPDATES; i++) {
+    nextValues(values);
+    // a new TCP message every tenth update
+    if (i % 10 == 0) {
+      banner = "msg " + std::to_string(i / 10) + " from 192.168.4.2";
+    }
+    fullRedraw(full, banner.c_str(), values);
+    cells += widgets.show(banner.c_str(), values);
+  }
+
+  // the final picture, drawn once from scratch
+  PixelCounter scratch;
+  Widgets fresh(scratch);
+  fresh.show(banner.c_str(), values);
+  CHECK(retained.samePicture(scratch));
+
+  printf("full redraw      %7.0f pixels per update\n", (double)full.pixels / UPDATES);
+  printf("changed cells    %7.0f pixels per update, %.1f cells\n", (double)retained.pixels / UPDATES, (double)cells / UPDATES);
+  printf("SPI traffic      %7.1f%% of the full redraw\n", 100.0 * retained.pixels / full.pixels);
+  CHECK(retained.pixels * 10 < full.pixels);
+
+  return check_result();
+}
@@ -0,0 +1,128 @@
+/*
+ * main/window_stats.h against brute force: mean, variance, minimum and
+ * maximum of every window position recomputed from the samples, and the
+ * P² estimates against the exact quantiles of the sorted stream.
+ */
+#include <stdlib.h>
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include "window_stats.h"
+#include "check.h"
+
+#define SAMPLES 20000
+
+typedef std::function<float(int)> Signal;
+
+static float uniform() {
+  return (float)rand() / RAND_MAX;
+}
+
+// signals that stress the sliding min/max deques and the running variance
+static const struct {
+  const char *name;
+  Signal signal;
+} signals[] = {
+  {"noise", [](int i) { return uniform() * 100; }},
+  {"rising", [](int i) { return i * 0.5f; }},
+  {"falling", [](int i) { return 1e4f - i * 0.5f; }},
+  {"steps", [](int i) { return (float)((i / 1000) * 50) + uniform(); }},
+  {"spikes", [](int i) { return i % 97 == 0 ? 5000.0f : 20.0f; }},
+  {"offset", [](int i) { return 1e4f + uniform(); }},
+  {"sawtooth", [](int i) { return (float)(i % 300); }},
+};
+
+template<typename T, size_t N> static void checkWindow(const char *name, const Signal &signal) {
+  WindowStats<T, N> stats;
+  std::vector<T> all;
+  double maxMeanError = 0, maxVarError = 0;
+  long extremeErrors = 0;
+
+  srand(1);
+  for (int i = 0; i < SAMPLES; i++) {
+    T value = (T)signal(i);
+    stats.add(value);
+    all.push_back(value);
+
+    size_t n = std::min(all.size(), N);
+    auto first = all.end() - n;
+    double sum = 0;
+    for (auto it = first; it != all.end(); ++it) {
+      sum += *it;
+    }
+    double mean = sum / n, m2 = 0;
+    for (auto it = first; it != all.end(); ++it) {
+      m2 += (*it - mean) * (*it - mean);
+    }
+    double variance = n > 1 ? m2 / (n - 1) : 0;
+
+    CHECK(stats.count() == n);
+    CHECK(stats.full() == (n == N));
+    extremeErrors += stats.min() != *std::min_element(first, all.end());
+    extremeErrors += stats.max() != *std::max_element(first, all.end());
+    CHECK(stats.samples().back() == value);
+    CHECK(stats.samples()[0] == *first);
+    // relative to the magnitude of the samples, float loses digits of large values
+    double scale = fabs(mean) + 1;
+    maxMeanError = fmax(maxMeanError, fabs(stats.mean() - mean) / scale);
+    maxVarError = fmax(maxVarError, fabs(stats.variance() - variance) / (variance + scale * scale * 1e-4));
+  }
+  if (extremeErrors || maxMeanError > 1e-5 || maxVarError > 1e-2) {
+    printf("%s, window %zu: %ld min/max errors, mean error %.2e, variance error %.2e\n", name, N, extremeErrors, maxMeanError,
+           maxVarError);
+  }
+  CHECK(extremeErrors == 0);
+  CHECK(maxMeanError <= 1e-5);
+  CHECK(maxVarError <= 1e-2);
+}
+
+// the estimate has to lie between the exact quantiles at p - tolerance and p + tolerance
+static void checkQuantile(const char *name, float p, const Signal &signal) {
+  P2Quantile<float> estimate(p);
+  std::vector<float> all;
+
+  srand(2);
+  for (int i = 0; i < SAMPLES * 5; i++) {
+    float value = signal(i);
+    estimate.add(value);
+    all.push_back(value);
+  }
+  std::sort(all.begin(), all.end());
+  float lo = all[(size_t)((p - 0.01f) * all.size())];
+  float hi = all[std::min(all.size() - 1, (size_t)((p + 0.01f) * all.size()))];
+  if (!(estimate.value() >= lo && estimate.value() <= hi)) {
+    printf("%s p%.0f: estimate %g, exact %g, allowed %g - %g\n", name, p * 100, estimate.value(), all[(size_t)(p * all.size())], lo, hi);
+  }
+  CHECK(estimate.value() >= lo && estimate.value() <= hi);
+  CHECK(estimate.count() == all.size());
+}
+
+int main() {
+  for (const auto &s : signals) {
+    checkWindow<float, 1>(s.name, s.signal);
+    checkWindow<float, 37>(s.name, s.signal);
+    checkWindow<float, 256>(s.name, s.signal);
+    checkWindow<double, 256>(s.name, s.signal);
+  }
+  checkWindow<int32_t, 64>("int noise", [](int i) { return rand() % 4096; });
+
+  // the stream quantiles of sensor_stats.cpp on shapes a gas sensor produces
+  checkQuantile("uniform", 0.95f, [](int i) { return uniform(); });
+  checkQuantile("uniform", 0.5f, [](int i) { return uniform(); });
+  checkQuantile("normal", 0.95f, [](int i) { return uniform() + uniform() + uniform() + uniform() - 2; });
+  checkQuantile("exponential", 0.95f, [](int i) { return -logf(1 - uniform() * 0.999999f); });
+  checkQuantile("drift", 0.95f, [](int i) { return i * 1e-3f + uniform(); });
+  checkQuantile("puffs", 0.95f, [](int i) { return (i / 500) % 10 == 0 ? 50 + uniform() * 10 : uniform(); });
+
+  // exact nearest rank for the first five samples
+  P2Quantile<float> few(0.5f);
+  CHECK(few.value() == 0);
+  const float firstSamples[] = {3, 1, 2, 5, 4};
+  const float medians[] = {3, 1, 2, 2, 3};
+  for (int i = 0; i < 5; i++) {
+    few.add(firstSamples[i]);
+    CHECK(few.value() == medians[i]);
+  }
+
+  return check_result();
+}
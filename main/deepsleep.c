@@ -1,57 +1,102 @@
 #include "deepsleep.h"
-#include "freertos/FreeRTOS.h"
-#include "freertos/task.h"
 #include "sys/time.h"
-#include "esp_system.h"
-#include "driver/rtc_io.h"
+#include "esp_attr.h"
+#include "esp_log.h"
 #include "esp_sleep.h"
+#include "power.h"
+#include "tslog.h"
+#include "touch.h"
+#include "sensors.h"
+#include "variables.h"
 #include <stdio.h>
 
 
-/** @brief RTC memory for deep sleep tracking */
-static RTC_DATA_ATTR struct timeval sleep_enter_time;
+/** @brief Logging tag for deepsleep */
+static const char *TAG = "sleep";
+
+/** @brief Marks valid RTC contents, RTC memory is random after power loss */
+#define RTC_BATCH_MAGIC 0x42415443
+
+/** @brief MQ-2 sample taken during a timer wake */
+typedef struct {
+    uint64_t timestamp_ms;      /*!< gettimeofday() time */
+    float values[3];            /*!< LPG, CO and smoke in ppm */
+} batch_sample_t;
+
+/** @brief Samples of the timer wakes since the last flush, oldest overwritten first */
+static RTC_DATA_ATTR struct {
+    uint32_t magic;
+    uint16_t head;              /*!< Oldest sample */
+    uint16_t count;
+    batch_sample_t samples[SLEEP_BATCH_SIZE];
+} rtc_batch;
 
 
 /**
- * @brief Task to handle deep sleep
- *
- * Calculates sleep duration, prints debug info, isolates GPIOs, and
- * enters deep sleep mode.
- *
- * @param args Unused
+ * @brief Checks whether a sample reaches an alarm level of the dashboard
  */
-static void deep_sleep_task(void *args)
+static bool is_alarm(const float *values)
 {
-    struct timeval now;
-    gettimeofday(&now, NULL);
-    int sleep_time_ms = (now.tv_sec - sleep_enter_time.tv_sec) * 1000 + (now.tv_usec - sleep_enter_time.tv_usec) / 1000;
+    return values[0] >= DASH_ALARM_LPG_PPM || values[1] >= DASH_ALARM_CO_PPM || values[2] >= DASH_ALARM_SMOKE_PPM;
+}
 
-    switch (esp_sleep_get_wakeup_cause()) {
-        case ESP_SLEEP_WAKEUP_TOUCHPAD: {
-            printf("Wake up from touch on pad %d\n", esp_sleep_get_touchpad_wakeup_status());
-            printf("Sleep time: %dms\n", sleep_time_ms);
-            break;
-        }
 
-        case ESP_SLEEP_WAKEUP_UNDEFINED:
-        default:
-            printf("Not a deep sleep reset\n");
+void deep_sleep_sample_wake(void)
+{
+    if (esp_sleep_get_wakeup_cause() != ESP_SLEEP_WAKEUP_TIMER) {
+        return;
+    }
+    if (rtc_batch.magic != RTC_BATCH_MAGIC || rtc_batch.count > SLEEP_BATCH_SIZE || rtc_batch.head >= SLEEP_BATCH_SIZE) {
+        rtc_batch.magic = RTC_BATCH_MAGIC;
+        rtc_batch.head = 0;
+        rtc_batch.count = 0;
     }
 
-    vTaskDelay(300000 / portTICK_PERIOD_MS);
-
-    rtc_gpio_isolate(GPIO_NUM_12);
+    batch_sample_t sample;
+    if (!sensors_sample_once(sample.values)) {
+        ESP_LOGW(TAG, "No warm MQ-2 sample, starting up");
+        return;
+    }
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    sample.timestamp_ms = (uint64_t)now.tv_sec * 1000 + now.tv_usec / 1000;
 
-    printf("Entering deep sleep\n");
+    uint16_t tail = (rtc_batch.head + rtc_batch.count) % SLEEP_BATCH_SIZE;
+    rtc_batch.samples[tail] = sample;
+    if (rtc_batch.count < SLEEP_BATCH_SIZE) {
+        rtc_batch.count++;
+    } else {
+        rtc_batch.head = (rtc_batch.head + 1) % SLEEP_BATCH_SIZE;
+    }
 
-    // get deep sleep enter time
-    gettimeofday(&sleep_enter_time, NULL);
+    if (is_alarm(sample.values)) {
+        ESP_LOGW(TAG, "Alarm level reached, starting up");
+        return;
+    }
+    // Only a full batch is worth mounting the file system for
+    if (rtc_batch.count == SLEEP_BATCH_SIZE && tslog_init()) {
+        deep_sleep_flush_batch();
+        tslog_flush();
+    }
 
-    // enter deep sleep
-    esp_deep_sleep_start();
+    my_touch_rearm();
+    power_sleep();
 }
 
 
-void start_deep_sleep_task(){
-    xTaskCreate(deep_sleep_task,"deep sleep task", 4096, NULL, 6, NULL);
-}
\ No newline at end of file
+void deep_sleep_flush_batch(void)
+{
+    if (rtc_batch.magic != RTC_BATCH_MAGIC) {
+        return;
+    }
+    while (rtc_batch.count > 0) {
+        const batch_sample_t *sample = &rtc_batch.samples[rtc_batch.head];
+        uint8_t mask = (1u << SENSOR_CHANNEL_LPG) | (1u << SENSOR_CHANNEL_CO) | (1u << SENSOR_CHANNEL_SMOKE);
+        if (!tslog_append(sample->timestamp_ms, mask, sample->values)) {
+            return;
+        }
+        rtc_batch.head = (rtc_batch.head + 1) % SLEEP_BATCH_SIZE;
+        rtc_batch.count--;
+    }
+}
+
@@ -5,10 +5,24 @@ extern "C" {
 #endif
 
 /**
- * @brief Start the TCP server task
+ * @brief Handle a timer wake without starting the firmware
+ *
+ * Must be called first in app_main(). On a timer wake one MQ-2 sample is
+ * added to the batch in RTC memory and the device goes back to sleep,
+ * WiFi, display and tasks are never started. A full batch is written to
+ * the log first. Returns only if the full firmware has to start: on any
+ * other wake, at an alarm level, or without a warm sensor baseline.
  */
-void start_deep_sleep_task();
+void deep_sleep_sample_wake(void);
+
+/**
+ * @brief Write the samples of the timer wakes to the log
+ *
+ * Must be called after tslog_init(). Samples stay in RTC memory if the
+ * log is unavailable.
+ */
+void deep_sleep_flush_batch(void);
 
 #ifdef __cplusplus
 }
-#endif
\ No newline at end of file
+#endif
@@ -2,8 +2,15 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_log.h"
+#include <stdio.h>
 #include <string.h>
 #include "variables.h"
+#include "text_widget.h"
+#include "sparkline.h"
+#include "sensor_scheduler.h"
+#include "sensor_events.h"
+#include "power.h"
+#include "Fonts/SourceCodePro_Bold10pt7b_aa4.h"
 
 
 /** @brief Logging tag for display */
@@ -15,40 +22,209 @@ TaskHandle_t taskLcdTransfer;
 /** @brief TFT display instance */
 Adafruit_ST7735 tft = Adafruit_ST7735(TFT_CS, TFT_DC, TFT_RST);
 
+/** @brief Number of gas panels, one per MQ-2 channel starting at SENSOR_CHANNEL_LPG */
+#define DASH_PANELS 3
+
+/** @brief Top edge of a gas panel */
+#define PANEL_Y(i) (DASH_PANEL_Y + (i) * DASH_PANEL_H)
+
+/** @brief Static description of a gas panel */
+typedef struct {
+    const char *label;
+    uint16_t color;
+    float alarm_ppm;
+} panel_desc_t;
+
+static const panel_desc_t panels[DASH_PANELS] = {
+    {"LPG", ST77XX_YELLOW, DASH_ALARM_LPG_PPM},
+    {"CO", ST77XX_CYAN, DASH_ALARM_CO_PPM},
+    {"SMOKE", ST77XX_ORANGE, DASH_ALARM_SMOKE_PPM},
+};
+
+/** @brief Banner line, shows the alarm or else the last TCP message */
+static TextField banner(tft, 1, 2, DASH_BANNER_COLS, 1, 1, ST77XX_GREEN, ST7735_BLACK);
+
+/** @brief Current value per gas at the top right of its panel, below the separator line */
+#define VALUE_X (128 - 2 - DASH_VALUE_COLS * 12)    /* 12 is the digit advance of the font */
+#define VALUE_BASELINE(i) (PANEL_Y(i) + SourceCodePro_Bold10pt7b_aa4.ascent)
+static NumberField values[DASH_PANELS] = {
+    NumberField(tft, VALUE_X, VALUE_BASELINE(0), DASH_VALUE_COLS, &SourceCodePro_Bold10pt7b_aa4, ST77XX_YELLOW, ST7735_BLACK),
+    NumberField(tft, VALUE_X, VALUE_BASELINE(1), DASH_VALUE_COLS, &SourceCodePro_Bold10pt7b_aa4, ST77XX_CYAN, ST7735_BLACK),
+    NumberField(tft, VALUE_X, VALUE_BASELINE(2), DASH_VALUE_COLS, &SourceCodePro_Bold10pt7b_aa4, ST77XX_ORANGE, ST7735_BLACK),
+};
+
+/** @brief History per gas below its value */
+static Sparkline sparklines[DASH_PANELS] = {
+    Sparkline(tft, 2, PANEL_Y(0) + DASH_SPARK_Y, 124, DASH_SPARK_H, DASH_SPARK_MAX_PPM, ST77XX_YELLOW, ST7735_BLACK),
+    Sparkline(tft, 2, PANEL_Y(1) + DASH_SPARK_Y, 124, DASH_SPARK_H, DASH_SPARK_MAX_PPM, ST77XX_CYAN, ST7735_BLACK),
+    Sparkline(tft, 2, PANEL_Y(2) + DASH_SPARK_Y, 124, DASH_SPARK_H, DASH_SPARK_MAX_PPM, ST77XX_ORANGE, ST7735_BLACK),
+};
+
+/** @brief Last TCP message, restored in the banner once an alarm clears */
+static char banner_msg[DASH_BANNER_COLS + 1] = "";
+
+/** @brief Panels above their alarm level or with a detected event, bit n for panel n */
+static uint8_t alarm_mask = 0;
+
+/** @brief Timestamp of the last value shown per panel */
+static int64_t shown_us[DASH_PANELS];
+
+
 /**
- * @brief Init TFT screen (all black) 
+ * @brief Init TFT screen (all black)
  */
 void display_init(void){
     tft.initR(INITR_BLACKTAB);
 }
 
 
+/**
+ * @brief Draws the parts of the dashboard that never change
+ */
+static void draw_static(void)
+{
+    tft.fillRect(0, 0, 128, 160, ST7735_BLACK);
+    tft.setTextSize(1);
+    for (int i = 0; i < DASH_PANELS; i++) {
+        tft.setTextColor(panels[i].color, ST7735_BLACK);
+        tft.setCursor(2, PANEL_Y(i) + 4);
+        tft.print(panels[i].label);
+        tft.setTextColor(ST77XX_WHITE, ST7735_BLACK);
+        tft.setCursor(2, PANEL_Y(i) + 14);
+        tft.print("ppm");
+        tft.drawFastHLine(0, PANEL_Y(i), 128, 0x39E7);
+    }
+}
+
+
+/**
+ * @brief Shows the alarm state or the last message in the banner
+ *
+ * Colors change only with the alarm state, which repaints the whole
+ * banner; otherwise only changed characters are redrawn.
+ *
+ * @param recolor true if the alarm state changed
+ */
+static void update_banner(bool recolor)
+{
+    uint16_t fg = alarm_mask ? ST77XX_WHITE : ST77XX_GREEN;
+    uint16_t bg = alarm_mask ? ST77XX_RED : ST7735_BLACK;
+    if (recolor) {
+        tft.fillRect(0, 0, 128, DASH_BANNER_H, bg);
+        banner.setColor(fg, bg);
+    }
+    if (!alarm_mask) {
+        banner.setText(banner_msg);
+        return;
+    }
+
+    char text[DASH_BANNER_COLS + 1] = "ALARM";
+    for (int i = 0; i < DASH_PANELS; i++) {
+        if (alarm_mask & (1u << i)) {
+            strlcat(text, " ", sizeof(text));
+            strlcat(text, panels[i].label, sizeof(text));
+        }
+    }
+    banner.setText(text);
+}
+
+
+/**
+ * @brief Shows the values published since the last frame
+ *
+ * Every new value adds one sparkline column and redraws the digits that
+ * changed, nothing else is touched.
+ */
+static void update_dashboard(void)
+{
+    sensor_snapshot_t snap;
+    if (!sensor_scheduler_get_snapshot(&snap)) {
+        return;
+    }
+
+    // Events come from the detector in the scheduler task, so they show up within the frame
+    uint8_t mask = (sensor_events_active_mask() >> SENSOR_CHANNEL_LPG) & ((1u << DASH_PANELS) - 1);
+    for (int i = 0; i < DASH_PANELS; i++) {
+        int ch = SENSOR_CHANNEL_LPG + i;
+        if (!(snap.valid_mask & (1u << ch))) {
+            values[i].setText("-");
+            continue;
+        }
+        float ppm = snap.values[ch];
+        if (ppm >= panels[i].alarm_ppm) {
+            mask |= 1u << i;
+        }
+        if (snap.timestamp_us[ch] == shown_us[i]) {
+            continue;
+        }
+        shown_us[i] = snap.timestamp_us[ch];
+
+        char text[16];
+        if (ppm >= 99999.0f) {
+            strcpy(text, "99999");
+        } else {
+            snprintf(text, sizeof(text), ppm < 100.0f ? "%.1f" : "%.0f", ppm);
+        }
+        values[i].setText(text);
+        sparklines[i].add(ppm);
+    }
+
+    if (mask != alarm_mask) {
+        if (mask & ~alarm_mask) {
+            ESP_LOGW(TAG, "Alarm raised, mask 0x%02x", mask);
+        }
+        // Stay awake as long as an alarm is shown
+        if (mask && !alarm_mask) {
+            power_acquire(POWER_LEASE_ALARM);
+        } else if (!mask && alarm_mask) {
+            power_release(POWER_LEASE_ALARM);
+        }
+        alarm_mask = mask;
+        update_banner(true);
+    }
+}
+
+
 /**
  * @brief Task to handle TFT display updates
  *
- * Clears the display, sets cursor and text attributes, and prints messages.
- * Waits for notifications to update the display content.
+ * Refreshes the dashboard every DASH_FRAME_MS from the sensor snapshot and
+ * shows messages from the queue in the banner in between.
  *
  * @param parameter Unused
  */
 static void task_lcd_transfer(void *parameter) {
-    char msg[TFT_MSG_SIZE];
-   
-    // Init screen (all black)
-    tft.fillRect(0,0,128,160, ST7735_BLACK);
+    tft_msg_t msg;
+    TickType_t next = xTaskGetTickCount();
+
+    draw_static();
+    update_banner(true);
 
     while(1) {
-        if(xQueueReceive(tftQueue, &msg, portMAX_DELAY)) {
-            tft.fillRect(0, 0, 128, 160, ST7735_BLACK);
-            tft.setCursor(TEXT_X, TEXT_Y);
-            tft.setTextSize(3);
-            tft.setTextColor(ST77XX_GREEN);  
-            tft.print(msg);
+        TickType_t now = xTaskGetTickCount();
+        TickType_t wait = (int32_t)(next - now) > 0 ? next - now : 0;
+        if(xQueueReceive(tftQueue, &msg, wait)) {
+            strlcpy(banner_msg, tft_msg_data(msg), sizeof(banner_msg));
+            tft_msg_release(msg);
+            char *nl = strchr(banner_msg, '\n');
+            if (nl) {
+                *nl = '\0';
+            }
+            update_banner(false);
+            power_hold(POWER_LEASE_DISPLAY, POWER_DISPLAY_HOLD_MS);
+            continue;
+        }
+
+        update_dashboard();
+        next += pdMS_TO_TICKS(DASH_FRAME_MS);
+        // Skip missed frames instead of drawing several in a row
+        if ((int32_t)(xTaskGetTickCount() - next) > 0) {
+            next = xTaskGetTickCount() + pdMS_TO_TICKS(DASH_FRAME_MS);
         }
     }
 }
 
 
 void start_display_task(){
-    xTaskCreate(&task_lcd_transfer, "TFT", 4096, NULL, 1, &taskLcdTransfer); 
-}
\ No newline at end of file
+    xTaskCreate(&task_lcd_transfer, "TFT", 4096, NULL, 1, &taskLcdTransfer);
+}
@@ -0,0 +1,93 @@
+#include "event_detector.h"
+#include <math.h>
+#include <string.h>
+
+
+/** -----------------------------------------------------------------------------------------------------------------------------------------------------------------*/
+
+
+evd_config_t evd_default_config(void)
+{
+    evd_config_t config = {
+        .k = EVD_DEFAULT_K,
+        .h_on = EVD_DEFAULT_H_ON,
+        .h_off = EVD_DEFAULT_H_OFF,
+        .hold = EVD_DEFAULT_HOLD,
+        .alpha = EVD_DEFAULT_ALPHA,
+        .warmup = EVD_DEFAULT_WARMUP,
+        .min_sigma = EVD_DEFAULT_MIN_SIGMA,
+    };
+    return config;
+}
+
+
+void evd_init(evd_state_t *state, const evd_config_t *config)
+{
+    memset(state, 0, sizeof(*state));
+    state->config = *config;
+}
+
+
+/**
+ * @brief Moves the baseline towards a sample
+ *
+ * During the warm-up the weight is 1/n, the plain running mean and
+ * variance, afterwards the fixed EWMA weight.
+ */
+static void track_baseline(evd_state_t *state, float value)
+{
+    const evd_config_t *c = &state->config;
+    float alpha = state->samples < c->warmup ? 1.0f / (state->samples + 1) : c->alpha;
+    float delta = value - state->mean;
+    state->mean += alpha * delta;
+    state->var = (1.0f - alpha) * (state->var + alpha * delta * delta);
+}
+
+
+evd_result_t evd_update(evd_state_t *state, float value)
+{
+    const evd_config_t *c = &state->config;
+
+    if (state->samples < c->warmup) {
+        track_baseline(state, value);
+        state->samples++;
+        return EVD_NONE;
+    }
+    state->samples++;
+
+    float sigma = sqrtf(state->var);
+    if (sigma < c->min_sigma) {
+        sigma = c->min_sigma;
+    }
+    float score = state->score + (value - state->mean) / sigma - c->k;
+    state->score = score > 0 ? score : 0;
+
+    if (!state->active) {
+        if (state->score > c->h_on) {
+            state->active = true;
+            state->quiet = 0;
+            state->peak = value;
+            return EVD_START;
+        }
+        track_baseline(state, value);
+        return EVD_NONE;
+    }
+
+    // Cap the score, otherwise a long event would take as long to end
+    if (state->score > c->h_on) {
+        state->score = c->h_on;
+    }
+    if (value > state->peak) {
+        state->peak = value;
+    }
+    if (state->score >= c->h_off) {
+        state->quiet = 0;
+        return EVD_NONE;
+    }
+    if (++state->quiet < c->hold) {
+        return EVD_NONE;
+    }
+    state->active = false;
+    state->score = 0;
+    return EVD_END;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Change point detection on one sensor channel.
+ *
+ * A one-sided CUSUM of the standardized deviation from a slowly tracked
+ * baseline: every sample adds (x - mean) / sigma - k to the score, which
+ * is clamped at 0. An event starts when the score exceeds h_on and ends
+ * once it stayed below h_off for hold samples. The baseline is frozen
+ * during an event so the gas being detected does not become the norm.
+ *
+ * This file has no ESP-IDF dependencies and builds on the host as well,
+ * recorded traces can be replayed with tools/replay_events.c.
+ */
+
+/* Sample rate the time based defaults are derived from, MQ2_SAMPLE_HZ of the firmware */
+#ifndef EVD_SAMPLE_HZ
+#define EVD_SAMPLE_HZ           10
+#endif
+
+/* Default parameters, tuned for the MQ-2 ppm channels */
+#define EVD_DEFAULT_K           0.5f    /* Slack per sample in sigmas, drift below this is ignored */
+#define EVD_DEFAULT_H_ON        8.0f    /* Score that starts an event */
+#define EVD_DEFAULT_H_OFF       2.0f    /* Score below which an event may end */
+#define EVD_DEFAULT_HOLD        (1 * EVD_SAMPLE_HZ)             /* Samples below h_off before an event ends, 1 s */
+#define EVD_DEFAULT_ALPHA       (1.0f / (5 * EVD_SAMPLE_HZ))    /* Baseline EWMA weight, time constant 5 s */
+#define EVD_DEFAULT_WARMUP      (5 * EVD_SAMPLE_HZ)             /* Samples to learn the baseline before detecting, 5 s */
+#define EVD_DEFAULT_MIN_SIGMA   1.0f    /* Lower bound of sigma, keeps a flat signal from triggering */
+
+/** @brief Detector parameters */
+typedef struct {
+    float k;
+    float h_on;
+    float h_off;
+    uint16_t hold;
+    float alpha;
+    uint16_t warmup;
+    float min_sigma;
+} evd_config_t;
+
+/** @brief Detector state of one channel */
+typedef struct {
+    evd_config_t config;
+    float mean;                 /*!< Baseline */
+    float var;                  /*!< Baseline variance */
+    float score;                /*!< CUSUM score in sigmas */
+    float peak;                 /*!< Largest sample of the running event */
+    uint32_t samples;
+    uint16_t quiet;             /*!< Consecutive samples below h_off during an event */
+    bool active;
+} evd_state_t;
+
+/** @brief Result of evd_update() */
+typedef enum {
+    EVD_NONE = 0,               /*!< No change */
+    EVD_START,                  /*!< An event started with this sample */
+    EVD_END,                    /*!< The running event ended with this sample */
+} evd_result_t;
+
+/**
+ * @brief Default parameters
+ */
+evd_config_t evd_default_config(void);
+
+/**
+ * @brief Reset a detector, the baseline is learned again
+ */
+void evd_init(evd_state_t *state, const evd_config_t *config);
+
+/**
+ * @brief Feed one sample
+ *
+ * @return Whether an event started or ended
+ */
+evd_result_t evd_update(evd_state_t *state, float value);
+
+#ifdef __cplusplus
+}
+#endif
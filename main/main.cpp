@@ -2,9 +2,9 @@
  * @file main.cpp
  * @brief Main program for the Smell-It project
  *
- * Initializes Wifi SoftAP, TCP-Server, TFT Display and touch module
+ * Initializes Wifi SoftAP, TCP-Server, TFT Display, touch module and the sample log
  * 
- * Handles LCD updates, TCP communication, and deep sleep logic.
+ * Handles LCD updates, TCP communication, and lease based deep sleep.
  */
 
 /* needed components */
@@ -13,29 +13,44 @@ extern "C" {
 #include "wifi_manager.h"
 #include "tcp_server.h"
 #include "deepsleep.h"    
+#include "power.h"
+#include "sensor_scheduler.h"
+#include "sensor_events.h"
+#include "tslog.h"
 }
 
 #include "display.h"
 #include "variables.h"
+#include "sensors.h"
 
 /**
  * @brief Application entry point
  *
- * Initializes NVS, WiFi, touch sensor, TFT display, and starts tasks
- * for LCD transfer, TCP server, and deep sleep handling.
+ * Initializes NVS, WiFi, touch sensor, TFT display, sensors and starts tasks
+ * for sensor sampling, LCD transfer, TCP server, and power management.
+ * Timer wakes from deep sleep only log a sample and sleep again.
  */
 extern "C" void app_main(void)
 {
+    power_wake();
+    deep_sleep_sample_wake();
+
     init_wifi_config();
     wifi_init_softap();
     my_touch_init();
     display_init();
     init_tft_queue();
+    init_sensors();
+    sensor_events_init();
+    tslog_init();
+    deep_sleep_flush_batch();
 
     // Start all RTOS tasks
+    start_sensor_scheduler_task();
+    start_tslog_task();
     start_tcp_server_task();
     start_display_task();
-    start_deep_sleep_task();
+    start_power_task();
     //xTaskCreate(statTask, "stat task", 4096, NULL, 1, NULL);
 }
 
@@ -0,0 +1,118 @@
+#include "mq2_baseline.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_sleep.h"
+#include "esp_timer.h"
+#include "nvs_flash.h"
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+/** @brief Logging tag for mq2_baseline */
+static const char *TAG = "baseline";
+
+/** @brief Marks valid RTC contents, RTC memory is random after power loss */
+#define RTC_BASELINE_MAGIC 0x4D513242
+
+/** @brief NVS key of the checkpoint */
+#define NVS_KEY_RO "ro"
+
+
+/** @brief RTC memory copy of the baseline, survives deep sleep */
+static RTC_DATA_ATTR struct {
+    uint32_t magic;
+    float ro;
+} rtc_baseline;
+
+/** @brief Value and time of the last NVS checkpoint */
+static float checkpoint_ro = 0;
+static int64_t checkpoint_time_us = 0;
+
+
+/** -----------------------------------------------------------------------------------------------------------------------------------------------------------------*/
+
+
+/**
+ * @brief Reads the checkpoint from NVS
+ *
+ * @param ro Output, Ro in kilo ohms
+ * @return true if a checkpoint exists
+ */
+static bool load_checkpoint(float *ro)
+{
+    nvs_handle_t handle;
+    if (nvs_open(MQ2_BASELINE_NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+        return false;
+    }
+    uint32_t bits = 0;
+    esp_err_t err = nvs_get_u32(handle, NVS_KEY_RO, &bits);
+    nvs_close(handle);
+    if (err != ESP_OK) {
+        return false;
+    }
+    memcpy(ro, &bits, sizeof(bits));
+    return *ro > 0;
+}
+
+
+/**
+ * @brief Writes the checkpoint to NVS
+ *
+ * @param ro Ro in kilo ohms
+ */
+static void save_checkpoint(float ro)
+{
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(MQ2_BASELINE_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Unable to open NVS: %s", esp_err_to_name(err));
+        return;
+    }
+    uint32_t bits;
+    memcpy(&bits, &ro, sizeof(bits));
+    err = nvs_set_u32(handle, NVS_KEY_RO, bits);
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Unable to save baseline: %s", esp_err_to_name(err));
+    }
+}
+
+
+bool mq2_baseline_restore(float *ro, bool *from_rtc)
+{
+    *from_rtc = false;
+    if (esp_sleep_get_wakeup_cause() != ESP_SLEEP_WAKEUP_UNDEFINED &&
+        rtc_baseline.magic == RTC_BASELINE_MAGIC && rtc_baseline.ro > 0) {
+        *ro = rtc_baseline.ro;
+        *from_rtc = true;
+        ESP_LOGI(TAG, "Ro %.2f kohm restored from RTC memory", *ro);
+    } else if (load_checkpoint(ro)) {
+        ESP_LOGI(TAG, "Ro %.2f kohm restored from NVS", *ro);
+    } else {
+        return false;
+    }
+    checkpoint_ro = *ro;
+    checkpoint_time_us = esp_timer_get_time();
+    return true;
+}
+
+
+void mq2_baseline_store(float ro)
+{
+    rtc_baseline.ro = ro;
+    rtc_baseline.magic = RTC_BASELINE_MAGIC;
+
+    int64_t now = esp_timer_get_time();
+    if (checkpoint_ro > 0 && now - checkpoint_time_us < (int64_t)MQ2_BASELINE_CHECKPOINT_MS * 1000) {
+        return;
+    }
+    // Skip flash writes for changes below 1%
+    if (fabsf(ro - checkpoint_ro) > checkpoint_ro * 0.01f) {
+        save_checkpoint(ro);
+        checkpoint_ro = ro;
+    }
+    checkpoint_time_us = now;
+}
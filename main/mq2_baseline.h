@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* NVS checkpoint parameters */
+#define MQ2_BASELINE_NVS_NAMESPACE      "mq2"
+#define MQ2_BASELINE_CHECKPOINT_MS      (30 * 60 * 1000)
+
+/**
+ * @brief Restore the last known MQ-2 baseline (Ro)
+ *
+ * After a deep sleep wake the baseline is taken from RTC memory, after a
+ * cold boot from the last NVS checkpoint.
+ *
+ * @param ro Output, Ro in kilo ohms
+ * @param from_rtc Output, true if the value survived deep sleep in RTC memory,
+ *                 the sensor heater kept running and needs no warm-up
+ * @return true if a baseline was found, false if the sensor must be calibrated
+ */
+bool mq2_baseline_restore(float *ro, bool *from_rtc);
+
+/**
+ * @brief Store the current baseline
+ *
+ * Updates the RTC copy on every call and writes an NVS checkpoint at most
+ * every MQ2_BASELINE_CHECKPOINT_MS, and only if the value changed.
+ *
+ * @param ro Ro in kilo ohms
+ */
+void mq2_baseline_store(float ro);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,248 @@
+#include "power.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_sleep.h"
+#include "esp_timer.h"
+#include "driver/rtc_io.h"
+#include "sys/time.h"
+#include <stdio.h>
+#include <string.h>
+#include "variables.h"
+#include "tslog.h"
+
+
+/** @brief Logging tag for power */
+static const char *TAG = "power";
+
+/** @brief Marks valid RTC contents, RTC memory is random after power loss */
+#define RTC_POWER_MAGIC 0x50575231
+
+/** @brief RTC memory for deep sleep tracking */
+static RTC_DATA_ATTR struct timeval sleep_enter_time;
+
+/** @brief Counters of the previous wakes, survive deep sleep */
+static RTC_DATA_ATTR struct {
+    uint32_t magic;
+    power_counters_t counters;          /*!< awake_ms and lease_ms without the current wake */
+} rtc_power;
+
+/** @brief State of a lease */
+typedef struct {
+    uint16_t count;                     /*!< Counted holders */
+    int64_t until_us;                   /*!< End of the timed hold, esp_timer time */
+    bool held;
+    int64_t held_since_us;              /*!< Start of the current holding period */
+} lease_state_t;
+
+static lease_state_t leases[POWER_LEASE_COUNT];
+
+/** @brief Guards leases and the counters, every update is short */
+static portMUX_TYPE lease_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/** @brief Power task, NULL before start_power_task() */
+static TaskHandle_t power_task_handle = NULL;
+
+
+/** -----------------------------------------------------------------------------------------------------------------------------------------------------------------*/
+
+
+/**
+ * @brief Updates the holding period of a lease, called with lease_lock held
+ *
+ * @return true if the lease is held
+ */
+static bool refresh_lease(power_lease_t id, int64_t now)
+{
+    lease_state_t *lease = &leases[id];
+    bool held = lease->count > 0 || lease->until_us > now;
+    if (held && !lease->held) {
+        lease->held_since_us = now;
+    } else if (!held && lease->held) {
+        rtc_power.counters.lease_ms[id] += (now - lease->held_since_us) / 1000;
+    }
+    lease->held = held;
+    return held;
+}
+
+
+/**
+ * @brief Wakes the power task to re-evaluate the leases
+ */
+static void notify_power_task(void)
+{
+    if (power_task_handle != NULL) {
+        xTaskNotifyGive(power_task_handle);
+    }
+}
+
+
+/**
+ * @brief Task putting the device to sleep once no lease is held
+ *
+ * Sleeps until the next timed hold runs out or a lease changes. Before
+ * deep sleep the log is flushed, which holds a lease itself, so the
+ * leases are checked once more afterwards.
+ *
+ * @param args Unused
+ */
+static void power_task(void *args)
+{
+    bool flushed = false;
+    while (1) {
+        int64_t now = esp_timer_get_time();
+        int64_t next_us = INT64_MAX;
+        bool awake = false;
+        portENTER_CRITICAL(&lease_lock);
+        for (int i = 0; i < POWER_LEASE_COUNT; i++) {
+            awake |= refresh_lease(i, now);
+            if (leases[i].until_us > now && leases[i].until_us < next_us) {
+                next_us = leases[i].until_us;
+            }
+        }
+        portEXIT_CRITICAL(&lease_lock);
+
+        if (!awake) {
+            if (flushed) {
+                power_sleep();
+            }
+            tslog_flush();
+            flushed = true;
+            continue;
+        }
+        flushed = false;
+
+        TickType_t wait = next_us == INT64_MAX ? portMAX_DELAY : pdMS_TO_TICKS((next_us - now) / 1000) + 1;
+        ulTaskNotifyTake(pdTRUE, wait);
+    }
+}
+
+
+void power_wake(void)
+{
+    if (rtc_power.magic != RTC_POWER_MAGIC) {
+        memset(&rtc_power, 0, sizeof(rtc_power));
+        rtc_power.magic = RTC_POWER_MAGIC;
+    }
+
+    esp_sleep_wakeup_cause_t cause = esp_sleep_get_wakeup_cause();
+    if (cause == ESP_SLEEP_WAKEUP_UNDEFINED) {
+        printf("Not a deep sleep reset\n");
+        return;
+    }
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    int64_t sleep_time_ms = (now.tv_sec - sleep_enter_time.tv_sec) * 1000LL + (now.tv_usec - sleep_enter_time.tv_usec) / 1000;
+    if (sleep_time_ms > 0) {
+        rtc_power.counters.asleep_ms += sleep_time_ms;
+    }
+
+    // Timer wakes stay quiet, most of them are over within a few hundred ms
+    if (cause == ESP_SLEEP_WAKEUP_TOUCHPAD) {
+        printf("Wake up from touch on pad %d\n", esp_sleep_get_touchpad_wakeup_status());
+        printf("Sleep time: %lldms\n", (long long)sleep_time_ms);
+    }
+}
+
+
+void start_power_task(void)
+{
+    uint32_t latency_us = (uint32_t)esp_timer_get_time();
+    portENTER_CRITICAL(&lease_lock);
+    rtc_power.counters.full_wakes++;
+    rtc_power.counters.wake_latency_us = latency_us;
+    if (latency_us > rtc_power.counters.max_wake_latency_us) {
+        rtc_power.counters.max_wake_latency_us = latency_us;
+    }
+    portEXIT_CRITICAL(&lease_lock);
+    ESP_LOGI(TAG, "Ready %lu us after reset", (unsigned long)latency_us);
+
+    power_hold(POWER_LEASE_BOOT, POWER_BOOT_HOLD_MS);
+    xTaskCreate(power_task, "power", 4096, NULL, 6, &power_task_handle);
+}
+
+
+void power_acquire(power_lease_t lease)
+{
+    portENTER_CRITICAL(&lease_lock);
+    leases[lease].count++;
+    refresh_lease(lease, esp_timer_get_time());
+    portEXIT_CRITICAL(&lease_lock);
+}
+
+
+void power_release(power_lease_t lease)
+{
+    portENTER_CRITICAL(&lease_lock);
+    if (leases[lease].count > 0) {
+        leases[lease].count--;
+    }
+    portEXIT_CRITICAL(&lease_lock);
+    notify_power_task();
+}
+
+
+void power_hold(power_lease_t lease, uint32_t ms)
+{
+    int64_t now = esp_timer_get_time();
+    int64_t until = now + (int64_t)ms * 1000;
+    portENTER_CRITICAL(&lease_lock);
+    if (until > leases[lease].until_us) {
+        leases[lease].until_us = until;
+    }
+    refresh_lease(lease, now);
+    portEXIT_CRITICAL(&lease_lock);
+    // The task may wait for an earlier deadline, it picks up the new one then
+}
+
+
+void power_get_counters(power_counters_t *out)
+{
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&lease_lock);
+    *out = rtc_power.counters;
+    out->awake_ms += now / 1000;
+    out->lease_mask = 0;
+    for (int i = 0; i < POWER_LEASE_COUNT; i++) {
+        if (refresh_lease(i, now)) {
+            out->lease_mask |= 1u << i;
+            out->lease_ms[i] += (now - leases[i].held_since_us) / 1000;
+        }
+    }
+    portEXIT_CRITICAL(&lease_lock);
+}
+
+
+void power_sleep(void)
+{
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&lease_lock);
+    for (int i = 0; i < POWER_LEASE_COUNT; i++) {
+        if (leases[i].held) {
+            rtc_power.counters.lease_ms[i] += (now - leases[i].held_since_us) / 1000;
+        }
+    }
+    rtc_power.counters.awake_ms += now / 1000;
+    if (power_task_handle == NULL) {
+        rtc_power.counters.sample_wakes++;
+        rtc_power.counters.sample_wake_us = (uint32_t)now;
+    }
+    portEXIT_CRITICAL(&lease_lock);
+
+    if (power_task_handle != NULL) {
+        printf("Entering deep sleep\n");
+    }
+
+    rtc_gpio_isolate(GPIO_NUM_12);
+
+    if (SLEEP_WAKE_INTERVAL_S > 0) {
+        esp_sleep_enable_timer_wakeup((uint64_t)SLEEP_WAKE_INTERVAL_S * 1000000);
+    }
+
+    // get deep sleep enter time
+    gettimeofday(&sleep_enter_time, NULL);
+
+    // enter deep sleep
+    esp_deep_sleep_start();
+}
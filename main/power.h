@@ -0,0 +1,92 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Stay-awake leases and deep sleep entry.
+ *
+ * Subsystems hold a lease while the device has to stay awake for them,
+ * either counted (acquire/release) or timed (hold). The power task puts
+ * the device into deep sleep as soon as no lease is held. It wakes on
+ * touch, and every SLEEP_WAKE_INTERVAL_S on the timer to log a sample,
+ * which starts the firmware only at an alarm level (see deepsleep.h).
+ *
+ * Wake and awake time counters live in RTC memory and add up across
+ * deep sleep cycles until the next power loss.
+ */
+
+/** @brief Reasons to stay awake */
+typedef enum {
+    POWER_LEASE_BOOT = 0,       /*!< POWER_BOOT_HOLD_MS after a full wake, time to connect */
+    POWER_LEASE_TCP,            /*!< One per connected TCP client */
+    POWER_LEASE_DISPLAY,        /*!< New content on the display */
+    POWER_LEASE_ALARM,          /*!< Alarm level or active gas event */
+    POWER_LEASE_FLASH,          /*!< Log write in progress */
+    POWER_LEASE_COUNT
+} power_lease_t;
+
+/** @brief Counters since power on */
+typedef struct {
+    uint32_t full_wakes;                    /*!< Wakes that started the firmware, including power on */
+    uint32_t sample_wakes;                  /*!< Timer wakes that only logged a sample */
+    uint64_t awake_ms;                      /*!< Time awake, including the current wake */
+    uint64_t asleep_ms;                     /*!< Time in deep sleep */
+    uint32_t wake_latency_us;               /*!< Reset to firmware ready, last full wake */
+    uint32_t max_wake_latency_us;
+    uint32_t sample_wake_us;                /*!< Reset to sleep, last sample wake */
+    uint8_t lease_mask;                     /*!< Leases held right now, bit n for lease n */
+    uint32_t lease_ms[POWER_LEASE_COUNT];   /*!< Time each lease was held */
+} power_counters_t;
+
+/**
+ * @brief Account the sleep that just ended and print the wake cause
+ *
+ * Must be called first in app_main().
+ */
+void power_wake(void);
+
+/**
+ * @brief Start the power task, the firmware counts as ready from here
+ *
+ * Holds POWER_LEASE_BOOT for POWER_BOOT_HOLD_MS.
+ */
+void start_power_task(void);
+
+/**
+ * @brief Take a counted lease, nested calls need as many releases
+ */
+void power_acquire(power_lease_t lease);
+
+/**
+ * @brief Drop a counted lease
+ */
+void power_release(power_lease_t lease);
+
+/**
+ * @brief Hold a lease for a time from now, extends but never shortens a running hold
+ *
+ * @param lease Lease to hold
+ * @param ms Duration in ms
+ */
+void power_hold(power_lease_t lease, uint32_t ms);
+
+/**
+ * @brief Copy the counters
+ */
+void power_get_counters(power_counters_t *out);
+
+/**
+ * @brief Enter deep sleep with touch and timer wakeup, does not return
+ *
+ * Used by the power task and by sample wakes before the task runs.
+ */
+void power_sleep(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,127 @@
+#include "sensor_events.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "esp_vfs_eventfd.h"
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include "event_detector.h"
+#include "variables.h"
+
+/** @brief Logging tag for sensor_events */
+static const char *TAG = "events";
+
+_Static_assert(EVD_SAMPLE_HZ == MQ2_SAMPLE_HZ, "event detector defaults assume another sample rate");
+
+
+/** @brief Detector per channel, only the scheduler task updates them */
+static evd_state_t detectors[SENSOR_CHANNEL_COUNT];
+
+/** @brief Last SENSOR_EVENTS_LOG_SIZE events, event n in slot n % SENSOR_EVENTS_LOG_SIZE */
+static sensor_event_t event_log[SENSOR_EVENTS_LOG_SIZE];
+static uint32_t event_seq = 0;
+static uint32_t active_mask = 0;
+
+/** @brief Counts events until a reader resets it, -1 if eventfd is unavailable */
+static int event_fd = -1;
+
+/** @brief Guards the log, the mask and the sequence number */
+static portMUX_TYPE events_lock = portMUX_INITIALIZER_UNLOCKED;
+
+
+/** -----------------------------------------------------------------------------------------------------------------------------------------------------------------*/
+
+
+void sensor_events_init(void)
+{
+    evd_config_t config = evd_default_config();
+    for (int ch = 0; ch < SENSOR_CHANNEL_COUNT; ch++) {
+        evd_init(&detectors[ch], &config);
+    }
+
+    esp_vfs_eventfd_config_t eventfd_config = {
+        .max_fds = 1,
+    };
+    if (esp_vfs_eventfd_register(&eventfd_config) == ESP_OK) {
+        event_fd = eventfd(0, 0);
+    }
+    if (event_fd < 0) {
+        ESP_LOGW(TAG, "No eventfd, readers have to poll for events");
+    }
+}
+
+
+void sensor_events_add(sensor_channel_t channel, float value, int64_t now_us)
+{
+    if (!(SENSOR_EVENTS_CHANNELS & (1u << channel))) {
+        return;
+    }
+    evd_state_t *detector = &detectors[channel];
+    evd_result_t result = evd_update(detector, value);
+    if (result == EVD_NONE) {
+        return;
+    }
+
+    sensor_event_t event = {
+        .timestamp_ms = (uint32_t)(now_us / 1000),
+        .channel = channel,
+        .start = result == EVD_START,
+        .value = result == EVD_START ? value : detector->peak,
+        .baseline = detector->mean,
+        .score = detector->score,
+    };
+
+    portENTER_CRITICAL(&events_lock);
+    event.seq = ++event_seq;
+    event_log[event.seq % SENSOR_EVENTS_LOG_SIZE] = event;
+    if (event.start) {
+        active_mask |= 1u << channel;
+    } else {
+        active_mask &= ~(1u << channel);
+    }
+    portEXIT_CRITICAL(&events_lock);
+
+    if (event_fd >= 0) {
+        uint64_t one = 1;
+        write(event_fd, &one, sizeof(one));
+    }
+
+    ESP_LOGI(TAG, "Event %s on channel %d: %.1f, baseline %.1f",
+             event.start ? "start" : "end", channel, event.value, event.baseline);
+}
+
+
+uint32_t sensor_events_latest(void)
+{
+    portENTER_CRITICAL(&events_lock);
+    uint32_t seq = event_seq;
+    portEXIT_CRITICAL(&events_lock);
+    return seq;
+}
+
+
+bool sensor_events_get(uint32_t seq, sensor_event_t *out)
+{
+    bool found;
+    portENTER_CRITICAL(&events_lock);
+    found = seq > 0 && seq <= event_seq && event_seq - seq < SENSOR_EVENTS_LOG_SIZE;
+    if (found) {
+        *out = event_log[seq % SENSOR_EVENTS_LOG_SIZE];
+    }
+    portEXIT_CRITICAL(&events_lock);
+    return found;
+}
+
+
+int sensor_events_fd(void)
+{
+    return event_fd;
+}
+
+
+uint32_t sensor_events_active_mask(void)
+{
+    portENTER_CRITICAL(&events_lock);
+    uint32_t mask = active_mask;
+    portEXIT_CRITICAL(&events_lock);
+    return mask;
+}
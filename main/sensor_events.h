@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sensor_scheduler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Event detection parameters */
+#define SENSOR_EVENTS_CHANNELS  ((1u << SENSOR_CHANNEL_LPG) | (1u << SENSOR_CHANNEL_CO) | (1u << SENSOR_CHANNEL_SMOKE))
+#define SENSOR_EVENTS_LOG_SIZE  16      /* Events kept for readers that fall behind */
+
+/** @brief Start or end of an event on one channel */
+typedef struct {
+    uint32_t seq;               /*!< Event number, the first is 1 */
+    uint32_t timestamp_ms;      /*!< esp_timer time of the sample */
+    uint8_t channel;
+    bool start;                 /*!< true when the event started, false when it ended */
+    float value;                /*!< Triggering sample at the start, peak at the end */
+    float baseline;             /*!< Baseline the sample was compared to */
+    float score;                /*!< CUSUM score in sigmas */
+} sensor_event_t;
+
+/**
+ * @brief Set up a detector per channel in SENSOR_EVENTS_CHANNELS
+ *
+ * Must be called before start_sensor_scheduler_task().
+ */
+void sensor_events_init(void);
+
+/**
+ * @brief Feed a published sample to the detector of its channel
+ *
+ * Called by the sensor scheduler, samples of other channels are ignored.
+ *
+ * @param channel Channel of the sample
+ * @param value New value
+ * @param now_us Time of the read
+ */
+void sensor_events_add(sensor_channel_t channel, float value, int64_t now_us);
+
+/**
+ * @brief Number of the newest event, 0 if there was none
+ */
+uint32_t sensor_events_latest(void);
+
+/**
+ * @brief Read an event from the log
+ *
+ * Every reader keeps the number of the last event it handled and asks for
+ * the following ones up to sensor_events_latest().
+ *
+ * @param seq Event number
+ * @param out Output
+ * @return false if the event is not in the log (anymore)
+ */
+bool sensor_events_get(uint32_t seq, sensor_event_t *out);
+
+/**
+ * @brief File descriptor that becomes readable with every new event
+ *
+ * Lets a select() loop wait for events instead of polling. Reading the
+ * 8 byte counter resets it, a single reader is expected.
+ *
+ * @return eventfd, -1 if it could not be created
+ */
+int sensor_events_fd(void);
+
+/**
+ * @brief Channels with a running event, bit n for channel n
+ */
+uint32_t sensor_events_active_mask(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,180 @@
+#include "sensor_scheduler.h"
+#include "sensor_stats.h"
+#include "sensor_events.h"
+#include "tslog.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include <stdatomic.h>
+#include <string.h>
+
+/** @brief Logging tag for sensor_scheduler */
+static const char *TAG = "sensors";
+
+/** @brief Number of copy attempts before a snapshot read gives up */
+#define SNAPSHOT_READ_RETRIES 4
+
+
+/** @brief Runtime state of a table entry */
+typedef struct {
+    sensor_desc_t desc;
+    int64_t next_due_us;
+} sensor_slot_t;
+
+/** @brief Sensor table, sorted by descending priority */
+static sensor_slot_t sensors[SENSOR_SCHEDULER_MAX_SENSORS];
+static size_t sensor_count = 0;
+
+/** @brief Shared snapshot, odd sequence means an update is in progress */
+static sensor_snapshot_t snapshot;
+static atomic_uint_least32_t snapshot_seq = 0;
+
+/** @brief Handle for the sensor task */
+static TaskHandle_t taskSensors;
+
+/** @brief Periodic tick */
+static esp_timer_handle_t tick_timer;
+
+
+/** -----------------------------------------------------------------------------------------------------------------------------------------------------------------*/
+
+
+/**
+ * @brief Publishes the values of one sensor into the snapshot
+ *
+ * Only the scheduler task writes, so a sequence counter is enough to let
+ * readers detect a torn copy.
+ *
+ * @param desc Sensor the values belong to
+ * @param values New values
+ * @param now_us Time of the read
+ */
+static void publish(const sensor_desc_t *desc, const float *values, int64_t now_us)
+{
+    uint32_t seq = atomic_load_explicit(&snapshot_seq, memory_order_relaxed);
+    atomic_store_explicit(&snapshot_seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    for (uint8_t i = 0; i < desc->channel_count; i++) {
+        int ch = desc->first_channel + i;
+        snapshot.values[ch] = values[i];
+        snapshot.timestamp_us[ch] = now_us;
+        snapshot.valid_mask |= 1u << ch;
+    }
+    snapshot.seq = (seq + 2) / 2;
+
+    atomic_store_explicit(&snapshot_seq, seq + 2, memory_order_release);
+
+    // Statistics, event detection and the log see every value, in the same tick
+    for (uint8_t i = 0; i < desc->channel_count; i++) {
+        sensor_stats_add(desc->first_channel + i, values[i]);
+        sensor_events_add(desc->first_channel + i, values[i], now_us);
+        tslog_add(desc->first_channel + i, values[i]);
+    }
+}
+
+
+/**
+ * @brief esp_timer callback, wakes the sensor task
+ *
+ * @param arg Unused
+ */
+static void tick_callback(void *arg)
+{
+    xTaskNotifyGive(taskSensors);
+}
+
+
+/**
+ * @brief Task reading all due sensors on every tick
+ *
+ * @param parameter Unused
+ */
+static void task_sensor_scheduler(void *parameter)
+{
+    float values[SENSOR_CHANNEL_COUNT];
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        int64_t now = esp_timer_get_time();
+
+        for (size_t i = 0; i < sensor_count; i++) {
+            sensor_slot_t *slot = &sensors[i];
+            if (now < slot->next_due_us) {
+                continue;
+            }
+            if (slot->desc.read(slot->desc.ctx, values)) {
+                publish(&slot->desc, values, now);
+            }
+            slot->next_due_us += (int64_t)slot->desc.period_ms * 1000;
+            // Skip missed periods instead of reading several times in a row
+            if (slot->next_due_us <= now) {
+                slot->next_due_us = now + (int64_t)slot->desc.period_ms * 1000;
+            }
+        }
+    }
+}
+
+
+bool sensor_scheduler_register(const sensor_desc_t *desc)
+{
+    if (taskSensors != NULL) {
+        ESP_LOGE(TAG, "Scheduler already running, cannot add %s", desc->name);
+        return false;
+    }
+    if (sensor_count >= SENSOR_SCHEDULER_MAX_SENSORS) {
+        ESP_LOGE(TAG, "Sensor table full, cannot add %s", desc->name);
+        return false;
+    }
+    if (desc->read == NULL || desc->period_ms == 0 || desc->channel_count == 0 ||
+        desc->first_channel + desc->channel_count > SENSOR_CHANNEL_COUNT) {
+        ESP_LOGE(TAG, "Invalid sensor description %s", desc->name);
+        return false;
+    }
+
+    // Insert sorted by priority, equal priorities keep registration order
+    size_t pos = sensor_count;
+    while (pos > 0 && sensors[pos - 1].desc.priority < desc->priority) {
+        sensors[pos] = sensors[pos - 1];
+        pos--;
+    }
+    sensors[pos].desc = *desc;
+    sensor_count++;
+    return true;
+}
+
+
+void start_sensor_scheduler_task()
+{
+    int64_t now = esp_timer_get_time();
+    for (size_t i = 0; i < sensor_count; i++) {
+        sensors[i].next_due_us = now + (int64_t)sensors[i].desc.warmup_ms * 1000;
+    }
+
+    xTaskCreate(&task_sensor_scheduler, "sensors", 4096, NULL, 4, &taskSensors);
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = &tick_callback,
+        .name = "sensor_tick",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&timer_args, &tick_timer));
+    ESP_ERROR_CHECK(esp_timer_start_periodic(tick_timer, SENSOR_SCHEDULER_TICK_MS * 1000));
+}
+
+
+bool sensor_scheduler_get_snapshot(sensor_snapshot_t *out)
+{
+    for (int i = 0; i < SNAPSHOT_READ_RETRIES; i++) {
+        uint32_t begin = atomic_load_explicit(&snapshot_seq, memory_order_acquire);
+        if (begin & 1) {
+            continue;
+        }
+        memcpy(out, &snapshot, sizeof(*out));
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&snapshot_seq, memory_order_relaxed) == begin) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Scheduler parameters */
+#define SENSOR_SCHEDULER_MAX_SENSORS    8
+#define SENSOR_SCHEDULER_TICK_MS        10
+
+/** @brief Value slots of the shared snapshot, one per measured quantity */
+typedef enum {
+    SENSOR_CHANNEL_LPG = 0,
+    SENSOR_CHANNEL_CO,
+    SENSOR_CHANNEL_SMOKE,
+    SENSOR_CHANNEL_TEMPERATURE,
+    SENSOR_CHANNEL_HUMIDITY,
+    SENSOR_CHANNEL_CO2,
+    SENSOR_CHANNEL_COUNT
+} sensor_channel_t;
+
+/**
+ * @brief Sensor read callback
+ *
+ * Called from the scheduler task once the sensor is due. Must not block
+ * longer than a few milliseconds since all sensors share one task.
+ *
+ * @param ctx Context pointer of the sensor description
+ * @param values Output, channel_count values starting at first_channel
+ * @return true if new values were written
+ */
+typedef bool (*sensor_read_fn)(void *ctx, float *values);
+
+/** @brief Entry of the sensor table */
+typedef struct {
+    const char *name;
+    uint32_t period_ms;         /*!< Time between two reads */
+    uint32_t warmup_ms;         /*!< Time after start before the first read */
+    uint8_t priority;           /*!< Higher priority sensors are read first within a tick */
+    sensor_channel_t first_channel;
+    uint8_t channel_count;
+    sensor_read_fn read;
+    void *ctx;
+} sensor_desc_t;
+
+/** @brief Latest values of all channels */
+typedef struct {
+    uint32_t seq;                                   /*!< Number of published updates */
+    uint32_t valid_mask;                            /*!< Bit n set if channel n holds a value */
+    int64_t timestamp_us[SENSOR_CHANNEL_COUNT];     /*!< esp_timer time of the last update */
+    float values[SENSOR_CHANNEL_COUNT];
+} sensor_snapshot_t;
+
+/**
+ * @brief Add a sensor to the table
+ *
+ * Must be called before start_sensor_scheduler_task().
+ *
+ * @param desc Sensor description, copied into the table
+ * @return true on success, false if the table is full or the description invalid
+ */
+bool sensor_scheduler_register(const sensor_desc_t *desc);
+
+/**
+ * @brief Start the sensor task and the esp_timer tick driving it
+ */
+void start_sensor_scheduler_task(void);
+
+/**
+ * @brief Copy the latest values without blocking
+ *
+ * The snapshot is published with a sequence counter, a reader retries
+ * only if the scheduler updated it during the copy.
+ *
+ * @param out Destination of the copy
+ * @return true if a consistent copy was taken
+ */
+bool sensor_scheduler_get_snapshot(sensor_snapshot_t *out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,49 @@
+#include "sensor_stats.h"
+#include "freertos/FreeRTOS.h"
+#include "window_stats.h"
+
+
+/** @brief Window and quantiles of one channel */
+struct channel_stats_t {
+    WindowStats<float, SENSOR_STATS_WINDOW> window;
+    P2Quantile<float> p50{0.5f};
+    P2Quantile<float> p95{0.95f};
+};
+
+/** @brief Statistics per channel, written by the scheduler task */
+static channel_stats_t stats[SENSOR_CHANNEL_COUNT];
+
+/** @brief Guards stats, every update is short */
+static portMUX_TYPE stats_lock = portMUX_INITIALIZER_UNLOCKED;
+
+
+/** -----------------------------------------------------------------------------------------------------------------------------------------------------------------*/
+
+
+void sensor_stats_add(sensor_channel_t channel, float value)
+{
+    channel_stats_t *s = &stats[channel];
+    portENTER_CRITICAL(&stats_lock);
+    s->window.add(value);
+    s->p50.add(value);
+    s->p95.add(value);
+    portEXIT_CRITICAL(&stats_lock);
+}
+
+
+bool sensor_stats_get(sensor_channel_t channel, sensor_stats_t *out)
+{
+    const channel_stats_t *s = &stats[channel];
+    portENTER_CRITICAL(&stats_lock);
+    out->count = s->window.count();
+    if (out->count > 0) {
+        out->mean = s->window.mean();
+        out->stddev = s->window.stddev();
+        out->min = s->window.min();
+        out->max = s->window.max();
+        out->p50 = s->p50.value();
+        out->p95 = s->p95.value();
+    }
+    portEXIT_CRITICAL(&stats_lock);
+    return out->count > 0;
+}
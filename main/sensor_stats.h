@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sensor_scheduler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Statistics parameters */
+#define SENSOR_STATS_WINDOW     256     /* Samples per channel, 25.6 s at MQ2_SAMPLE_HZ */
+
+/** @brief Statistics of one channel */
+typedef struct {
+    uint32_t count;             /*!< Samples in the window */
+    float mean;                 /*!< Window mean */
+    float stddev;               /*!< Window standard deviation */
+    float min;                  /*!< Window minimum */
+    float max;                  /*!< Window maximum */
+    float p50;                  /*!< Median estimate of all samples since boot */
+    float p95;                  /*!< 95th percentile estimate of all samples since boot */
+} sensor_stats_t;
+
+/**
+ * @brief Add a sample of a channel
+ *
+ * Called by the sensor scheduler for every published value, O(1).
+ *
+ * @param channel Channel of the sample
+ * @param value New value
+ */
+void sensor_stats_add(sensor_channel_t channel, float value);
+
+/**
+ * @brief Read the statistics of a channel
+ *
+ * @param channel Channel to read
+ * @param out Output
+ * @return false if the channel has no samples yet
+ */
+bool sensor_stats_get(sensor_channel_t channel, sensor_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,125 @@
+#include "sensors.h"
+#include "sensor_scheduler.h"
+#include "variables.h"
+#include "mq2_baseline.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "MQ2.h"
+
+
+/** @brief Logging tag for sensors */
+static const char *TAG = "sensors";
+
+/** @brief Continuous ADC rate, the lowest one the ESP32 supports */
+#define MQ2_ADC_HZ          20000
+
+/** @brief Duration of one ADC frame */
+#define MQ2_FRAME_MS        (MQ2_FRAME_CONVERSIONS * 1000 / MQ2_ADC_HZ)
+
+/** @brief Frames averaged into one reading, one window per sample period */
+#define MQ2_WINDOW_FRAMES   (MQ2_SAMPLE_PERIOD_MS / MQ2_FRAME_MS)
+
+/** @brief Scheduler period, below one frame since the ADC driver keeps only two */
+#define MQ2_POLL_MS         20
+
+/** @brief Shorter window for deep sleep wakes, a settling window and a sample window */
+#define MQ2_WAKE_WINDOW_FRAMES  2
+
+/** @brief Time a wake waits for both windows, twice the nominal 4 frames */
+#define MQ2_WAKE_TIMEOUT_MS     (2 * 2 * MQ2_WAKE_WINDOW_FRAMES * MQ2_FRAME_MS)
+
+static_assert(MQ2_POLL_MS < MQ2_FRAME_MS, "MQ-2 polled too slowly, ADC frames would be lost");
+static_assert(MQ2_WINDOW_FRAMES * MQ2_FRAME_MS == MQ2_SAMPLE_PERIOD_MS, "MQ2_SAMPLE_PERIOD_MS is not a whole number of frames");
+
+/** @brief MQ-2 gas sensor instance */
+static MQ2 mq2(MQ2_PIN);
+
+
+/**
+ * @brief Read callback of the MQ-2 sensor
+ *
+ * Collects the finished ADC frames and reports new gas values once
+ * a whole averaging window is complete.
+ *
+ * @param ctx MQ2 instance
+ * @param values Output for LPG, CO and smoke in ppm
+ * @return true if a new window was completed
+ */
+static bool read_mq2(void *ctx, float *values)
+{
+    MQ2 *sensor = static_cast<MQ2 *>(ctx);
+    if (!sensor->update()) {
+        return false;
+    }
+    values[0] = sensor->readLPG();
+    values[1] = sensor->readCO();
+    values[2] = sensor->readSmoke();
+    mq2_baseline_store(sensor->getRo());
+    return true;
+}
+
+
+void init_sensors(void)
+{
+    // A stored baseline skips the calibration, after deep sleep the heater
+    // is still warm and the warm-up is skipped as well
+    float ro = 0;
+    bool warm = false;
+    if (!mq2_baseline_restore(&ro, &warm)) {
+        ESP_LOGI(TAG, "No MQ-2 baseline stored, calibrating on first window");
+    }
+    if (!mq2.beginContinuous(MQ2_ADC_HZ, MQ2_WINDOW_FRAMES, ro)) {
+        ESP_LOGE(TAG, "Failed to start MQ-2 sampling on pin %d", MQ2_PIN);
+        return;
+    }
+
+    const sensor_desc_t mq2_desc = {
+        .name = "mq2",
+        .period_ms = MQ2_POLL_MS,
+        .warmup_ms = warm ? 0u : MQ2_WARMUP_MS,
+        .priority = 1,
+        .first_channel = SENSOR_CHANNEL_LPG,
+        .channel_count = 3,
+        .read = &read_mq2,
+        .ctx = &mq2,
+    };
+    sensor_scheduler_register(&mq2_desc);
+}
+
+
+bool sensors_sample_once(float *values)
+{
+    // Only a heater that kept running through deep sleep gives a valid sample right away
+    float ro = 0;
+    bool warm = false;
+    if (!mq2_baseline_restore(&ro, &warm) || !warm) {
+        return false;
+    }
+    if (!mq2.beginContinuous(MQ2_ADC_HZ, MQ2_WAKE_WINDOW_FRAMES, ro)) {
+        ESP_LOGE(TAG, "Failed to start MQ-2 sampling on pin %d", MQ2_PIN);
+        return false;
+    }
+
+    // The first window still holds the settling ADC, the second one is used
+    int64_t deadline = esp_timer_get_time() + (int64_t)MQ2_WAKE_TIMEOUT_MS * 1000;
+    int windows = 0;
+    while (windows < 2 && esp_timer_get_time() < deadline) {
+        if (mq2.update()) {
+            windows++;
+        } else {
+            vTaskDelay(1);
+        }
+    }
+    // Released for init_sensors() in case the firmware starts after all
+    mq2.endContinuous();
+    if (windows < 2) {
+        return false;
+    }
+    values[0] = mq2.readLPG();
+    values[1] = mq2.readCO();
+    values[2] = mq2.readSmoke();
+    mq2_baseline_store(mq2.getRo());
+    return true;
+}
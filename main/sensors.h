@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initialize all sensors and add them to the sensor scheduler
+ *
+ * Must be called before start_sensor_scheduler_task().
+ */
+void init_sensors(void);
+
+/**
+ * @brief Take one MQ-2 sample without the scheduler
+ *
+ * For short wakes from deep sleep. Needs the baseline from RTC memory,
+ * i.e. a heater that kept running. Samples two short windows of 50 ms
+ * and keeps the second one, about 100 ms of ADC time.
+ *
+ * @param values Output, LPG, CO and smoke in ppm
+ * @return false if there is no warm baseline or the ADC timed out
+ */
+bool sensors_sample_once(float *values);
+
+#ifdef __cplusplus
+}
+#endif
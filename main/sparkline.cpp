@@ -0,0 +1,113 @@
+#include "sparkline.h"
+
+
+Sparkline::Sparkline(Adafruit_SPITFT &tft, int16_t x, int16_t y, uint8_t w, uint8_t h,
+                     float max, uint16_t fg, uint16_t bg)
+    : _tft(tft), _x(x), _y(y), _w(w), _h(h), _max(max), _fg(fg), _bg(bg), _pos(0), _count(0)
+{
+    if (_w > SPARKLINE_MAX_W) {
+        _w = SPARKLINE_MAX_W;
+    }
+    if (_h > SPARKLINE_MAX_H) {
+        _h = SPARKLINE_MAX_H;
+    }
+}
+
+
+uint8_t Sparkline::level(float value) const
+{
+    if (!(value > 0)) {
+        return 0;
+    }
+    float row = value / _max * (_h - 1) + 0.5f;
+    return row >= _h - 1 ? _h - 1 : (uint8_t)row;
+}
+
+
+void Sparkline::span(uint8_t col, int16_t *lo, int16_t *hi) const
+{
+    uint8_t gap = _pos;
+    if (col >= _count || col == gap) {
+        *lo = 1;
+        *hi = 0;
+        return;
+    }
+    *lo = *hi = _levels[col];
+
+    // Connect to the previous value. Behind the gap that value is no longer
+    // shown but still stored, so the connector drawn when this column was
+    // the newest stays valid.
+    uint8_t prev = col > 0 ? col - 1 : _w - 1;
+    if (prev < _count) {
+        if (_levels[prev] < *lo) {
+            *lo = _levels[prev];
+        } else {
+            *hi = _levels[prev];
+        }
+    }
+}
+
+
+void Sparkline::add(float value)
+{
+    uint8_t col = _pos;
+    _values[col] = value;
+    _pos = col + 1 < _w ? col + 1 : 0;
+    if (_count < _w) {
+        _count++;
+    }
+
+    if (value > _max) {
+        while (value > _max) {
+            _max *= 2;
+        }
+        for (uint8_t i = 0; i < _count; i++) {
+            _levels[i] = level(_values[i]);
+        }
+        redraw();
+        return;
+    }
+    _levels[col] = level(value);
+
+    // The new column and the gap after it, side by side unless the gap wrapped around
+    uint16_t buf[2 * SPARKLINE_MAX_H];
+    uint8_t cols = _pos ? 2 : 1;
+    int16_t lo, hi;
+    span(col, &lo, &hi);
+    for (uint8_t r = 0; r < _h; r++) {
+        int16_t row = _h - 1 - r;
+        buf[r * cols] = (row >= lo && row <= hi) ? _fg : _bg;
+        if (cols == 2) {
+            buf[r * cols + 1] = _bg;
+        }
+    }
+
+    _tft.startWrite();
+    _tft.setAddrWindow(_x + col, _y, cols, _h);
+    _tft.writePixels(buf, cols * _h);
+    if (cols == 1) {
+        _tft.writeFillRect(_x, _y, 1, _h, _bg);
+    }
+    _tft.endWrite();
+}
+
+
+void Sparkline::redraw()
+{
+    uint16_t row[SPARKLINE_MAX_W];
+    int16_t lo[SPARKLINE_MAX_W];
+    int16_t hi[SPARKLINE_MAX_W];
+    for (uint8_t c = 0; c < _w; c++) {
+        span(c, &lo[c], &hi[c]);
+    }
+
+    _tft.startWrite();
+    _tft.setAddrWindow(_x, _y, _w, _h);
+    for (int16_t r = _h - 1; r >= 0; r--) {
+        for (uint8_t c = 0; c < _w; c++) {
+            row[c] = (r >= lo[c] && r <= hi[c]) ? _fg : _bg;
+        }
+        _tft.writePixels(row, _w);
+    }
+    _tft.endWrite();
+}
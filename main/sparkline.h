@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Adafruit_SPITFT.h"
+
+/* Maximum size of a sparkline */
+#define SPARKLINE_MAX_W 128
+#define SPARKLINE_MAX_H 32
+
+/**
+ * @brief Sweeping line chart of the most recent values
+ *
+ * New values are drawn left to right, one pixel column each, wrapping
+ * around at the right edge like an oscilloscope. Each value redraws only
+ * its own column and clears the next one as a gap marking the write
+ * position, both in one address window, so the cost per value does not
+ * depend on the chart width. The vertical range starts at [0, max] and
+ * doubles whenever a value exceeds it, which is the only case that
+ * repaints the whole chart.
+ */
+class Sparkline {
+public:
+    /**
+     * @param tft Display to draw on
+     * @param x Left edge in pixels
+     * @param y Top edge in pixels
+     * @param w Width in pixels, capped to SPARKLINE_MAX_W
+     * @param h Height in pixels, capped to SPARKLINE_MAX_H
+     * @param max Initial top of the vertical range, must be > 0
+     * @param fg Line color
+     * @param bg Background color
+     */
+    Sparkline(Adafruit_SPITFT &tft, int16_t x, int16_t y, uint8_t w, uint8_t h,
+              float max, uint16_t fg, uint16_t bg);
+
+    /**
+     * @brief Append a value and draw its column
+     */
+    void add(float value);
+
+    /**
+     * @brief Repaint the whole chart from the stored values
+     */
+    void redraw();
+
+private:
+    /**
+     * @brief Row of a value, 0 is the bottom row
+     */
+    uint8_t level(float value) const;
+
+    /**
+     * @brief Rows covered by a column, the segment from the previous value to its own
+     *
+     * @param col Column
+     * @param lo Output, lowest row
+     * @param hi Output, highest row, below lo if the column is empty
+     */
+    void span(uint8_t col, int16_t *lo, int16_t *hi) const;
+
+    Adafruit_SPITFT &_tft;
+    int16_t _x;
+    int16_t _y;
+    uint8_t _w;
+    uint8_t _h;
+    float _max;
+    uint16_t _fg;
+    uint16_t _bg;
+    uint8_t _pos;                           /*!< Column of the next value */
+    uint8_t _count;                         /*!< Stored values, up to _w */
+    float _values[SPARKLINE_MAX_W];         /*!< Value per column */
+    uint8_t _levels[SPARKLINE_MAX_W];       /*!< Row per column, derived from _values */
+};
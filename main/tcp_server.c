@@ -6,98 +6,645 @@
 #include "lwip/netdb.h"
 #include "lwip/err.h"
 #include "lwip/sys.h"
+#include "esp_timer.h"
+#include <fcntl.h>
 #include <string.h>
 #include "variables.h"
+#include "sensor_scheduler.h"
+#include "sensor_stats.h"
+#include "sensor_events.h"
+#include "telemetry.h"
+#include "tslog.h"
+#include "power.h"
 
 /** @brief Logging tag for tcp_server*/
 static const char *TAG = "tcp";
 
 
+/** @brief Outgoing bytes of a connection, drained by non-blocking send() */
+typedef struct {
+    uint8_t buf[TCP_TX_RING_SIZE];
+    size_t head;                        /*!< Next byte to send */
+    size_t count;                       /*!< Bytes waiting */
+} tx_ring_t;
+
+/** @brief State of a connected client */
+typedef struct {
+    int sock;                           /*!< -1 if the slot is free */
+    uint8_t rx[TCP_RX_BUFFER_SIZE];     /*!< Received bytes, may hold a partial frame */
+    size_t rx_len;
+    tx_ring_t tx;
+    uint8_t frame[TLM_MAX_FRAME_SIZE];  /*!< Sample frame under construction */
+    tlm_batch_t batch;
+    uint32_t tx_seq;
+    uint32_t dropped_frames;
+    bool subscribed;
+    uint32_t channel_mask;
+    uint32_t period_us;
+    int64_t next_sample_us;
+    int64_t batch_start_us;
+    uint32_t alert_mask;                /*!< Channels whose events are pushed, 0 if none */
+    uint32_t alert_seq;                 /*!< Last event handled */
+    bool dumping;                       /*!< Log dump in progress */
+    uint32_t dump_seq;                  /*!< Next log block to send */
+    uint32_t dump_request;              /*!< Sequence number of the dump request, acked at the end */
+} client_t;
+
+/** @brief Client slots, served by the single server task */
+static client_t clients[TCP_MAX_CLIENTS];
+
+/** @brief Log block and its frame, shared by all clients of the server task */
+static uint8_t log_block[TSLOG_BLOCK_SIZE];
+static uint8_t log_frame[TLM_HEADER_SIZE + TSLOG_BLOCK_SIZE];
+
+
 /** -----------------------------------------------------------------------------------------------------------------------------------------------------------------*/
 
 
 /**
- * @brief Filters TCP message for TFT display
+ * @brief Cuts a TCP message at the first newline for the TFT display
  *
- * Copies input buffer until newline into output buffer for display.
+ * @param msg Null-terminated message, modified in place
+ */
+static void filter_tcp_msg(char *msg) {
+    char *newline = strchr(msg, '\n');
+    if (newline != NULL) {
+        *newline = '\0';
+    }
+}
+
+
+/**
+ * @brief Queues bytes for sending
  *
- * @param input Input TCP message
- * @param output Output buffer for TFT
+ * @param ring Transmit ring of the client
+ * @param data Bytes to send
+ * @param len Number of bytes
+ * @return false if the ring has no room, nothing is queued then
  */
-static void filter_tcp_msg(char* input, char* output, size_t output_size) {
-    size_t i = 0;
-    while (i < output_size - 1 && input[i] != '\n' && input[i] != '\0') {
-        output[i] = input[i];
-        i++;
+static bool tx_ring_push(tx_ring_t *ring, const uint8_t *data, size_t len)
+{
+    if (len > sizeof(ring->buf) - ring->count) {
+        return false;
     }
-    output[i] = '\0';
- }
+    size_t tail = (ring->head + ring->count) % sizeof(ring->buf);
+    size_t first = sizeof(ring->buf) - tail;
+    if (first > len) {
+        first = len;
+    }
+    memcpy(&ring->buf[tail], data, first);
+    memcpy(ring->buf, data + first, len - first);
+    ring->count += len;
+    return true;
+}
 
 
 /**
- * @brief Handles retransmission of TCP data
+ * @brief Sends as many queued bytes as the socket accepts without blocking
  *
- * Receives data from socket, filters it for display, notifies LCD task,
- * and sends back the same data to client.
+ * @param sock TCP socket descriptor, non-blocking
+ * @param ring Transmit ring of the client
+ * @return false if the socket failed
+ */
+static bool tx_ring_send(const int sock, tx_ring_t *ring)
+{
+    while (ring->count > 0) {
+        size_t span = sizeof(ring->buf) - ring->head;
+        if (span > ring->count) {
+            span = ring->count;
+        }
+        int written = send(sock, &ring->buf[ring->head], span, 0);
+        if (written < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return true;
+            }
+            ESP_LOGE(TAG, "Error occurred during sending: errno %d", errno);
+            return false;
+        }
+        ring->head = (ring->head + written) % sizeof(ring->buf);
+        ring->count -= written;
+    }
+    ring->head = 0;
+    return true;
+}
+
+
+/**
+ * @brief Queues the pending sample frame of a client
  *
- * @param sock TCP socket descriptor
- */ 
-static void do_retransmit(const int sock)
+ * If the client does not keep up the frame is dropped, the sequence number
+ * still advances so the client can detect the gap.
+ *
+ * @param client Connected client
+ */
+static void flush_samples(client_t *client)
 {
-    int len;
-    char rx_buffer[TFT_MSG_SIZE];
-    char msg[TFT_MSG_SIZE];
+    size_t len = tlm_batch_finish(&client->batch, client->tx_seq);
+    if (len == 0) {
+        return;
+    }
+    client->tx_seq++;
+    if (!tx_ring_push(&client->tx, client->frame, len)) {
+        client->dropped_frames++;
+    }
+    tlm_batch_init(&client->batch, client->frame, sizeof(client->frame));
+}
+
 
-    do {
-        len = recv(sock, rx_buffer, sizeof(rx_buffer) - 1, 0);
-        if (len < 0) {
-            ESP_LOGE(TAG, "Error occurred during receiving: errno %d", errno);
-        } else if (len == 0) {
-            ESP_LOGW(TAG, "Connection closed");
-        } else {
-            rx_buffer[len] = '\0'; // Null-terminate whatever is received and treat it like a string
-            filter_tcp_msg(rx_buffer, msg, TFT_MSG_SIZE);;
-            if(xQueueSend(tftQueue, &rx_buffer, portMAX_DELAY) != pdPASS) {
-                ESP_LOGW(TAG, "Failed to enqueue TFT message");
+/**
+ * @brief Adds the due snapshot samples to the pending frame
+ *
+ * Records are collected until the frame reaches TLM_MAX_FRAME_SIZE or is
+ * older than TLM_FLUSH_MS, so a fast stream needs one send() per segment.
+ *
+ * @param client Subscribed client
+ * @param now Current esp_timer time
+ */
+static void stream_samples(client_t *client, int64_t now)
+{
+    while (now >= client->next_sample_us) {
+        sensor_snapshot_t snapshot;
+        if (sensor_scheduler_get_snapshot(&snapshot)) {
+            uint32_t channels = snapshot.valid_mask & client->channel_mask;
+            for (uint8_t ch = 0; ch < SENSOR_CHANNEL_COUNT; ch++) {
+                if (!(channels & (1u << ch))) {
+                    continue;
+                }
+                tlm_record_t record = {
+                    .timestamp_ms = (uint32_t)(snapshot.timestamp_us[ch] / 1000),
+                    .channel = ch,
+                    .value = snapshot.values[ch],
+                };
+                if (client->batch.count == 0) {
+                    client->batch_start_us = now;
+                }
+                if (!tlm_batch_add(&client->batch, &record)) {
+                    flush_samples(client);
+                    client->batch_start_us = now;
+                    tlm_batch_add(&client->batch, &record);
+                }
             }
-            ESP_LOGI(TAG, "Received %d bytes: %s", len, rx_buffer);
-
-            // send() can return less bytes than supplied length.
-            // Walk-around for robust implementation.
-            int to_write = len;
-            while (to_write > 0) {
-                int written = send(sock, rx_buffer + (len - to_write), to_write, 0);
-                if (written < 0) {
-                    ESP_LOGE(TAG, "Error occurred during sending: errno %d", errno);
-                    // Failed to retransmit, giving up
-                    return;
+        }
+        client->next_sample_us += client->period_us;
+    }
+
+    if (client->batch.count > 0 && now - client->batch_start_us >= TLM_FLUSH_MS * 1000) {
+        flush_samples(client);
+    }
+}
+
+
+/**
+ * @brief Pushes the events since the last call to an alert subscriber
+ *
+ * Events that dropped out of the log before they could be sent are lost,
+ * the client sees the gap in the frame sequence numbers.
+ *
+ * @param client Client with alert_mask set
+ */
+static void push_alerts(client_t *client)
+{
+    uint32_t latest = sensor_events_latest();
+    while (client->alert_seq != latest) {
+        sensor_event_t event;
+        client->alert_seq++;
+        if (!sensor_events_get(client->alert_seq, &event) || !(client->alert_mask & (1u << event.channel))) {
+            continue;
+        }
+        tlm_alert_t alert = {
+            .timestamp_ms = event.timestamp_ms,
+            .channel = event.channel,
+            .start = event.start,
+            .value = event.value,
+            .baseline = event.baseline,
+            .score = event.score,
+        };
+        uint8_t frame[TLM_HEADER_SIZE + TLM_ALERT_SIZE];
+        size_t len = tlm_encode_alert(frame, event.seq, &alert);
+        if (!tx_ring_push(&client->tx, frame, len)) {
+            ESP_LOGW(TAG, "Client %d too slow, alert dropped", client->sock);
+        }
+    }
+}
+
+
+/**
+ * @brief Answers a request frame
+ *
+ * @param client Connected client
+ * @param seq Sequence number of the request
+ * @param status Result of the request
+ */
+static void send_ack(client_t *client, uint32_t seq, tlm_status_t status)
+{
+    uint8_t frame[TLM_HEADER_SIZE + 1];
+    uint8_t payload = status;
+    size_t len = tlm_encode_frame(frame, TLM_TYPE_ACK, seq, &payload, sizeof(payload));
+    if (!tx_ring_push(&client->tx, frame, len)) {
+        ESP_LOGW(TAG, "Client %d too slow, ack dropped", client->sock);
+    }
+}
+
+
+/**
+ * @brief Queues log blocks as long as the transmit ring has room
+ *
+ * Blocks go out as stored on flash, the client decodes them. The ack of
+ * the dump request marks the end.
+ *
+ * @param client Client with a dump in progress
+ */
+static void push_log(client_t *client)
+{
+    while (sizeof(client->tx.buf) - client->tx.count >= sizeof(log_frame)) {
+        if (!tslog_read(&client->dump_seq, log_block)) {
+            client->dumping = false;
+            send_ack(client, client->dump_request, TLM_STATUS_OK);
+            return;
+        }
+        // tslog_read() advanced past the block it returned
+        uint32_t seq = client->dump_seq - 1;
+        size_t len = tlm_encode_frame(log_frame, TLM_TYPE_LOG_BLOCK, seq, log_block, sizeof(log_block));
+        tx_ring_push(&client->tx, log_frame, len);
+    }
+}
+
+
+/**
+ * @brief Answers a stats request with the statistics of the selected channels
+ *
+ * Channels without samples are left out.
+ *
+ * @param client Connected client
+ * @param seq Sequence number of the request
+ * @param channel_mask Bit n selects sensor channel n
+ */
+static void send_stats(client_t *client, uint32_t seq, uint32_t channel_mask)
+{
+    tlm_stats_t records[SENSOR_CHANNEL_COUNT];
+    uint8_t frame[TLM_HEADER_SIZE + SENSOR_CHANNEL_COUNT * TLM_STATS_RECORD_SIZE];
+    uint8_t count = 0;
+
+    for (uint8_t ch = 0; ch < SENSOR_CHANNEL_COUNT; ch++) {
+        sensor_stats_t stats;
+        if (!(channel_mask & (1u << ch)) || !sensor_stats_get(ch, &stats)) {
+            continue;
+        }
+        records[count++] = (tlm_stats_t){
+            .channel = ch,
+            .count = stats.count,
+            .mean = stats.mean,
+            .stddev = stats.stddev,
+            .min = stats.min,
+            .max = stats.max,
+            .p50 = stats.p50,
+            .p95 = stats.p95,
+        };
+    }
+    size_t len = tlm_encode_stats(frame, seq, records, count);
+    if (!tx_ring_push(&client->tx, frame, len)) {
+        ESP_LOGW(TAG, "Client %d too slow, stats dropped", client->sock);
+    }
+}
+
+
+/**
+ * @brief Answers a power request with the wake and lease counters
+ *
+ * @param client Connected client
+ * @param seq Sequence number of the request
+ */
+static void send_power(client_t *client, uint32_t seq)
+{
+    power_counters_t counters;
+    power_get_counters(&counters);
+    tlm_power_t power = {
+        .full_wakes = counters.full_wakes,
+        .sample_wakes = counters.sample_wakes,
+        .awake_ms = counters.awake_ms,
+        .asleep_ms = counters.asleep_ms,
+        .wake_latency_us = counters.wake_latency_us,
+        .max_wake_latency_us = counters.max_wake_latency_us,
+        .sample_wake_us = counters.sample_wake_us,
+        .lease_mask = counters.lease_mask,
+        .lease_count = POWER_LEASE_COUNT,
+    };
+    memcpy(power.lease_ms, counters.lease_ms, sizeof(counters.lease_ms));
+
+    uint8_t frame[TLM_HEADER_SIZE + TLM_POWER_SIZE + 4 * POWER_LEASE_COUNT];
+    size_t len = tlm_encode_power(frame, seq, &power);
+    if (!tx_ring_push(&client->tx, frame, len)) {
+        ESP_LOGW(TAG, "Client %d too slow, power counters dropped", client->sock);
+    }
+}
+
+
+/**
+ * @brief Handles all complete binary frames in the receive buffer
+ *
+ * Incomplete frames stay in the buffer until the rest arrives.
+ *
+ * @param client Connected client
+ */
+static void handle_frames(client_t *client)
+{
+    tlm_header_t header;
+    size_t offset = 0;
+
+    while (offset < client->rx_len) {
+        tlm_parse_result_t result = tlm_parse_header(&client->rx[offset], client->rx_len - offset, &header);
+        if (result == TLM_PARSE_NEED_MORE && (offset > 0 || client->rx_len < sizeof(client->rx))) {
+            break;
+        }
+        if (result != TLM_PARSE_OK) {
+            ESP_LOGW(TAG, "Invalid telemetry frame, dropping %d bytes", (int)(client->rx_len - offset));
+            offset = client->rx_len;
+            send_ack(client, 0, TLM_STATUS_BAD_REQUEST);
+            break;
+        }
+
+        const uint8_t *payload = &client->rx[offset + TLM_HEADER_SIZE];
+        tlm_status_t status = TLM_STATUS_OK;
+        tlm_subscribe_t sub;
+        uint32_t mask;
+        uint64_t since_ms;
+
+        switch (header.type) {
+            case TLM_TYPE_SUBSCRIBE:
+                if (!tlm_decode_subscribe(payload, header.length, &sub)) {
+                    status = TLM_STATUS_BAD_REQUEST;
+                    break;
                 }
-                to_write -= written;
+                client->subscribed = true;
+                client->channel_mask = sub.channel_mask;
+                client->period_us = 1000000 / sub.rate_hz;
+                client->next_sample_us = esp_timer_get_time();
+                ESP_LOGI(TAG, "Client %d subscribed at %d Hz, channels 0x%lx", client->sock, sub.rate_hz, (unsigned long)sub.channel_mask);
+                break;
+
+            case TLM_TYPE_UNSUBSCRIBE:
+                flush_samples(client);
+                client->subscribed = false;
+                break;
+
+            case TLM_TYPE_STATS_REQUEST:
+                if (!tlm_decode_stats_request(payload, header.length, &mask)) {
+                    status = TLM_STATUS_BAD_REQUEST;
+                    break;
+                }
+                // The stats frame is the reply, no ack
+                send_stats(client, header.seq, mask);
+                offset += TLM_HEADER_SIZE + header.length;
+                continue;
+
+            case TLM_TYPE_ALERT_SUBSCRIBE:
+                if (!tlm_decode_alert_subscribe(payload, header.length, &mask)) {
+                    status = TLM_STATUS_BAD_REQUEST;
+                    break;
+                }
+                // Only events from now on
+                client->alert_mask = mask;
+                client->alert_seq = sensor_events_latest();
+                ESP_LOGI(TAG, "Client %d alerts for channels 0x%lx", client->sock, (unsigned long)mask);
+                break;
+
+            case TLM_TYPE_POWER_REQUEST:
+                // The power frame is the reply, no ack
+                send_power(client, header.seq);
+                offset += TLM_HEADER_SIZE + header.length;
+                continue;
+
+            case TLM_TYPE_LOG_DUMP:
+                if (!tlm_decode_log_dump(payload, header.length, &since_ms)) {
+                    status = TLM_STATUS_BAD_REQUEST;
+                    break;
+                }
+                // The blocks are the reply, the ack follows the last one
+                client->dumping = true;
+                client->dump_seq = tslog_find(since_ms);
+                client->dump_request = header.seq;
+                ESP_LOGI(TAG, "Client %d log dump from block %lu", client->sock, (unsigned long)client->dump_seq);
+                offset += TLM_HEADER_SIZE + header.length;
+                continue;
+
+            default:
+                status = TLM_STATUS_UNSUPPORTED;
+                break;
+        }
+        send_ack(client, header.seq, status);
+        offset += TLM_HEADER_SIZE + header.length;
+    }
+
+    client->rx_len -= offset;
+    memmove(client->rx, &client->rx[offset], client->rx_len);
+}
+
+
+/**
+ * @brief Handles a text message
+ *
+ * Sends the message back to the client and hands it to the display.
+ *
+ * @param client Connected client
+ * @param text Received bytes, null-terminated
+ * @param len Message length
+ * @param msg Pool slot holding text, TFT_MSG_NONE if the text is in the client buffer
+ */
+static void handle_text(client_t *client, char *text, int len, tft_msg_t msg)
+{
+    ESP_LOGI(TAG, "Received %d bytes from %d: %s", len, client->sock, text);
+
+    if (!tx_ring_push(&client->tx, (const uint8_t *)text, len)) {
+        ESP_LOGW(TAG, "Client %d too slow, echo dropped", client->sock);
+    }
+
+    if (msg == TFT_MSG_NONE) {
+        ESP_LOGW(TAG, "TFT message pool exhausted, message not shown");
+        return;
+    }
+    filter_tcp_msg(text);
+    if (!tft_msg_send(msg, 0)) {
+        ESP_LOGW(TAG, "Failed to enqueue TFT message");
+    }
+}
+
+
+/**
+ * @brief Checks the result of a failed recv()
+ *
+ * @param client Connected client
+ * @param len Result of recv(), 0 or negative
+ * @return false if the connection was closed or failed, true if there was no data
+ */
+static bool client_recv_failed(client_t *client, int len)
+{
+    if (len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        return true;
+    }
+    if (len < 0) {
+        ESP_LOGE(TAG, "Error occurred during receiving: errno %d", errno);
+    } else {
+        ESP_LOGW(TAG, "Connection %d closed", client->sock);
+    }
+    return false;
+}
+
+
+/**
+ * @brief Receives the available bytes of a client
+ *
+ * Text lines are shown on the display and sent back to the client.
+ * Binary telemetry frames (see telemetry.h) control the sample stream.
+ * The first byte of a new message tells them apart before it is read:
+ * frames go to the client buffer, text is received straight into a TFT
+ * pool slot and the display task renders it from there without copies.
+ *
+ * @param client Connected client
+ * @return false if the connection was closed or failed
+ */
+static bool client_receive(client_t *client)
+{
+    tft_msg_t msg = TFT_MSG_NONE;
+    uint8_t *buffer = &client->rx[client->rx_len];
+    size_t space = sizeof(client->rx) - client->rx_len;
+    bool text = false;
+
+    // Text messages keep the size of a TFT message, binary frames may span several reads
+    if (client->rx_len == 0) {
+        uint8_t first;
+        int len = recv(client->sock, &first, 1, MSG_PEEK);
+        if (len <= 0) {
+            return client_recv_failed(client, len);
+        }
+        if (first != TLM_MAGIC0) {
+            text = true;
+            msg = tft_msg_alloc();
+            if (msg != TFT_MSG_NONE) {
+                buffer = (uint8_t *)tft_msg_data(msg);
             }
+            space = TFT_MSG_SIZE - 1;
+        }
+    }
+
+    int len = recv(client->sock, buffer, space, 0);
+    if (len <= 0) {
+        if (msg != TFT_MSG_NONE) {
+            tft_msg_release(msg);
+        }
+        return client_recv_failed(client, len);
+    }
+
+    if (text) {
+        buffer[len] = '\0'; // Null-terminate whatever is received and treat it like a string
+        handle_text(client, (char *)buffer, len, msg);
+    } else {
+        client->rx_len += len;
+        handle_frames(client);
+    }
+    return true;
+}
+
+
+/**
+ * @brief Takes a new connection into a free client slot
+ *
+ * @param listen_sock Listening socket
+ */
+static void accept_client(const int listen_sock)
+{
+    char addr_str[128];
+    int keepAlive = 1;
+    int keepIdle = KEEPALIVE_IDLE;
+    int keepInterval = KEEPALIVE_INTERVAL;
+    int keepCount = KEEPALIVE_COUNT;
+    struct sockaddr_storage source_addr; // Large enough for both IPv4 or IPv6
+    socklen_t addr_len = sizeof(source_addr);
+
+    int sock = accept(listen_sock, (struct sockaddr *)&source_addr, &addr_len);
+    if (sock < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            ESP_LOGE(TAG, "Unable to accept connection: errno %d", errno);
+        }
+        return;
+    }
+
+    client_t *client = NULL;
+    for (int i = 0; i < TCP_MAX_CLIENTS; i++) {
+        if (clients[i].sock < 0) {
+            client = &clients[i];
+            break;
         }
-    } while (len > 0);
+    }
+    if (client == NULL) {
+        ESP_LOGW(TAG, "All %d client slots in use, rejecting connection", TCP_MAX_CLIENTS);
+        close(sock);
+        return;
+    }
+
+    // Set tcp keepalive option
+    setsockopt(sock, SOL_SOCKET, SO_KEEPALIVE, &keepAlive, sizeof(int));
+    setsockopt(sock, IPPROTO_TCP, TCP_KEEPIDLE, &keepIdle, sizeof(int));
+    setsockopt(sock, IPPROTO_TCP, TCP_KEEPINTVL, &keepInterval, sizeof(int));
+    setsockopt(sock, IPPROTO_TCP, TCP_KEEPCNT, &keepCount, sizeof(int));
+    fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+    // Convert ip address to string
+    addr_str[0] = '\0';
+#ifdef CONFIG_EXAMPLE_IPV4
+    if (source_addr.ss_family == PF_INET) {
+        inet_ntoa_r(((struct sockaddr_in *)&source_addr)->sin_addr, addr_str, sizeof(addr_str) - 1);
+    }
+#endif
+#ifdef CONFIG_EXAMPLE_IPV6
+    if (source_addr.ss_family == PF_INET6) {
+        inet6_ntoa_r(((struct sockaddr_in6 *)&source_addr)->sin6_addr, addr_str, sizeof(addr_str) - 1);
+    }
+#endif
+    ESP_LOGI(TAG, "Socket %d accepted ip address: %s", sock, addr_str);
+
+    memset(client, 0, sizeof(*client));
+    client->sock = sock;
+    power_acquire(POWER_LEASE_TCP);
+    tlm_batch_init(&client->batch, client->frame, sizeof(client->frame));
+}
+
+
+/**
+ * @brief Closes a connection and frees its slot
+ *
+ * @param client Connected client
+ */
+static void close_client(client_t *client)
+{
+    if (client->dropped_frames > 0) {
+        ESP_LOGW(TAG, "Client %d dropped %lu frames", client->sock, (unsigned long)client->dropped_frames);
+    }
+    shutdown(client->sock, 0);
+    close(client->sock);
+    client->sock = -1;
+    power_release(POWER_LEASE_TCP);
 }
 
 
 /**
  * @brief TCP server task
  *
- * Creates a listening socket, accepts client connections, sets TCP keepalive,
- * and handles incoming messages.
+ * Creates a listening socket and serves up to TCP_MAX_CLIENTS connections
+ * with select(). All sockets are non-blocking, a client whose transmit ring
+ * is more than half full is not read until it has caught up.
  *
  * @param pvParameters Pointer to address family (AF_INET or AF_INET6)
  */
 static void tcp_server_task(void *pvParameters)
 {
-    char addr_str[128];
     int addr_family = (int)pvParameters;
     int ip_protocol = 0;
-    int keepAlive = 1;
-    int keepIdle = KEEPALIVE_IDLE;
-    int keepInterval = KEEPALIVE_INTERVAL;
-    int keepCount = KEEPALIVE_COUNT;
+    int event_fd = sensor_events_fd();
     struct sockaddr_storage dest_addr;
 
+    for (int i = 0; i < TCP_MAX_CLIENTS; i++) {
+        clients[i].sock = -1;
+    }
+
 #ifdef CONFIG_EXAMPLE_IPV4
     if (addr_family == AF_INET) {
         struct sockaddr_in *dest_addr_ip4 = (struct sockaddr_in *)&dest_addr;
@@ -130,6 +677,7 @@ static void tcp_server_task(void *pvParameters)
     // if both protocols used at the same time (used in CI)
     setsockopt(listen_sock, IPPROTO_IPV6, IPV6_V6ONLY, &opt, sizeof(opt));
 #endif
+    fcntl(listen_sock, F_SETFL, fcntl(listen_sock, F_GETFL, 0) | O_NONBLOCK);
 
     ESP_LOGI(TAG, "Socket created");
 
@@ -141,46 +689,95 @@ static void tcp_server_task(void *pvParameters)
     }
     ESP_LOGI(TAG, "Socket bound, port %d", PORT);
 
-    err = listen(listen_sock, 1);
+    err = listen(listen_sock, TCP_MAX_CLIENTS);
     if (err != 0) {
         ESP_LOGE(TAG, "Error occurred during listen: errno %d", errno);
         goto CLEAN_UP;
     }
+    ESP_LOGI(TAG, "Socket listening");
 
     while (1) {
+        fd_set read_fds;
+        fd_set write_fds;
+        int max_fd = listen_sock;
+        bool streaming = false;
 
-        ESP_LOGI(TAG, "Socket listening");
+        FD_ZERO(&read_fds);
+        FD_ZERO(&write_fds);
+        FD_SET(listen_sock, &read_fds);
+        if (event_fd >= 0) {
+            FD_SET(event_fd, &read_fds);
+            if (event_fd > max_fd) {
+                max_fd = event_fd;
+            }
+        }
+        for (int i = 0; i < TCP_MAX_CLIENTS; i++) {
+            client_t *client = &clients[i];
+            if (client->sock < 0) {
+                continue;
+            }
+            // Backpressure: stop reading requests while the replies pile up
+            if (client->tx.count <= sizeof(client->tx.buf) / 2) {
+                FD_SET(client->sock, &read_fds);
+            }
+            if (client->tx.count > 0) {
+                FD_SET(client->sock, &write_fds);
+            }
+            if (client->sock > max_fd) {
+                max_fd = client->sock;
+            }
+            streaming |= client->subscribed || client->dumping || (client->alert_mask && event_fd < 0);
+        }
 
-        struct sockaddr_storage source_addr; // Large enough for both IPv4 or IPv6
-        socklen_t addr_len = sizeof(source_addr);
-        int sock = accept(listen_sock, (struct sockaddr *)&source_addr, &addr_len);
-        if (sock < 0) {
-            ESP_LOGE(TAG, "Unable to accept connection: errno %d", errno);
+        // Streaming and dumping clients need a periodic wake up, otherwise wait for socket and sensor events
+        struct timeval timeout = { .tv_sec = 0, .tv_usec = TLM_POLL_MS * 1000 };
+        int ready = select(max_fd + 1, &read_fds, &write_fds, NULL, streaming ? &timeout : NULL);
+        if (ready < 0) {
+            ESP_LOGE(TAG, "Error occurred during select: errno %d", errno);
             break;
         }
 
-        // Set tcp keepalive option
-        setsockopt(sock, SOL_SOCKET, SO_KEEPALIVE, &keepAlive, sizeof(int));
-        setsockopt(sock, IPPROTO_TCP, TCP_KEEPIDLE, &keepIdle, sizeof(int));
-        setsockopt(sock, IPPROTO_TCP, TCP_KEEPINTVL, &keepInterval, sizeof(int));
-        setsockopt(sock, IPPROTO_TCP, TCP_KEEPCNT, &keepCount, sizeof(int));
-        // Convert ip address to string
-#ifdef CONFIG_EXAMPLE_IPV4
-        if (source_addr.ss_family == PF_INET) {
-            inet_ntoa_r(((struct sockaddr_in *)&source_addr)->sin_addr, addr_str, sizeof(addr_str) - 1);
+        if (FD_ISSET(listen_sock, &read_fds)) {
+            accept_client(listen_sock);
         }
-#endif
-#ifdef CONFIG_EXAMPLE_IPV6
-        if (source_addr.ss_family == PF_INET6) {
-            inet6_ntoa_r(((struct sockaddr_in6 *)&source_addr)->sin6_addr, addr_str, sizeof(addr_str) - 1);
+        // The alerts themselves are taken from the event log below
+        if (event_fd >= 0 && FD_ISSET(event_fd, &read_fds)) {
+            uint64_t events;
+            read(event_fd, &events, sizeof(events));
         }
-#endif
-        ESP_LOGI(TAG, "Socket accepted ip address: %s", addr_str);
 
-        do_retransmit(sock);
+        int64_t now = esp_timer_get_time();
+        for (int i = 0; i < TCP_MAX_CLIENTS; i++) {
+            client_t *client = &clients[i];
+            if (client->sock < 0) {
+                continue;
+            }
+            bool ok = true;
+            if (FD_ISSET(client->sock, &read_fds)) {
+                ok = client_receive(client);
+            }
+            if (ok && client->subscribed) {
+                stream_samples(client, now);
+            }
+            if (ok && client->alert_mask) {
+                push_alerts(client);
+            }
+            if (ok && client->dumping) {
+                push_log(client);
+            }
+            if (ok && client->tx.count > 0) {
+                ok = tx_ring_send(client->sock, &client->tx);
+            }
+            if (!ok) {
+                close_client(client);
+            }
+        }
+    }
 
-        shutdown(sock, 0);
-        close(sock);
+    for (int i = 0; i < TCP_MAX_CLIENTS; i++) {
+        if (clients[i].sock >= 0) {
+            close_client(&clients[i]);
+        }
     }
 
 CLEAN_UP:
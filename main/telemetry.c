@@ -0,0 +1,218 @@
+#include "telemetry.h"
+#include <string.h>
+
+
+/** -----------------------------------------------------------------------------------------------------------------------------------------------------------------*/
+
+
+/** @brief Little endian helpers, the wire format does not depend on the host */
+static void put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint16_t get_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+
+/**
+ * @brief Writes a frame header
+ *
+ * @param buf Output, TLM_HEADER_SIZE bytes
+ * @param type Frame type
+ * @param seq Sequence number
+ * @param len Payload length
+ */
+static void write_header(uint8_t *buf, uint8_t type, uint32_t seq, uint16_t len)
+{
+    buf[0] = TLM_MAGIC0;
+    buf[1] = TLM_MAGIC1;
+    buf[2] = TLM_VERSION;
+    buf[3] = type;
+    put_u16(&buf[4], len);
+    put_u16(&buf[6], 0);
+    put_u32(&buf[8], seq);
+}
+
+
+tlm_parse_result_t tlm_parse_header(const uint8_t *data, size_t len, tlm_header_t *header)
+{
+    if (len < 1 || data[0] != TLM_MAGIC0 || (len >= 2 && data[1] != TLM_MAGIC1)) {
+        return TLM_PARSE_BAD;
+    }
+    if (len < TLM_HEADER_SIZE) {
+        return TLM_PARSE_NEED_MORE;
+    }
+    header->version = data[2];
+    header->type = data[3];
+    header->length = get_u16(&data[4]);
+    header->seq = get_u32(&data[8]);
+    if (header->version != TLM_VERSION || header->length > TLM_MAX_PAYLOAD) {
+        return TLM_PARSE_BAD;
+    }
+    if (len < TLM_HEADER_SIZE + (size_t)header->length) {
+        return TLM_PARSE_NEED_MORE;
+    }
+    return TLM_PARSE_OK;
+}
+
+
+bool tlm_decode_subscribe(const uint8_t *payload, size_t len, tlm_subscribe_t *sub)
+{
+    if (len != 6) {
+        return false;
+    }
+    sub->rate_hz = get_u16(&payload[0]);
+    sub->channel_mask = get_u32(&payload[2]);
+    return sub->rate_hz > 0 && sub->rate_hz <= TLM_MAX_RATE_HZ;
+}
+
+
+bool tlm_decode_stats_request(const uint8_t *payload, size_t len, uint32_t *channel_mask)
+{
+    if (len != 4) {
+        return false;
+    }
+    *channel_mask = get_u32(payload);
+    return true;
+}
+
+
+size_t tlm_encode_stats(uint8_t *buf, uint32_t seq, const tlm_stats_t *stats, uint8_t count)
+{
+    uint8_t *p = &buf[TLM_HEADER_SIZE];
+    for (uint8_t i = 0; i < count; i++) {
+        const float values[6] = {
+            stats[i].mean, stats[i].stddev, stats[i].min, stats[i].max, stats[i].p50, stats[i].p95,
+        };
+        p[0] = stats[i].channel;
+        put_u32(&p[1], stats[i].count);
+        for (int v = 0; v < 6; v++) {
+            uint32_t bits;
+            memcpy(&bits, &values[v], sizeof(bits));
+            put_u32(&p[5 + 4 * v], bits);
+        }
+        p += TLM_STATS_RECORD_SIZE;
+    }
+    uint16_t len = (uint16_t)(count * TLM_STATS_RECORD_SIZE);
+    write_header(buf, TLM_TYPE_STATS, seq, len);
+    return TLM_HEADER_SIZE + len;
+}
+
+
+bool tlm_decode_alert_subscribe(const uint8_t *payload, size_t len, uint32_t *channel_mask)
+{
+    return tlm_decode_stats_request(payload, len, channel_mask);
+}
+
+
+size_t tlm_encode_alert(uint8_t *buf, uint32_t seq, const tlm_alert_t *alert)
+{
+    uint8_t *p = &buf[TLM_HEADER_SIZE];
+    const float values[3] = {alert->value, alert->baseline, alert->score};
+    put_u32(&p[0], alert->timestamp_ms);
+    p[4] = alert->channel;
+    p[5] = alert->start;
+    for (int v = 0; v < 3; v++) {
+        uint32_t bits;
+        memcpy(&bits, &values[v], sizeof(bits));
+        put_u32(&p[6 + 4 * v], bits);
+    }
+    write_header(buf, TLM_TYPE_ALERT, seq, TLM_ALERT_SIZE);
+    return TLM_HEADER_SIZE + TLM_ALERT_SIZE;
+}
+
+
+size_t tlm_encode_power(uint8_t *buf, uint32_t seq, const tlm_power_t *power)
+{
+    uint8_t *p = &buf[TLM_HEADER_SIZE];
+    put_u32(&p[0], power->full_wakes);
+    put_u32(&p[4], power->sample_wakes);
+    put_u32(&p[8], (uint32_t)power->awake_ms);
+    put_u32(&p[12], (uint32_t)(power->awake_ms >> 32));
+    put_u32(&p[16], (uint32_t)power->asleep_ms);
+    put_u32(&p[20], (uint32_t)(power->asleep_ms >> 32));
+    put_u32(&p[24], power->wake_latency_us);
+    put_u32(&p[28], power->max_wake_latency_us);
+    put_u32(&p[32], power->sample_wake_us);
+    p[36] = power->lease_mask;
+    p[37] = power->lease_count;
+    for (uint8_t i = 0; i < power->lease_count; i++) {
+        put_u32(&p[TLM_POWER_SIZE + 4 * i], power->lease_ms[i]);
+    }
+    uint16_t len = (uint16_t)(TLM_POWER_SIZE + 4 * power->lease_count);
+    write_header(buf, TLM_TYPE_POWER, seq, len);
+    return TLM_HEADER_SIZE + len;
+}
+
+
+bool tlm_decode_log_dump(const uint8_t *payload, size_t len, uint64_t *since_ms)
+{
+    if (len != 8) {
+        return false;
+    }
+    *since_ms = (uint64_t)get_u32(&payload[0]) | ((uint64_t)get_u32(&payload[4]) << 32);
+    return true;
+}
+
+
+size_t tlm_encode_frame(uint8_t *buf, uint8_t type, uint32_t seq, const void *payload, uint16_t len)
+{
+    write_header(buf, type, seq, len);
+    if (len > 0) {
+        memcpy(&buf[TLM_HEADER_SIZE], payload, len);
+    }
+    return TLM_HEADER_SIZE + len;
+}
+
+
+void tlm_batch_init(tlm_batch_t *batch, uint8_t *buf, size_t capacity)
+{
+    batch->buf = buf;
+    batch->capacity = capacity < TLM_MAX_FRAME_SIZE ? capacity : TLM_MAX_FRAME_SIZE;
+    batch->length = TLM_HEADER_SIZE;
+    batch->count = 0;
+}
+
+
+bool tlm_batch_add(tlm_batch_t *batch, const tlm_record_t *record)
+{
+    if (batch->length + TLM_RECORD_SIZE > batch->capacity) {
+        return false;
+    }
+    uint8_t *p = &batch->buf[batch->length];
+    uint32_t value;
+    memcpy(&value, &record->value, sizeof(value));
+    put_u32(&p[0], record->timestamp_ms);
+    p[4] = record->channel;
+    put_u32(&p[5], value);
+    batch->length += TLM_RECORD_SIZE;
+    batch->count++;
+    return true;
+}
+
+
+size_t tlm_batch_finish(tlm_batch_t *batch, uint32_t seq)
+{
+    if (batch->count == 0) {
+        return 0;
+    }
+    write_header(batch->buf, TLM_TYPE_SAMPLES, seq, (uint16_t)(batch->length - TLM_HEADER_SIZE));
+    return batch->length;
+}
@@ -0,0 +1,243 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Binary telemetry framing on the TCP port.
+ *
+ * Every frame starts with a 12 byte header, all fields little endian:
+ *
+ *   0  uint8   magic 0xA5
+ *   1  uint8   magic 0x5A
+ *   2  uint8   protocol version
+ *   3  uint8   frame type (tlm_type_t)
+ *   4  uint16  payload length in bytes
+ *   6  uint16  reserved, 0
+ *   8  uint32  sequence number
+ *
+ * The magic bytes are not valid ASCII, so binary frames and plain text
+ * lines can share the port.
+ *
+ * This file has no ESP-IDF dependencies and builds on the host as well.
+ */
+
+/* Framing parameters */
+#define TLM_MAGIC0              0xA5
+#define TLM_MAGIC1              0x5A
+#define TLM_VERSION             1
+#define TLM_HEADER_SIZE         12
+#define TLM_RECORD_SIZE         9
+#define TLM_STATS_RECORD_SIZE   29
+#define TLM_ALERT_SIZE          18
+#define TLM_POWER_SIZE          38      /*!< Without the lease times */
+#define TLM_POWER_MAX_LEASES    8
+#define TLM_MAX_FRAME_SIZE      1440    /*!< One TCP segment with the default lwIP MSS */
+#define TLM_MAX_PAYLOAD         (TLM_MAX_FRAME_SIZE - TLM_HEADER_SIZE)
+#define TLM_MAX_RECORDS         (TLM_MAX_PAYLOAD / TLM_RECORD_SIZE)
+#define TLM_MAX_RATE_HZ         1000
+
+/** @brief Frame types */
+typedef enum {
+    TLM_TYPE_SUBSCRIBE = 0x01,      /*!< Client: start or change the sample stream, payload tlm_subscribe_t */
+    TLM_TYPE_UNSUBSCRIBE = 0x02,    /*!< Client: stop the sample stream, no payload */
+    TLM_TYPE_STATS_REQUEST = 0x03,  /*!< Client: query channel statistics, payload uint32 channel mask */
+    TLM_TYPE_ALERT_SUBSCRIBE = 0x04, /*!< Client: push events of the channels in the uint32 mask, 0 stops */
+    TLM_TYPE_LOG_DUMP = 0x05,       /*!< Client: send the logged blocks since the uint64 time in ms */
+    TLM_TYPE_POWER_REQUEST = 0x06,  /*!< Client: query the power counters, no payload */
+    TLM_TYPE_SAMPLES = 0x81,        /*!< Device: packed sample records */
+    TLM_TYPE_ACK = 0x82,            /*!< Device: reply to a request, payload uint8 status */
+    TLM_TYPE_STATS = 0x83,          /*!< Device: reply to a stats request, packed stats records */
+    TLM_TYPE_ALERT = 0x84,          /*!< Device: start or end of an event, payload tlm_alert_t, seq is the event number */
+    TLM_TYPE_LOG_BLOCK = 0x85,      /*!< Device: one log block as stored (tslog_codec.h), seq is the block number */
+    TLM_TYPE_POWER = 0x86,          /*!< Device: reply to a power request, payload tlm_power_t */
+} tlm_type_t;
+
+/** @brief Status codes of an ACK frame */
+typedef enum {
+    TLM_STATUS_OK = 0,
+    TLM_STATUS_BAD_REQUEST = 1,
+    TLM_STATUS_UNSUPPORTED = 2,
+} tlm_status_t;
+
+/** @brief Decoded frame header */
+typedef struct {
+    uint8_t version;
+    uint8_t type;
+    uint16_t length;
+    uint32_t seq;
+} tlm_header_t;
+
+/** @brief Payload of TLM_TYPE_SUBSCRIBE (6 bytes: uint16 rate, uint32 mask) */
+typedef struct {
+    uint16_t rate_hz;           /*!< Snapshot samples per second, 1 - TLM_MAX_RATE_HZ */
+    uint32_t channel_mask;      /*!< Bit n selects sensor channel n */
+} tlm_subscribe_t;
+
+/** @brief One sample record (9 bytes: uint32 time, uint8 channel, float value) */
+typedef struct {
+    uint32_t timestamp_ms;
+    uint8_t channel;
+    float value;
+} tlm_record_t;
+
+/** @brief One stats record (29 bytes: uint8 channel, uint32 count, float mean, stddev, min, max, p50, p95) */
+typedef struct {
+    uint8_t channel;
+    uint32_t count;             /*!< Samples in the window */
+    float mean;
+    float stddev;
+    float min;
+    float max;
+    float p50;                  /*!< Estimates over all samples since boot */
+    float p95;
+} tlm_stats_t;
+
+/** @brief Payload of TLM_TYPE_ALERT (18 bytes: uint32 time, uint8 channel, uint8 state, float value, baseline, score) */
+typedef struct {
+    uint32_t timestamp_ms;
+    uint8_t channel;
+    uint8_t start;              /*!< 1 when the event started, 0 when it ended */
+    float value;                /*!< Triggering sample at the start, peak at the end */
+    float baseline;
+    float score;                /*!< Detector score in baseline standard deviations */
+} tlm_alert_t;
+
+/**
+ * @brief Payload of TLM_TYPE_POWER (38 + 4 * lease_count bytes: uint32 full wakes, sample wakes,
+ *        uint64 awake ms, asleep ms, uint32 wake latency, max wake latency, sample wake time in us,
+ *        uint8 lease mask, lease count, uint32 ms per lease)
+ */
+typedef struct {
+    uint32_t full_wakes;
+    uint32_t sample_wakes;
+    uint64_t awake_ms;
+    uint64_t asleep_ms;
+    uint32_t wake_latency_us;
+    uint32_t max_wake_latency_us;
+    uint32_t sample_wake_us;
+    uint8_t lease_mask;         /*!< Leases held right now */
+    uint8_t lease_count;
+    uint32_t lease_ms[TLM_POWER_MAX_LEASES];    /*!< Time each lease was held */
+} tlm_power_t;
+
+/** @brief Result of tlm_parse_header() */
+typedef enum {
+    TLM_PARSE_OK = 0,           /*!< Header and complete payload available */
+    TLM_PARSE_NEED_MORE,        /*!< Frame incomplete, wait for more bytes */
+    TLM_PARSE_BAD,              /*!< No valid frame at the buffer start */
+} tlm_parse_result_t;
+
+/** @brief Frame under construction, records are packed directly into buf */
+typedef struct {
+    uint8_t *buf;
+    size_t capacity;
+    size_t length;
+    uint16_t count;
+} tlm_batch_t;
+
+/**
+ * @brief Parse the frame at the start of a receive buffer
+ *
+ * @param data Received bytes
+ * @param len Number of bytes in data
+ * @param header Output, valid if TLM_PARSE_OK is returned
+ * @return Parse result
+ */
+tlm_parse_result_t tlm_parse_header(const uint8_t *data, size_t len, tlm_header_t *header);
+
+/**
+ * @brief Decode the payload of a subscribe frame
+ *
+ * @return false if the payload is malformed or the rate out of range
+ */
+bool tlm_decode_subscribe(const uint8_t *payload, size_t len, tlm_subscribe_t *sub);
+
+/**
+ * @brief Decode the payload of a stats request frame
+ *
+ * @param channel_mask Output, bit n selects sensor channel n
+ * @return false if the payload is malformed
+ */
+bool tlm_decode_stats_request(const uint8_t *payload, size_t len, uint32_t *channel_mask);
+
+/**
+ * @brief Write a stats frame
+ *
+ * @param buf Output, TLM_HEADER_SIZE + count * TLM_STATS_RECORD_SIZE bytes
+ * @param seq Sequence number of the request
+ * @param stats Records to send
+ * @param count Number of records
+ * @return Frame size in bytes
+ */
+size_t tlm_encode_stats(uint8_t *buf, uint32_t seq, const tlm_stats_t *stats, uint8_t count);
+
+/**
+ * @brief Decode the payload of an alert subscribe frame
+ *
+ * @param channel_mask Output, bit n selects sensor channel n, 0 unsubscribes
+ * @return false if the payload is malformed
+ */
+bool tlm_decode_alert_subscribe(const uint8_t *payload, size_t len, uint32_t *channel_mask);
+
+/**
+ * @brief Write an alert frame
+ *
+ * @param buf Output, TLM_HEADER_SIZE + TLM_ALERT_SIZE bytes
+ * @param seq Event number
+ * @return Frame size in bytes
+ */
+size_t tlm_encode_alert(uint8_t *buf, uint32_t seq, const tlm_alert_t *alert);
+
+/**
+ * @brief Write a power frame
+ *
+ * @param buf Output, TLM_HEADER_SIZE + TLM_POWER_SIZE + 4 * lease_count bytes
+ * @param seq Sequence number of the request
+ * @return Frame size in bytes
+ */
+size_t tlm_encode_power(uint8_t *buf, uint32_t seq, const tlm_power_t *power);
+
+/**
+ * @brief Decode the payload of a log dump frame
+ *
+ * @param since_ms Output, time of the first row of interest
+ * @return false if the payload is malformed
+ */
+bool tlm_decode_log_dump(const uint8_t *payload, size_t len, uint64_t *since_ms);
+
+/**
+ * @brief Write a complete frame
+ *
+ * @param buf Output, TLM_HEADER_SIZE + len bytes
+ * @return Frame size in bytes
+ */
+size_t tlm_encode_frame(uint8_t *buf, uint8_t type, uint32_t seq, const void *payload, uint16_t len);
+
+/**
+ * @brief Start a sample frame in buf, capacity is capped to TLM_MAX_FRAME_SIZE
+ */
+void tlm_batch_init(tlm_batch_t *batch, uint8_t *buf, size_t capacity);
+
+/**
+ * @brief Append one record
+ *
+ * @return false if the frame is full
+ */
+bool tlm_batch_add(tlm_batch_t *batch, const tlm_record_t *record);
+
+/**
+ * @brief Write the header of a sample frame
+ *
+ * @return Frame size in bytes, 0 if the frame holds no records
+ */
+size_t tlm_batch_finish(tlm_batch_t *batch, uint32_t seq);
+
+#ifdef __cplusplus
+}
+#endif
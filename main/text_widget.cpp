@@ -0,0 +1,130 @@
+#include "text_widget.h"
+#include <string.h>
+
+
+/** @brief Cell size of the classic font at size 1 */
+#define CELL_W 6
+#define CELL_H 8
+
+
+TextField::TextField(Adafruit_GFX &gfx, int16_t x, int16_t y, uint8_t cols, uint8_t rows,
+                     uint8_t size, uint16_t fg, uint16_t bg)
+    : _gfx(gfx), _x(x), _y(y), _cols(cols), _rows(rows), _size(size), _fg(fg), _bg(bg)
+{
+    if (_cols * _rows > TEXT_FIELD_MAX_CELLS) {
+        _rows = TEXT_FIELD_MAX_CELLS / _cols;
+    }
+    // The field starts on a cleared background
+    memset(_shown, ' ', sizeof(_shown));
+}
+
+
+uint16_t TextField::setText(const char *text)
+{
+    uint16_t redrawn = 0;
+    uint16_t cells = _cols * _rows;
+    uint16_t cell = 0;
+
+    while (cell < cells) {
+        char c = ' ';
+        if (*text == '\n') {
+            // Blank the rest of the row
+            text++;
+            uint16_t row_end = (cell / _cols + 1) * _cols;
+            while (cell < row_end && cell < cells) {
+                redrawn += updateCell(cell++, ' ');
+            }
+            continue;
+        }
+        if (*text != '\0') {
+            c = *text++;
+        }
+        redrawn += updateCell(cell++, c);
+    }
+    return redrawn;
+}
+
+
+bool TextField::updateCell(uint16_t cell, char c)
+{
+    if (_shown[cell] == c) {
+        return false;
+    }
+    // drawChar() with a background color different from the text color paints the whole cell
+    _gfx.drawChar(_x + (cell % _cols) * CELL_W * _size, _y + (cell / _cols) * CELL_H * _size,
+                  c, _fg, _bg, _size);
+    _shown[cell] = c;
+    return true;
+}
+
+
+void TextField::setColor(uint16_t fg, uint16_t bg)
+{
+    _fg = fg;
+    _bg = bg;
+    invalidate();
+}
+
+
+void TextField::invalidate()
+{
+    memset(_shown, 0, sizeof(_shown));
+}
+
+
+NumberField::NumberField(Adafruit_GFX &gfx, int16_t x, int16_t baseline, uint8_t cols,
+                         const GFXaafont *font, uint16_t fg, uint16_t bg)
+    : _gfx(gfx), _font(font), _x(x), _baseline(baseline), _cols(cols), _fg(fg), _bg(bg)
+{
+    if (_cols > TEXT_FIELD_MAX_CELLS) {
+        _cols = TEXT_FIELD_MAX_CELLS;
+    }
+    _cellW = Adafruit_GFX::getAATextWidth("0", font);
+    memset(_shown, ' ', sizeof(_shown));
+}
+
+
+uint16_t NumberField::setText(const char *text)
+{
+    uint16_t redrawn = 0;
+    size_t len = strlen(text);
+    if (len > _cols) {
+        text += len - _cols;
+        len = _cols;
+    }
+    int16_t top = _baseline + 1 - _font->ascent;
+
+    for (uint8_t cell = 0; cell < _cols; cell++) {
+        char c = (cell < _cols - len) ? ' ' : text[cell - (_cols - len)];
+        if (c < _font->first || c > _font->last) {
+            c = ' ';
+        }
+        if (_shown[cell] == c) {
+            continue;
+        }
+        int16_t x = _x + cell * _cellW;
+        if (c == ' ') {
+            _gfx.fillRect(x, top, _cellW, _font->yAdvance, _bg);
+        } else {
+            const char str[2] = {c, '\0'};
+            _gfx.drawAAText(x, _baseline, str, _font, _fg, _bg);
+        }
+        _shown[cell] = c;
+        redrawn++;
+    }
+    return redrawn;
+}
+
+
+void NumberField::setColor(uint16_t fg, uint16_t bg)
+{
+    _fg = fg;
+    _bg = bg;
+    invalidate();
+}
+
+
+void NumberField::invalidate()
+{
+    memset(_shown, 0, sizeof(_shown));
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "Adafruit_GFX.h"
+
+/* Maximum number of character cells of one text field */
+#define TEXT_FIELD_MAX_CELLS 64
+
+/**
+ * @brief Retained-mode text field for the classic 6x8 font
+ *
+ * Remembers the character drawn in every cell of a fixed grid and redraws
+ * only the cells whose character changed. Characters are drawn with an
+ * opaque background, so no separate clear is needed and the field does
+ * not flicker.
+ */
+class TextField {
+public:
+    /**
+     * @param gfx Display to draw on
+     * @param x Left edge in pixels
+     * @param y Top edge in pixels
+     * @param cols Characters per row
+     * @param rows Number of rows, cols * rows is capped to TEXT_FIELD_MAX_CELLS
+     * @param size Text magnification
+     * @param fg Text color
+     * @param bg Background color, must match the area the field is placed on initially
+     */
+    TextField(Adafruit_GFX &gfx, int16_t x, int16_t y, uint8_t cols, uint8_t rows,
+              uint8_t size, uint16_t fg, uint16_t bg);
+
+    /**
+     * @brief Show a new text
+     *
+     * The text fills the grid row by row, a newline continues in the next row.
+     * Text beyond the last cell is cut off, unused cells are cleared.
+     *
+     * @param text Null-terminated text
+     * @return Number of redrawn cells
+     */
+    uint16_t setText(const char *text);
+
+    /**
+     * @brief Change the colors, the next setText() redraws every cell
+     */
+    void setColor(uint16_t fg, uint16_t bg);
+
+    /**
+     * @brief Forget the screen contents, the next setText() redraws every cell
+     */
+    void invalidate();
+
+private:
+    /**
+     * @brief Draw one cell if its character changed
+     *
+     * @return true if the cell was redrawn
+     */
+    bool updateCell(uint16_t cell, char c);
+
+    Adafruit_GFX &_gfx;
+    int16_t _x;
+    int16_t _y;
+    uint8_t _cols;
+    uint8_t _rows;
+    uint8_t _size;
+    uint16_t _fg;
+    uint16_t _bg;
+    char _shown[TEXT_FIELD_MAX_CELLS];  /*!< Character per cell, 0 if the cell content is unknown */
+};
+
+
+/**
+ * @brief Retained-mode, right-aligned text field for a monospaced GFXaafont
+ *
+ * Meant for numbers: every character occupies one cell of the advance of
+ * '0', only cells whose character changed are redrawn. Characters missing
+ * from the font are shown as blank cells.
+ */
+class NumberField {
+public:
+    /**
+     * @param gfx Display to draw on
+     * @param x Left edge in pixels
+     * @param baseline Baseline in pixels, cells reach font->ascent - 1 rows above it
+     * @param cols Number of cells, capped to TEXT_FIELD_MAX_CELLS
+     * @param font Anti-aliased font, kerning is ignored
+     * @param fg Text color
+     * @param bg Background color, must match the area the field is placed on initially
+     */
+    NumberField(Adafruit_GFX &gfx, int16_t x, int16_t baseline, uint8_t cols,
+                const GFXaafont *font, uint16_t fg, uint16_t bg);
+
+    /**
+     * @brief Show a new text, right-aligned and cut off on the left if too long
+     *
+     * @param text Null-terminated text
+     * @return Number of redrawn cells
+     */
+    uint16_t setText(const char *text);
+
+    /**
+     * @brief Change the colors, the next setText() redraws every cell
+     */
+    void setColor(uint16_t fg, uint16_t bg);
+
+    /**
+     * @brief Forget the screen contents, the next setText() redraws every cell
+     */
+    void invalidate();
+
+    /** @brief Width of the field in pixels */
+    int16_t width() const { return _cols * _cellW; }
+
+private:
+    Adafruit_GFX &_gfx;
+    const GFXaafont *_font;
+    int16_t _x;
+    int16_t _baseline;
+    int16_t _cellW;
+    uint8_t _cols;
+    uint16_t _fg;
+    uint16_t _bg;
+    char _shown[TEXT_FIELD_MAX_CELLS];  /*!< Character per cell, 0 if the cell content is unknown */
+};
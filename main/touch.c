@@ -3,11 +3,15 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_sleep.h"
+#include "esp_attr.h"
 
 
 volatile bool touched = false;
 static uint32_t start_value;
 
+/** @brief Wakeup threshold of the last calibration, 0 if the pad is not used; survives deep sleep */
+static RTC_DATA_ATTR int rtc_threshold = -1;
+
 
 /**
  * @brief Calibrates a specific touch pad by averaging raw sensor readings.
@@ -35,18 +39,29 @@ static void calibrate_touch_pad(touch_pad_t pad)
         printf("Touch pad #%d average reading is too low: %d (expecting at least %d). "
                "Not using for deep sleep wakeup.\n", pad, avg, min_reading);
         touch_pad_config(pad, 0);
+        rtc_threshold = 0;
     } else {
         int threshold = avg - 100;
         printf("Touch pad #%d average: %d, wakeup threshold set to %d.\n", pad, avg, threshold);
         touch_pad_config(pad, threshold);
+        rtc_threshold = threshold;
     }
 }
 
 
-void my_touch_init(){
+/**
+ * @brief Starts the touch FSM with the voltages used for wakeup
+ */
+static void touch_pad_start(void)
+{
     ESP_ERROR_CHECK(touch_pad_init());
     touch_pad_set_fsm_mode(TOUCH_FSM_MODE_TIMER);
     touch_pad_set_voltage(TOUCH_HVOLT_2V5, TOUCH_LVOLT_0V5, TOUCH_HVOLT_ATTEN_1V);
+}
+
+
+void my_touch_init(){
+    touch_pad_start();
     touch_pad_config(TOUCH_PAD_GPIO4_CHANNEL, 0);
     calibrate_touch_pad(TOUCH_PAD_GPIO4_CHANNEL);
     printf("Enabling touch pad wakeup\n");
@@ -55,6 +70,18 @@ void my_touch_init(){
 }
 
 
+void my_touch_rearm(){
+    if (rtc_threshold < 0) {
+        my_touch_init();
+        return;
+    }
+    touch_pad_start();
+    touch_pad_config(TOUCH_PAD_GPIO4_CHANNEL, rtc_threshold);
+    ESP_ERROR_CHECK(esp_sleep_enable_touchpad_wakeup());
+    ESP_ERROR_CHECK(esp_sleep_pd_config(ESP_PD_DOMAIN_RTC_PERIPH, ESP_PD_OPTION_ON));
+}
+
+
 void my_touch_tresh() {
     uint16_t touch_value;
     touch_pad_read_filtered(TOUCH_PAD_GPIO4_CHANNEL, &touch_value);
@@ -14,6 +14,14 @@ extern "C" {
  */
 void my_touch_init();
 
+/**
+ * @brief Re-enables touch wakeup after a deep sleep wake
+ *
+ * Uses the threshold of the last calibration, kept in RTC memory, so
+ * a short wake does not spend time calibrating. Calibrates if there is none.
+ */
+void my_touch_rearm();
+
 /**
  * @brief Interrupt Service Routine for touch events
  *
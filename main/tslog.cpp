@@ -0,0 +1,455 @@
+#include "tslog.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include "LittleFS.h"
+#include "power.h"
+
+
+/** @brief Logging tag for tslog */
+static const char *TAG = "tslog";
+
+/** @brief Directory of the segment files */
+#define SEGMENT_DIR "/ts"
+#define SEGMENT_BYTES (TSLOG_SEGMENT_BLOCKS * TSLOG_BLOCK_SIZE)
+
+/** @brief Index entry of a segment file */
+typedef struct {
+    uint32_t first_seq;         /*!< Sequence number of block 0, also the file name */
+    uint16_t blocks;            /*!< Valid blocks */
+    bool sealed;                /*!< Full or torn, nothing is appended anymore */
+    uint64_t first_ms;
+    uint64_t last_ms;
+} segment_t;
+
+/** @brief Stored segments, oldest first */
+static segment_t segments[TSLOG_MAX_SEGMENTS];
+static int segment_count = 0;
+
+/** @brief Block collecting the current rows */
+static tslog_block_t current;
+
+/** @brief Added to the clock if it is behind the log after a power loss */
+static int64_t clock_offset_ms = 0;
+
+/** @brief Timestamp of the newest row, rows never go back in time */
+static uint64_t last_row_ms = 0;
+
+static bool ready = false;
+
+/** @brief Guards segments, current and the files */
+static SemaphoreHandle_t log_mutex;
+
+/** @brief Block buffer for index lookups, used under log_mutex */
+static uint8_t scratch[TSLOG_BLOCK_SIZE];
+
+/** @brief Sums of the current interval, written by the scheduler task */
+static float sums[SENSOR_CHANNEL_COUNT];
+static uint32_t counts[SENSOR_CHANNEL_COUNT];
+static portMUX_TYPE sum_lock = portMUX_INITIALIZER_UNLOCKED;
+
+
+/** -----------------------------------------------------------------------------------------------------------------------------------------------------------------*/
+
+
+/**
+ * @brief Time of the device clock in ms
+ */
+static uint64_t clock_ms(void)
+{
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return (uint64_t)now.tv_sec * 1000 + now.tv_usec / 1000;
+}
+
+
+static void segment_path(char *path, size_t size, uint32_t first_seq)
+{
+    snprintf(path, size, SEGMENT_DIR "/%08lx", (unsigned long)first_seq);
+}
+
+
+/**
+ * @brief Reads and checks block index of a segment
+ *
+ * @param seg Segment to read from
+ * @param index Block within the segment
+ * @param buf Output, TSLOG_BLOCK_SIZE bytes
+ * @param header Output, header of the block
+ * @return false if the block cannot be read or is damaged
+ */
+static bool read_block(const segment_t *seg, uint32_t index, uint8_t *buf, tslog_header_t *header)
+{
+    char path[24];
+    segment_path(path, sizeof(path), seg->first_seq);
+    File file = LittleFS.open(path, FILE_READ);
+    if (!file) {
+        return false;
+    }
+    bool ok = file.seek(index * TSLOG_BLOCK_SIZE) && file.read(buf, TSLOG_BLOCK_SIZE) == TSLOG_BLOCK_SIZE;
+    file.close();
+    return ok && tslog_block_check(buf, header) && header->seq == seg->first_seq + index;
+}
+
+
+/**
+ * @brief Removes the oldest segment
+ */
+static void remove_oldest(void)
+{
+    char path[24];
+    segment_path(path, sizeof(path), segments[0].first_seq);
+    LittleFS.remove(path);
+    segment_count--;
+    memmove(&segments[0], &segments[1], segment_count * sizeof(segments[0]));
+}
+
+
+/**
+ * @brief Checks a segment found on flash and completes its index entry
+ *
+ * Blocks are checked from the end, so a block torn by a power loss is
+ * dropped and the segment sealed. Usually only the last block is read.
+ *
+ * @param seg Entry with first_seq and the file size in blocks
+ * @param torn true if the file size is not a multiple of the block size
+ * @return false if the segment holds no valid block
+ */
+static bool recover_segment(segment_t *seg, bool torn)
+{
+    tslog_header_t header;
+    while (seg->blocks > 0 && !read_block(seg, seg->blocks - 1, scratch, &header)) {
+        ESP_LOGW(TAG, "Dropping damaged block %lu", (unsigned long)(seg->first_seq + seg->blocks - 1));
+        seg->blocks--;
+        torn = true;
+    }
+    if (seg->blocks == 0) {
+        return false;
+    }
+    seg->last_ms = header.last_ms;
+    if (!read_block(seg, 0, scratch, &header)) {
+        return false;
+    }
+    seg->first_ms = header.first_ms;
+    seg->sealed = torn || seg->blocks >= TSLOG_SEGMENT_BLOCKS;
+    return true;
+}
+
+
+/**
+ * @brief Indexes the segment files and drops the damaged ones
+ */
+static void scan_segments(void)
+{
+    bool torn[TSLOG_MAX_SEGMENTS];
+    File dir = LittleFS.open(SEGMENT_DIR);
+    for (File file = dir.openNextFile(); file; file = dir.openNextFile()) {
+        char *end;
+        uint32_t first_seq = strtoul(file.name(), &end, 16);
+        if (*end != '\0' || segment_count == TSLOG_MAX_SEGMENTS) {
+            ESP_LOGW(TAG, "Ignoring %s", file.name());
+            continue;
+        }
+        // Insertion sort by sequence number
+        int i = segment_count++;
+        while (i > 0 && segments[i - 1].first_seq > first_seq) {
+            segments[i] = segments[i - 1];
+            torn[i] = torn[i - 1];
+            i--;
+        }
+        segments[i] = (segment_t){.first_seq = first_seq, .blocks = (uint16_t)(file.size() / TSLOG_BLOCK_SIZE)};
+        torn[i] = file.size() % TSLOG_BLOCK_SIZE != 0;
+    }
+    dir.close();
+
+    int kept = 0;
+    for (int i = 0; i < segment_count; i++) {
+        if (recover_segment(&segments[i], torn[i])) {
+            segments[kept++] = segments[i];
+            continue;
+        }
+        char path[24];
+        segment_path(path, sizeof(path), segments[i].first_seq);
+        ESP_LOGW(TAG, "Removing damaged segment %s", path);
+        LittleFS.remove(path);
+    }
+    segment_count = kept;
+    // Only the newest segment takes more blocks
+    for (int i = 0; i + 1 < segment_count; i++) {
+        segments[i].sealed = true;
+    }
+}
+
+
+/**
+ * @brief Writes the current block to the newest segment
+ *
+ * Starts a new segment if the newest one is sealed, removing old ones
+ * until there is room. A failed write seals the segment, its block is lost.
+ */
+static void write_block(void)
+{
+    tslog_block_finish(&current);
+    const tslog_header_t *h = &current.header;
+
+    segment_t *seg = segment_count > 0 ? &segments[segment_count - 1] : NULL;
+    if (seg == NULL || seg->sealed) {
+        while (segment_count > 0 && (segment_count == TSLOG_MAX_SEGMENTS ||
+               LittleFS.totalBytes() - LittleFS.usedBytes() < TSLOG_RESERVE_SEGMENTS * SEGMENT_BYTES)) {
+            remove_oldest();
+        }
+        seg = &segments[segment_count++];
+        *seg = (segment_t){.first_seq = h->seq, .blocks = 0, .sealed = false, .first_ms = h->first_ms, .last_ms = h->last_ms};
+    }
+
+    char path[24];
+    segment_path(path, sizeof(path), seg->first_seq);
+    power_acquire(POWER_LEASE_FLASH);
+    File file = LittleFS.open(path, FILE_APPEND);
+    bool ok = file && file.write(current.buf, TSLOG_BLOCK_SIZE) == TSLOG_BLOCK_SIZE;
+    if (file) {
+        file.close();
+    }
+    power_release(POWER_LEASE_FLASH);
+    if (!ok) {
+        ESP_LOGE(TAG, "Writing block %lu to %s failed", (unsigned long)h->seq, path);
+        seg->sealed = true;
+        if (seg->blocks == 0) {
+            LittleFS.remove(path);
+            segment_count--;
+        }
+        return;
+    }
+    seg->blocks++;
+    seg->last_ms = h->last_ms;
+    seg->sealed = seg->blocks >= TSLOG_SEGMENT_BLOCKS;
+}
+
+
+/**
+ * @brief Appends a row, writing the current block out first if needed
+ *
+ * A change of the logged channels also starts a new block, every row of
+ * a block holds the same channels.
+ */
+static void append_row(uint64_t timestamp_ms, uint8_t channel_mask, const int32_t *values)
+{
+    if (current.header.channel_mask != channel_mask) {
+        if (current.header.rows > 0) {
+            write_block();
+            tslog_block_begin(&current, current.header.seq + 1, channel_mask, TSLOG_SCALE);
+        } else {
+            tslog_block_begin(&current, current.header.seq, channel_mask, TSLOG_SCALE);
+        }
+    }
+    if (!tslog_block_append(&current, timestamp_ms, values)) {
+        write_block();
+        tslog_block_begin(&current, current.header.seq + 1, channel_mask, TSLOG_SCALE);
+        tslog_block_append(&current, timestamp_ms, values);
+    }
+}
+
+
+/**
+ * @brief Task appending the interval averages as one row
+ *
+ * @param args Unused
+ */
+static void tslog_task(void *args)
+{
+    TickType_t last_wake = xTaskGetTickCount();
+    while (1) {
+        xTaskDelayUntil(&last_wake, pdMS_TO_TICKS(TSLOG_INTERVAL_MS));
+
+        float averages[SENSOR_CHANNEL_COUNT];
+        uint8_t mask = 0;
+        portENTER_CRITICAL(&sum_lock);
+        for (int ch = 0; ch < SENSOR_CHANNEL_COUNT; ch++) {
+            if (counts[ch] > 0) {
+                averages[ch] = sums[ch] / counts[ch];
+                mask |= 1u << ch;
+            }
+            sums[ch] = 0;
+            counts[ch] = 0;
+        }
+        portEXIT_CRITICAL(&sum_lock);
+        if (mask == 0) {
+            continue;
+        }
+
+        float values[SENSOR_CHANNEL_COUNT];
+        int n = 0;
+        for (int ch = 0; ch < SENSOR_CHANNEL_COUNT; ch++) {
+            if (mask & (1u << ch)) {
+                values[n++] = averages[ch];
+            }
+        }
+        tslog_append(clock_ms(), mask, values);
+    }
+}
+
+
+bool tslog_init(void)
+{
+    static_assert(SENSOR_CHANNEL_COUNT <= TSLOG_MAX_CHANNELS, "a block holds at most TSLOG_MAX_CHANNELS channels");
+
+    log_mutex = xSemaphoreCreateMutex();
+    if (!LittleFS.begin(true, TSLOG_BASE_PATH, 4, TSLOG_PARTITION)) {
+        ESP_LOGE(TAG, "Mounting partition %s failed, log disabled", TSLOG_PARTITION);
+        return false;
+    }
+    if (!LittleFS.exists(SEGMENT_DIR)) {
+        LittleFS.mkdir(SEGMENT_DIR);
+    }
+    scan_segments();
+
+    uint32_t next_seq = 0;
+    if (segment_count > 0) {
+        const segment_t *newest = &segments[segment_count - 1];
+        next_seq = newest->first_seq + newest->blocks;
+        last_row_ms = newest->last_ms;
+        uint64_t now = clock_ms();
+        if (now <= newest->last_ms) {
+            clock_offset_ms = newest->last_ms - now + TSLOG_INTERVAL_MS;
+            ESP_LOGW(TAG, "Clock is behind the log, offset by %lld ms", (long long)clock_offset_ms);
+        }
+    }
+    tslog_block_begin(&current, next_seq, 0, TSLOG_SCALE);
+    ready = true;
+
+    ESP_LOGI(TAG, "%d segments, next block %lu, %u of %u KB used", segment_count, (unsigned long)next_seq,
+             (unsigned)(LittleFS.usedBytes() / 1024), (unsigned)(LittleFS.totalBytes() / 1024));
+    return true;
+}
+
+
+void tslog_add(sensor_channel_t channel, float value)
+{
+    if (!ready || !(TSLOG_CHANNELS & (1u << channel)) || !isfinite(value)) {
+        return;
+    }
+    portENTER_CRITICAL(&sum_lock);
+    sums[channel] += value;
+    counts[channel]++;
+    portEXIT_CRITICAL(&sum_lock);
+}
+
+
+bool tslog_append(uint64_t timestamp_ms, uint8_t channel_mask, const float *values)
+{
+    if (!ready) {
+        return false;
+    }
+    int32_t scaled[TSLOG_MAX_CHANNELS];
+    int n = 0;
+    for (int ch = 0; ch < TSLOG_MAX_CHANNELS; ch++) {
+        if (channel_mask & (1u << ch)) {
+            float v = values[n] * TSLOG_SCALE;
+            scaled[n++] = isnan(v) ? 0 : v >= INT32_MAX ? INT32_MAX : v <= INT32_MIN ? INT32_MIN : (int32_t)lroundf(v);
+        }
+    }
+
+    xSemaphoreTake(log_mutex, portMAX_DELAY);
+    timestamp_ms += clock_offset_ms;
+    if (timestamp_ms < last_row_ms) {
+        timestamp_ms = last_row_ms;
+    }
+    last_row_ms = timestamp_ms;
+    append_row(timestamp_ms, channel_mask, scaled);
+    xSemaphoreGive(log_mutex);
+    return true;
+}
+
+
+void start_tslog_task(void)
+{
+    if (ready) {
+        xTaskCreate(tslog_task, "tslog", 4096, NULL, 2, NULL);
+    }
+}
+
+
+void tslog_flush(void)
+{
+    if (!ready) {
+        return;
+    }
+    xSemaphoreTake(log_mutex, portMAX_DELAY);
+    if (current.header.rows > 0) {
+        write_block();
+        tslog_block_begin(&current, current.header.seq + 1, current.header.channel_mask, TSLOG_SCALE);
+    }
+    xSemaphoreGive(log_mutex);
+}
+
+
+uint32_t tslog_find(uint64_t since_ms)
+{
+    if (!ready) {
+        return 0;
+    }
+    xSemaphoreTake(log_mutex, portMAX_DELAY);
+    uint32_t seq = current.header.seq;
+    for (int i = 0; i < segment_count; i++) {
+        const segment_t *seg = &segments[i];
+        if (seg->last_ms < since_ms) {
+            continue;
+        }
+        // First block of the segment that ends at or after since_ms
+        uint32_t lo = 0, hi = seg->blocks - 1;
+        while (lo < hi) {
+            uint32_t mid = (lo + hi) / 2;
+            tslog_header_t header;
+            if (read_block(seg, mid, scratch, &header) && header.last_ms < since_ms) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        seq = seg->first_seq + lo;
+        break;
+    }
+    xSemaphoreGive(log_mutex);
+    return seq;
+}
+
+
+bool tslog_read(uint32_t *seq, uint8_t *buf)
+{
+    if (!ready) {
+        return false;
+    }
+    bool found = false;
+    xSemaphoreTake(log_mutex, portMAX_DELAY);
+    for (int i = 0; i < segment_count && !found; i++) {
+        const segment_t *seg = &segments[i];
+        while (!found && *seq < seg->first_seq + seg->blocks) {
+            if (*seq < seg->first_seq) {
+                *seq = seg->first_seq;
+            }
+            tslog_header_t header;
+            found = read_block(seg, *seq - seg->first_seq, buf, &header);
+            if (!found) {
+                ESP_LOGW(TAG, "Skipping unreadable block %lu", (unsigned long)*seq);
+                (*seq)++;
+            }
+        }
+    }
+    if (!found && *seq <= current.header.seq && current.header.rows > 0) {
+        *seq = current.header.seq;
+        tslog_block_finish(&current);
+        memcpy(buf, current.buf, TSLOG_BLOCK_SIZE);
+        found = true;
+    }
+    if (found) {
+        (*seq)++;
+    }
+    xSemaphoreGive(log_mutex);
+    return found;
+}
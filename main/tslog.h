@@ -0,0 +1,107 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sensor_scheduler.h"
+#include "tslog_codec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Append-only time-series log on the LittleFS "storage" partition.
+ *
+ * Every TSLOG_INTERVAL_MS the average of each channel is appended as one
+ * row to a block in RAM (format in tslog_codec.h). Full blocks are
+ * written to segment files of TSLOG_SEGMENT_BLOCKS blocks, named after
+ * the sequence number of their first block. The oldest segment is
+ * removed when the partition runs out of space.
+ *
+ * With the three MQ-2 channels a row takes 4 to 5 bytes, so a block
+ * covers about 20 minutes and the 960 KB partition about three weeks.
+ * The block in RAM is lost on a reset, tslog_flush() writes it out
+ * before a planned one.
+ */
+
+/* Log parameters */
+#define TSLOG_CHANNELS          ((1u << SENSOR_CHANNEL_COUNT) - 1)
+#define TSLOG_INTERVAL_MS       10000
+#define TSLOG_SCALE             10          /* Values are stored in 0.1 units */
+#define TSLOG_SEGMENT_BLOCKS    64          /* 32 KB per segment file */
+#define TSLOG_MAX_SEGMENTS      64
+#define TSLOG_RESERVE_SEGMENTS  2           /* Free space kept for LittleFS to copy on write */
+#define TSLOG_PARTITION         "storage"
+#define TSLOG_BASE_PATH         "/littlefs"
+
+/**
+ * @brief Mount the partition and index the stored segments
+ *
+ * The newest segment is checked block by block from its end, a torn
+ * block from a power loss is dropped and writing continues in a new
+ * segment. Formats the partition if it cannot be mounted.
+ *
+ * @return false if the log is unavailable, all other calls are no-ops then
+ */
+bool tslog_init(void);
+
+/**
+ * @brief Add a sample to the average of the current interval
+ *
+ * Called by the sensor scheduler for every published value, O(1).
+ *
+ * @param channel Channel of the sample
+ * @param value New value
+ */
+void tslog_add(sensor_channel_t channel, float value);
+
+/**
+ * @brief Append a row of values collected outside the log task
+ *
+ * For samples taken while the log was not running, e.g. during deep
+ * sleep. Rows older than the newest one are logged at its time.
+ *
+ * @param timestamp_ms Time of the device clock (gettimeofday()) in ms
+ * @param channel_mask Channels of the values
+ * @param values One value per channel in the mask, in channel order
+ * @return false if the log is unavailable
+ */
+bool tslog_append(uint64_t timestamp_ms, uint8_t channel_mask, const float *values);
+
+/**
+ * @brief Start the task appending a row every TSLOG_INTERVAL_MS
+ */
+void start_tslog_task(void);
+
+/**
+ * @brief Write the partly filled block to flash
+ *
+ * The remainder of the block stays empty, the next row starts a new one.
+ */
+void tslog_flush(void);
+
+/**
+ * @brief Find the first block with rows at or after a time
+ *
+ * @param since_ms Time in ms since the epoch of the device clock
+ * @return Sequence number for tslog_read()
+ */
+uint32_t tslog_find(uint64_t since_ms);
+
+/**
+ * @brief Copy a stored block
+ *
+ * Blocks are returned as stored, without decoding. After the last
+ * block on flash the partly filled block in RAM is returned, a later
+ * call returns it again with more rows under the same sequence number.
+ *
+ * @param seq Block to read, advanced to the next block. Skips ahead if the
+ *            block was removed already.
+ * @param buf Output, TSLOG_BLOCK_SIZE bytes
+ * @return false if there are no more blocks
+ */
+bool tslog_read(uint32_t *seq, uint8_t *buf);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,167 @@
+#include "tslog_codec.h"
+#include <string.h>
+
+
+/** -----------------------------------------------------------------------------------------------------------------------------------------------------------------*/
+
+
+/** @brief Little endian helpers, the block format does not depend on the host */
+static void put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    put_u16(&p[0], (uint16_t)v);
+    put_u16(&p[2], (uint16_t)(v >> 16));
+}
+
+static void put_u64(uint8_t *p, uint64_t v)
+{
+    put_u32(&p[0], (uint32_t)v);
+    put_u32(&p[4], (uint32_t)(v >> 32));
+}
+
+static uint16_t get_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)get_u16(&p[0]) | ((uint32_t)get_u16(&p[2]) << 16);
+}
+
+static uint64_t get_u64(const uint8_t *p)
+{
+    return (uint64_t)get_u32(&p[0]) | ((uint64_t)get_u32(&p[4]) << 32);
+}
+
+
+/**
+ * @brief Writes a signed number as zig-zag LEB128 varint
+ *
+ * @param p Output, up to 10 bytes
+ * @param v Number to write
+ * @return Bytes written
+ */
+static size_t put_varint(uint8_t *p, int64_t v)
+{
+    uint64_t z = ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+    size_t n = 0;
+    while (z >= 0x80) {
+        p[n++] = (uint8_t)(z | 0x80);
+        z >>= 7;
+    }
+    p[n++] = (uint8_t)z;
+    return n;
+}
+
+
+uint32_t tslog_crc32(uint32_t crc, const uint8_t *data, size_t len)
+{
+    crc = ~crc;
+    while (len--) {
+        crc ^= *data++;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+
+void tslog_block_begin(tslog_block_t *block, uint32_t seq, uint8_t channel_mask, uint8_t scale)
+{
+    memset(block, 0, sizeof(*block));
+    block->header.seq = seq;
+    block->header.channel_mask = channel_mask;
+    block->header.scale = scale;
+    for (uint8_t ch = 0; ch < TSLOG_MAX_CHANNELS; ch++) {
+        block->channels += (channel_mask >> ch) & 1;
+    }
+}
+
+
+bool tslog_block_append(tslog_block_t *block, uint64_t timestamp_ms, const int32_t *values)
+{
+    tslog_header_t *h = &block->header;
+    uint8_t row[TSLOG_ROW_MAX_SIZE];
+    size_t len = 0;
+
+    int64_t delta = 0;
+    if (h->rows == 1) {
+        delta = (int64_t)(timestamp_ms - h->last_ms);
+        len += put_varint(&row[len], delta);
+    } else if (h->rows > 1) {
+        delta = (int64_t)(timestamp_ms - h->last_ms);
+        len += put_varint(&row[len], delta - block->last_delta_ms);
+    }
+    for (uint8_t i = 0; i < block->channels; i++) {
+        int64_t prev = h->rows > 0 ? block->last_values[i] : 0;
+        len += put_varint(&row[len], (int64_t)values[i] - prev);
+    }
+
+    if (h->length + len > TSLOG_PAYLOAD_SIZE) {
+        return false;
+    }
+    memcpy(&block->buf[TSLOG_HEADER_SIZE + h->length], row, len);
+    h->length += (uint16_t)len;
+    if (h->rows == 0) {
+        h->first_ms = timestamp_ms;
+    }
+    h->last_ms = timestamp_ms;
+    h->rows++;
+    block->last_delta_ms = delta;
+    memcpy(block->last_values, values, block->channels * sizeof(values[0]));
+    return true;
+}
+
+
+/**
+ * @brief Encodes a header into the first TSLOG_HEADER_SIZE - 4 bytes, without CRC
+ */
+static void write_header(uint8_t *buf, const tslog_header_t *h)
+{
+    put_u32(&buf[0], TSLOG_MAGIC);
+    put_u32(&buf[4], h->seq);
+    put_u64(&buf[8], h->first_ms);
+    put_u64(&buf[16], h->last_ms);
+    put_u16(&buf[24], h->rows);
+    put_u16(&buf[26], h->length);
+    buf[28] = h->channel_mask;
+    buf[29] = h->scale;
+    put_u16(&buf[30], 0);
+}
+
+
+void tslog_block_finish(tslog_block_t *block)
+{
+    write_header(block->buf, &block->header);
+    uint32_t crc = tslog_crc32(0, block->buf, 32);
+    crc = tslog_crc32(crc, &block->buf[TSLOG_HEADER_SIZE], block->header.length);
+    put_u32(&block->buf[32], crc);
+}
+
+
+bool tslog_block_check(const uint8_t *buf, tslog_header_t *header)
+{
+    if (get_u32(&buf[0]) != TSLOG_MAGIC) {
+        return false;
+    }
+    header->seq = get_u32(&buf[4]);
+    header->first_ms = get_u64(&buf[8]);
+    header->last_ms = get_u64(&buf[16]);
+    header->rows = get_u16(&buf[24]);
+    header->length = get_u16(&buf[26]);
+    header->channel_mask = buf[28];
+    header->scale = buf[29];
+    if (header->length > TSLOG_PAYLOAD_SIZE || header->rows == 0) {
+        return false;
+    }
+    uint32_t crc = tslog_crc32(0, buf, 32);
+    crc = tslog_crc32(crc, &buf[TSLOG_HEADER_SIZE], header->length);
+    return crc == get_u32(&buf[32]);
+}
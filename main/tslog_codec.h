@@ -0,0 +1,117 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Block format of the on-flash time-series log.
+ *
+ * The log is a sequence of fixed-size blocks. Each block holds the rows
+ * of a time range and can be decoded on its own. All fields are little
+ * endian:
+ *
+ *   0  uint32  magic "TSB1"
+ *   4  uint32  block sequence number
+ *   8  uint64  timestamp of the first row in ms
+ *  16  uint64  timestamp of the last row in ms
+ *  24  uint16  number of rows
+ *  26  uint16  payload length in bytes
+ *  28  uint8   channel mask, bit n set if the rows hold channel n
+ *  29  uint8   value scale, a stored value v means v / scale
+ *  30  uint16  reserved, 0
+ *  32  uint32  CRC-32 of bytes 0-31 and the payload
+ *  36  payload, zero padded to TSLOG_BLOCK_SIZE
+ *
+ * A row is a timestamp followed by one value per channel in the mask,
+ * in channel order. Each number is a zig-zag encoded LEB128 varint:
+ *
+ *   row 0   values as is, the timestamp is the one of the header
+ *   row 1   timestamp delta, value deltas to row 0
+ *   row n   timestamp delta-of-delta, value deltas to row n-1
+ *
+ * With a fixed logging interval the delta-of-delta is 0 and costs one
+ * byte. Values are deltas, not delta-of-deltas, since averaged sensor
+ * readings change slowly but noisily.
+ *
+ * This file has no ESP-IDF dependencies and builds on the host as well.
+ */
+
+/* Block parameters */
+#define TSLOG_MAGIC             0x31425354      /* "TSB1" */
+#define TSLOG_BLOCK_SIZE        512             /* Two LittleFS pages */
+#define TSLOG_HEADER_SIZE       36
+#define TSLOG_PAYLOAD_SIZE      (TSLOG_BLOCK_SIZE - TSLOG_HEADER_SIZE)
+#define TSLOG_MAX_CHANNELS      8
+#define TSLOG_ROW_MAX_SIZE      (10 * (1 + TSLOG_MAX_CHANNELS))
+
+/** @brief Decoded block header */
+typedef struct {
+    uint32_t seq;
+    uint64_t first_ms;
+    uint64_t last_ms;
+    uint16_t rows;
+    uint16_t length;            /*!< Payload bytes */
+    uint8_t channel_mask;
+    uint8_t scale;
+} tslog_header_t;
+
+/** @brief Block under construction, rows are encoded directly into buf */
+typedef struct {
+    uint8_t buf[TSLOG_BLOCK_SIZE];
+    tslog_header_t header;
+    uint8_t channels;           /*!< Bits set in channel_mask */
+    int64_t last_delta_ms;
+    int32_t last_values[TSLOG_MAX_CHANNELS];
+} tslog_block_t;
+
+/**
+ * @brief Start an empty block
+ *
+ * @param block Block to reset
+ * @param seq Sequence number of the block
+ * @param channel_mask Channels of every row, bit n for channel n < TSLOG_MAX_CHANNELS
+ * @param scale Fixed point scale of the values
+ */
+void tslog_block_begin(tslog_block_t *block, uint32_t seq, uint8_t channel_mask, uint8_t scale);
+
+/**
+ * @brief Append a row
+ *
+ * @param block Block to append to
+ * @param timestamp_ms Time of the row, not before the previous row
+ * @param values One scaled value per channel in the mask
+ * @return false if the row does not fit, the block is unchanged then
+ */
+bool tslog_block_append(tslog_block_t *block, uint64_t timestamp_ms, const int32_t *values);
+
+/**
+ * @brief Write header and CRC, buf then holds the complete block
+ *
+ * Rows may still be appended afterwards and the block finished again.
+ */
+void tslog_block_finish(tslog_block_t *block);
+
+/**
+ * @brief Check and decode the header of a stored block
+ *
+ * @param buf TSLOG_BLOCK_SIZE bytes
+ * @param header Output, valid if true is returned
+ * @return false if magic, length or CRC do not match
+ */
+bool tslog_block_check(const uint8_t *buf, tslog_header_t *header);
+
+/**
+ * @brief CRC-32 as used by zlib and Ethernet
+ *
+ * @param crc 0, or the result of the previous call to continue a checksum
+ */
+uint32_t tslog_crc32(uint32_t crc, const uint8_t *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,5 +1,6 @@
 #include "variables.h"
 #include "esp_log.h"
+#include <atomic>
 
 
 /** @brief Logging tag for variables*/
@@ -8,9 +9,41 @@ static const char *TAG = "var";
 
 QueueHandle_t tftQueue = nullptr;
 
+/** @brief Message pool, a slot is free while its busy flag is clear */
+static char msgPool[TFT_MSG_POOL_SIZE][TFT_MSG_SIZE];
+static std::atomic<bool> msgBusy[TFT_MSG_POOL_SIZE];
+
 void init_tft_queue() {
-    tftQueue = xQueueCreate(TFT_QUEUE_LENGTH, TFT_MSG_SIZE);
+    tftQueue = xQueueCreate(TFT_QUEUE_LENGTH, sizeof(tft_msg_t));
     if (tftQueue == NULL) {
         ESP_LOGE(TAG, "Failed to create TFT message queue");
     }
 }
+
+tft_msg_t tft_msg_alloc(void) {
+    for (tft_msg_t i = 0; i < TFT_MSG_POOL_SIZE; i++) {
+        bool expected = false;
+        if (msgBusy[i].compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return i;
+        }
+    }
+    return TFT_MSG_NONE;
+}
+
+char *tft_msg_data(tft_msg_t msg) {
+    return msgPool[msg];
+}
+
+void tft_msg_release(tft_msg_t msg) {
+    if (!msgBusy[msg].exchange(false, std::memory_order_release)) {
+        ESP_LOGE(TAG, "TFT message %d released twice", msg);
+    }
+}
+
+bool tft_msg_send(tft_msg_t msg, TickType_t wait) {
+    if (xQueueSend(tftQueue, &msg, wait) != pdPASS) {
+        tft_msg_release(msg);
+        return false;
+    }
+    return true;
+}
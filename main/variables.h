@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stdbool.h>
+#include <stdint.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
 
@@ -9,12 +11,26 @@
 #define TFT_RST        21 
 #define TFT_DC         22
 
+/* MQ-2 analog output, must be an ADC1 pin for continuous sampling*/
+#define MQ2_PIN              34
+#define MQ2_SAMPLE_HZ        10      /* Averaged readings per second, the update rate of all MQ-2 channels */
+#define MQ2_SAMPLE_PERIOD_MS (1000 / MQ2_SAMPLE_HZ)
+#define MQ2_WARMUP_MS        20000
+
 /* ESP32 touch pin*/
 #define TOUCH_PAD_GPIO4_CHANNEL TOUCH_PAD_NUM0 
 
+/* Deep sleep parameters*/
+#define SLEEP_WAKE_INTERVAL_S       60      /* Timer wake to log one sample, 0 wakes on touch only */
+#define SLEEP_BATCH_SIZE            60      /* Samples kept in RTC memory until they go to the log */
+#define POWER_BOOT_HOLD_MS          60000   /* Awake after power on or touch, time to connect */
+#define POWER_DISPLAY_HOLD_MS       30000   /* Awake after a new message on the display */
+
 /* TFT message buffer parameters*/
 #define TFT_MSG_SIZE 128
-#define TFT_QUEUE_LENGTH 5
+#define TFT_MSG_POOL_SIZE 5     /* 640 bytes, what the queue of 5 copied messages used */
+#define TFT_QUEUE_LENGTH TFT_MSG_POOL_SIZE
+#define TFT_MSG_NONE 0xFF
 
 /* TCP config*/
 #define PORT                        3333
@@ -22,12 +38,27 @@
 #define KEEPALIVE_INTERVAL          5
 #define KEEPALIVE_COUNT             3
 #define CONFIG_EXAMPLE_IPV4         1
+#define TCP_MAX_CLIENTS             4       /* matches wifi_config.ap.max_connection */
+#define TCP_RX_BUFFER_SIZE          256
+#define TCP_TX_RING_SIZE            2048
 
-/* TFT text field parameters*/
-#define TEXT_X 20
-#define TEXT_Y 12
-#define TEXT_W 88
-#define TEXT_H 24
+/* Telemetry stream parameters*/
+#define TLM_POLL_MS                 5
+#define TLM_FLUSH_MS                50
+
+/* TFT dashboard parameters*/
+#define DASH_FRAME_MS               (MQ2_SAMPLE_PERIOD_MS / 2)  /* Snapshot poll period, two per MQ-2 reading so none is missed */
+#define DASH_BANNER_H               12
+#define DASH_BANNER_COLS            21
+#define DASH_PANEL_Y                DASH_BANNER_H
+#define DASH_PANEL_H                49
+#define DASH_VALUE_COLS             5
+#define DASH_SPARK_Y                26      /* Sparkline top within a panel, below the value */
+#define DASH_SPARK_H                22
+#define DASH_SPARK_MAX_PPM          100.0f  /* Initial sparkline range, doubles as needed */
+#define DASH_ALARM_LPG_PPM          1000.0f
+#define DASH_ALARM_CO_PPM           200.0f
+#define DASH_ALARM_SMOKE_PPM        1000.0f
 
 
 #ifdef __cplusplus
@@ -35,12 +66,47 @@ extern "C" {
 #endif
 
 
-/** @brief Handle for message buffer */
+/**
+ * @brief Index of a pooled TFT message slot
+ *
+ * The queue carries only this index, the text stays in the pool slot
+ * it was received into.
+ */
+typedef uint8_t tft_msg_t;
+
+/** @brief Handle for message buffer, items are tft_msg_t */
 extern QueueHandle_t tftQueue;
 
-/** @brief Init msg queue */
+/** @brief Init msg queue and message pool */
 void init_tft_queue();
 
+/**
+ * @brief Reserve a free message slot
+ *
+ * @return Slot marked in use, TFT_MSG_NONE if the pool is exhausted
+ */
+tft_msg_t tft_msg_alloc(void);
+
+/**
+ * @brief Text buffer of a slot, TFT_MSG_SIZE bytes
+ */
+char *tft_msg_data(tft_msg_t msg);
+
+/**
+ * @brief Return a slot to the pool
+ */
+void tft_msg_release(tft_msg_t msg);
+
+/**
+ * @brief Hand a slot to the display task
+ *
+ * The slot belongs to the queue and then to the display task, which
+ * releases it. On failure the slot is released.
+ *
+ * @return true if the message was queued
+ */
+bool tft_msg_send(tft_msg_t msg, TickType_t wait);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
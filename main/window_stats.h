@@ -0,0 +1,356 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+
+/*
+ * Allocation-free statistics over sensor streams.
+ *
+ * StatsRing keeps the last N samples, WindowStats adds mean, variance,
+ * minimum and maximum of that window in O(1) per sample, P2Quantile
+ * estimates a quantile of the whole stream in constant memory.
+ *
+ * Header-only, no ESP-IDF dependencies, builds on the host as well.
+ * None of the classes lock, callers sharing one between tasks must.
+ */
+
+
+/**
+ * @brief Fixed-capacity ring of the last N samples, oldest overwritten first
+ */
+template <typename T, size_t N>
+class StatsRing {
+public:
+    static_assert(N > 0, "window must hold at least one sample");
+
+    StatsRing() { clear(); }
+
+    void clear()
+    {
+        _head = 0;
+        _count = 0;
+    }
+
+    /**
+     * @brief Append a sample
+     *
+     * @param value New sample
+     * @param evicted Output, the sample that was overwritten if the ring was full
+     * @return true if a sample was overwritten
+     */
+    bool push(T value, T *evicted = NULL)
+    {
+        bool full = _count == N;
+        if (full && evicted) {
+            *evicted = _buf[_head];
+        }
+        _buf[_head] = value;
+        _head = _head + 1 < N ? _head + 1 : 0;
+        if (!full) {
+            _count++;
+        }
+        return full;
+    }
+
+    size_t size() const { return _count; }
+    bool full() const { return _count == N; }
+    static constexpr size_t capacity() { return N; }
+
+    /** @brief Sample i, 0 is the oldest */
+    T operator[](size_t i) const
+    {
+        size_t pos = _head + (N - _count) + i;
+        return _buf[pos < N ? pos : pos - N];
+    }
+
+    /** @brief Newest sample, the ring must not be empty */
+    T back() const { return _buf[_head ? _head - 1 : N - 1]; }
+
+private:
+    T _buf[N];
+    size_t _head;       /*!< Next write position */
+    size_t _count;
+};
+
+
+/**
+ * @brief Mean, variance, minimum and maximum of the last N samples
+ *
+ * Mean and variance are updated with the sliding form of Welford's
+ * method and recomputed from the window once per N samples, so rounding
+ * errors do not accumulate. They are also recomputed when the variance
+ * drops by more than 256 times, e.g. when a spike leaves the window.
+ * Minimum and maximum come from monotonic deques of window positions.
+ * add() is O(1) apart from the recomputations, which take O(N).
+ *
+ * @tparam T Sample type, float or an integer type
+ * @tparam N Window length in samples
+ * @tparam A Accumulator type of mean and variance
+ */
+template <typename T, size_t N, typename A = float>
+class WindowStats {
+public:
+    WindowStats() { clear(); }
+
+    void clear()
+    {
+        _ring.clear();
+        _mean = 0;
+        _m2 = 0;
+        _seq = 0;
+        _since_resync = 0;
+        _min.clear();
+        _max.clear();
+    }
+
+    void add(T value)
+    {
+        T old;
+        if (_ring.push(value, &old)) {
+            A x = (A)value, y = (A)old;
+            A mean = _mean + (x - y) / (A)N;
+            A m2 = _m2 + (x - y) * (x - mean + y - _mean);
+            _mean = mean;
+            // Once a sample that dominated the variance left, the rest is mostly its rounding error
+            if (++_since_resync >= N || m2 < _m2 / 256) {
+                resync();
+            } else {
+                _m2 = m2;
+            }
+        } else {
+            A x = (A)value;
+            A delta = x - _mean;
+            _mean += delta / (A)_ring.size();
+            _m2 += delta * (x - _mean);
+        }
+        if (_m2 < 0) {
+            _m2 = 0;
+        }
+
+        _seq++;
+        _min.push(_seq, value, _ring, false);
+        _max.push(_seq, value, _ring, true);
+    }
+
+    size_t count() const { return _ring.size(); }
+    bool full() const { return _ring.full(); }
+    A mean() const { return _mean; }
+
+    /** @brief Sample variance, 0 with fewer than two samples */
+    A variance() const { return _ring.size() > 1 ? _m2 / (A)(_ring.size() - 1) : 0; }
+    A stddev() const { return sqrt(variance()); }
+
+    /** @brief Smallest sample in the window, the window must not be empty */
+    T min() const { return _ring.bySeq(_min.at(0), _seq); }
+    /** @brief Largest sample in the window, the window must not be empty */
+    T max() const { return _ring.bySeq(_max.at(0), _seq); }
+
+    const StatsRing<T, N> &samples() const { return _ring; }
+
+private:
+    /**
+     * @brief Monotonic deque of window sequence numbers
+     *
+     * Holds the candidates for the extreme value, front is the current
+     * extreme.
+     */
+    struct Deque {
+        uint32_t seq[N];
+        size_t head;
+        size_t count;
+
+        void clear()
+        {
+            head = 0;
+            count = 0;
+        }
+
+        uint32_t at(size_t i) const
+        {
+            size_t pos = head + i;
+            return seq[pos < N ? pos : pos - N];
+        }
+    };
+
+    /** @brief StatsRing with access by sequence number for the deques */
+    class Ring : public StatsRing<T, N> {
+    public:
+        /** @brief Sample with sequence number s, newest is the one of the last sample */
+        T bySeq(uint32_t s, uint32_t newest) const
+        {
+            return (*this)[this->size() - 1 - (size_t)(newest - s)];
+        }
+    };
+
+    /** @brief Deque with the update rule of a sliding minimum or maximum */
+    struct Extreme : Deque {
+        void push(uint32_t s, T value, const Ring &ring, bool largest)
+        {
+            // Drop the candidate that left the window
+            if (this->count > 0 && s - this->at(0) >= N) {
+                this->head = this->head + 1 < N ? this->head + 1 : 0;
+                this->count--;
+            }
+            // And those that can never be the extreme again
+            while (this->count > 0) {
+                T last = ring.bySeq(this->at(this->count - 1), s);
+                if (largest ? last > value : last < value) {
+                    break;
+                }
+                this->count--;
+            }
+            size_t pos = this->head + this->count;
+            this->seq[pos < N ? pos : pos - N] = s;
+            this->count++;
+        }
+    };
+
+    /**
+     * @brief Recompute mean and variance from the window
+     */
+    void resync()
+    {
+        A sum = 0;
+        for (size_t i = 0; i < N; i++) {
+            sum += (A)_ring[i];
+        }
+        A mean = sum / (A)N;
+        A m2 = 0;
+        for (size_t i = 0; i < N; i++) {
+            A d = (A)_ring[i] - mean;
+            m2 += d * d;
+        }
+        _mean = mean;
+        _m2 = m2;
+        _since_resync = 0;
+    }
+
+    Ring _ring;
+    A _mean;
+    A _m2;              /*!< Sum of squared deviations from the mean */
+    uint32_t _seq;      /*!< Sequence number of the newest sample, first is 1 */
+    size_t _since_resync;
+    Extreme _min;
+    Extreme _max;
+};
+
+
+/**
+ * @brief Streaming quantile estimate with the P² algorithm
+ *
+ * Jain and Chlamtac, "The P² algorithm for dynamic calculation of
+ * quantiles and histograms without storing observations", 1985.
+ * Tracks five markers whose heights converge to the minimum, p/2, p,
+ * (1+p)/2 quantiles and the maximum of all samples since clear().
+ * Exact for the first five samples.
+ */
+template <typename T>
+class P2Quantile {
+public:
+    /**
+     * @param p Quantile, 0 < p < 1, e.g. 0.95 for the 95th percentile
+     */
+    explicit P2Quantile(float p = 0.5f) : _p(p) { clear(); }
+
+    void clear()
+    {
+        _count = 0;
+        for (int i = 0; i < 5; i++) {
+            _n[i] = i;
+        }
+        _want[0] = 0;
+        _want[1] = 2 * _p;
+        _want[2] = 4 * _p;
+        _want[3] = 2 + 2 * _p;
+        _want[4] = 4;
+        _step[0] = 0;
+        _step[1] = _p / 2;
+        _step[2] = _p;
+        _step[3] = (1 + _p) / 2;
+        _step[4] = 1;
+    }
+
+    void add(T value)
+    {
+        float x = (float)value;
+        if (_count < 5) {
+            // Insertion sort of the first samples into the markers
+            int i = (int)_count;
+            while (i > 0 && _q[i - 1] > x) {
+                _q[i] = _q[i - 1];
+                i--;
+            }
+            _q[i] = x;
+            _count++;
+            return;
+        }
+        _count++;
+
+        int k;
+        if (x < _q[0]) {
+            _q[0] = x;
+            k = 0;
+        } else if (x >= _q[4]) {
+            _q[4] = x;
+            k = 3;
+        } else {
+            k = 0;
+            while (x >= _q[k + 1]) {
+                k++;
+            }
+        }
+        for (int i = k + 1; i < 5; i++) {
+            _n[i]++;
+        }
+        for (int i = 0; i < 5; i++) {
+            _want[i] += _step[i];
+        }
+
+        // Move the middle markers towards their desired positions
+        for (int i = 1; i < 4; i++) {
+            float d = _want[i] - _n[i];
+            if ((d >= 1 && _n[i + 1] - _n[i] > 1) || (d <= -1 && _n[i - 1] - _n[i] < -1)) {
+                int s = d > 0 ? 1 : -1;
+                float q = parabolic(i, s);
+                if (!(_q[i - 1] < q && q < _q[i + 1])) {
+                    q = _q[i] + s * (_q[i + s] - _q[i]) / (_n[i + s] - _n[i]);
+                }
+                _q[i] = q;
+                _n[i] += s;
+            }
+        }
+    }
+
+    /** @brief Current estimate, 0 without samples */
+    float value() const
+    {
+        if (_count == 0) {
+            return 0;
+        }
+        if (_count < 5) {
+            // Nearest rank of the samples so far
+            size_t rank = (size_t)ceilf(_p * _count);
+            return _q[rank > 0 ? rank - 1 : 0];
+        }
+        return _q[2];
+    }
+
+    uint32_t count() const { return _count; }
+
+private:
+    float parabolic(int i, int s) const
+    {
+        float n0 = _n[i - 1], n1 = _n[i], n2 = _n[i + 1];
+        return _q[i] + s / (n2 - n0) *
+               ((n1 - n0 + s) * (_q[i + 1] - _q[i]) / (n2 - n1) +
+                (n2 - n1 - s) * (_q[i] - _q[i - 1]) / (n1 - n0));
+    }
+
+    float _p;
+    uint32_t _count;
+    float _q[5];        /*!< Marker heights */
+    int32_t _n[5];      /*!< Marker positions */
+    float _want[5];     /*!< Desired marker positions */
+    float _step[5];     /*!< Increment of the desired positions per sample */
+};
@@ -0,0 +1,95 @@
+/*
+ * Replays a recorded sample trace through the event detector of the
+ * firmware (main/event_detector.c) on the host and prints the events.
+ *
+ * The input is the output of telemetry_client.py, one sample per line:
+ *
+ *     <timestamp_ms> <channel name> <value>
+ *
+ * Build and run:
+ *
+ *     gcc -O2 -Imain tools/replay_events.c main/event_detector.c -lm -o replay_events
+ *     python3 tools/telemetry_client.py --rate 10 > trace.txt
+ *     ./replay_events < trace.txt
+ *
+ * The default parameters match the firmware, single ones can be changed:
+ *
+ *     ./replay_events --h-on 6 --hold 20 < trace.txt
+ *
+ * host_test/data/event_trace.txt is a trace in this format, the events it
+ * gives with the defaults are checked by host_test/test_event_detector.cpp.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "event_detector.h"
+
+static const char *channels[] = {"lpg", "co", "smoke", "temperature", "humidity", "co2"};
+#define CHANNEL_COUNT (sizeof(channels) / sizeof(channels[0]))
+
+
+int main(int argc, char *argv[])
+{
+    evd_config_t config = evd_default_config();
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            fprintf(stderr, "Missing value of %s\n", argv[i]);
+            return 1;
+        }
+        float value = strtof(argv[++i], NULL);
+        if (!strcmp(argv[i - 1], "--k")) {
+            config.k = value;
+        } else if (!strcmp(argv[i - 1], "--h-on")) {
+            config.h_on = value;
+        } else if (!strcmp(argv[i - 1], "--h-off")) {
+            config.h_off = value;
+        } else if (!strcmp(argv[i - 1], "--hold")) {
+            config.hold = (uint16_t)value;
+        } else if (!strcmp(argv[i - 1], "--alpha")) {
+            config.alpha = value;
+        } else if (!strcmp(argv[i - 1], "--warmup")) {
+            config.warmup = (uint16_t)value;
+        } else if (!strcmp(argv[i - 1], "--min-sigma")) {
+            config.min_sigma = value;
+        } else {
+            fprintf(stderr, "Usage: %s [--k|--h-on|--h-off|--hold|--alpha|--warmup|--min-sigma value]... < trace\n", argv[0]);
+            return 1;
+        }
+    }
+
+    evd_state_t detectors[CHANNEL_COUNT];
+    for (size_t ch = 0; ch < CHANNEL_COUNT; ch++) {
+        evd_init(&detectors[ch], &config);
+    }
+
+    char line[128];
+    unsigned long samples = 0, events = 0;
+    while (fgets(line, sizeof(line), stdin)) {
+        unsigned long timestamp_ms;
+        char name[32];
+        float value;
+        if (sscanf(line, "%lu %31s %f", &timestamp_ms, name, &value) != 3) {
+            continue;
+        }
+        size_t ch = 0;
+        while (ch < CHANNEL_COUNT && strcmp(channels[ch], name)) {
+            ch++;
+        }
+        if (ch == CHANNEL_COUNT) {
+            continue;
+        }
+        samples++;
+
+        evd_state_t *d = &detectors[ch];
+        evd_result_t result = evd_update(d, value);
+        if (result != EVD_NONE) {
+            events++;
+            printf("%lu %s %s value=%.3f baseline=%.3f score=%.2f\n", timestamp_ms, name,
+                   result == EVD_START ? "start" : "end", result == EVD_START ? value : d->peak,
+                   d->mean, d->score);
+        }
+    }
+    fprintf(stderr, "%lu samples, %lu events\n", samples, events);
+    return 0;
+}
@@ -0,0 +1,205 @@
+#!/usr/bin/env python3
+"""Reference client for the Smell-It binary telemetry stream.
+
+Connects to the TCP server of the device (SoftAP address 192.168.4.1,
+port 3333), subscribes to the sample stream and prints every record.
+The frame layout is described in main/telemetry.h.
+
+    python3 tools/telemetry_client.py --rate 10 --channels 0x7
+
+With --stats the window statistics of the channels are queried once instead,
+with --alerts only the start and end of detected gas events are printed.
+With --dump the log stored on the device since the given time (ms of the
+device clock, 0 for all) is downloaded and printed like the stream.
+With --power the wake and stay-awake counters are printed.
+"""
+
+import argparse
+import socket
+import struct
+import sys
+import zlib
+
+MAGIC = b"\xa5\x5a"
+VERSION = 1
+HEADER = struct.Struct("<2sBBHHI")
+RECORD = struct.Struct("<IBf")
+STATS_RECORD = struct.Struct("<BI6f")
+ALERT = struct.Struct("<IBB3f")
+LOG_HEADER = struct.Struct("<4sIQQHHBBHI")
+POWER = struct.Struct("<IIQQIIIBB")
+
+TYPE_SUBSCRIBE = 0x01
+TYPE_UNSUBSCRIBE = 0x02
+TYPE_STATS_REQUEST = 0x03
+TYPE_ALERT_SUBSCRIBE = 0x04
+TYPE_LOG_DUMP = 0x05
+TYPE_POWER_REQUEST = 0x06
+TYPE_SAMPLES = 0x81
+TYPE_ACK = 0x82
+TYPE_STATS = 0x83
+TYPE_ALERT = 0x84
+TYPE_LOG_BLOCK = 0x85
+TYPE_POWER = 0x86
+
+CHANNELS = ["lpg", "co", "smoke", "temperature", "humidity", "co2"]
+LEASES = ["boot", "tcp", "display", "alarm", "flash"]
+
+
+def encode_frame(frame_type, seq, payload=b""):
+    return HEADER.pack(MAGIC, VERSION, frame_type, len(payload), 0, seq) + payload
+
+
+def read_exact(sock, size):
+    data = bytearray()
+    while len(data) < size:
+        chunk = sock.recv(size - len(data))
+        if not chunk:
+            raise ConnectionError("connection closed by device")
+        data += chunk
+    return bytes(data)
+
+
+def read_frame(sock):
+    magic, version, frame_type, length, _, seq = HEADER.unpack(read_exact(sock, HEADER.size))
+    if magic != MAGIC or version != VERSION:
+        raise ValueError("unexpected frame header")
+    return frame_type, seq, read_exact(sock, length)
+
+
+def read_varint(data, pos):
+    value = shift = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if byte < 0x80:
+            return (value >> 1) ^ -(value & 1), pos
+
+
+def decode_block(block):
+    """Yields (timestamp_ms, channel, value) of a log block, see main/tslog_codec.h."""
+    magic, _, first_ms, _, rows, length, mask, scale, _, crc = LOG_HEADER.unpack_from(block)
+    if magic != b"TSB1" or zlib.crc32(block[:32] + block[36:36 + length]) != crc:
+        raise ValueError("damaged log block")
+    channels = [ch for ch in range(8) if mask & (1 << ch)]
+    payload = block[36:36 + length]
+    pos = 0
+    timestamp = first_ms
+    delta = 0
+    values = [0] * len(channels)
+    for row in range(rows):
+        if row > 0:
+            step, pos = read_varint(payload, pos)
+            delta = step if row == 1 else delta + step
+            timestamp += delta
+        for i, channel in enumerate(channels):
+            step, pos = read_varint(payload, pos)
+            values[i] += step
+            yield timestamp, channel, values[i] / scale
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--host", default="192.168.4.1")
+    parser.add_argument("--port", type=int, default=3333)
+    parser.add_argument("--rate", type=int, default=10, help="snapshot samples per second (1-1000)")
+    parser.add_argument("--channels", type=lambda v: int(v, 0), default=0x7, help="channel bit mask")
+    parser.add_argument("--stats", action="store_true", help="print channel statistics and exit")
+    parser.add_argument("--alerts", action="store_true", help="print gas events instead of samples")
+    parser.add_argument("--dump", type=int, metavar="SINCE_MS", help="print the stored log since a time and exit")
+    parser.add_argument("--power", action="store_true", help="print the power counters and exit")
+    args = parser.parse_args()
+
+    with socket.create_connection((args.host, args.port)) as sock:
+        if args.stats:
+            sock.sendall(encode_frame(TYPE_STATS_REQUEST, 1, struct.pack("<I", args.channels)))
+            while True:
+                frame_type, seq, payload = read_frame(sock)
+                if frame_type == TYPE_ACK:
+                    print("ack seq=%d status=%d" % (seq, payload[0]), file=sys.stderr)
+                    return
+                if frame_type == TYPE_STATS:
+                    break
+            for channel, count, mean, stddev, low, high, p50, p95 in STATS_RECORD.iter_unpack(payload):
+                name = CHANNELS[channel] if channel < len(CHANNELS) else str(channel)
+                print("%s n=%d mean=%.3f sd=%.3f min=%.3f max=%.3f p50=%.3f p95=%.3f"
+                      % (name, count, mean, stddev, low, high, p50, p95))
+            return
+
+        if args.power:
+            sock.sendall(encode_frame(TYPE_POWER_REQUEST, 1))
+            while True:
+                frame_type, seq, payload = read_frame(sock)
+                if frame_type == TYPE_ACK:
+                    print("ack seq=%d status=%d" % (seq, payload[0]), file=sys.stderr)
+                    return
+                if frame_type == TYPE_POWER:
+                    break
+            (full_wakes, sample_wakes, awake_ms, asleep_ms, latency_us, max_latency_us,
+             sample_wake_us, lease_mask, lease_count) = POWER.unpack_from(payload)
+            lease_ms = struct.unpack_from("<%dI" % lease_count, payload, POWER.size)
+            total_ms = awake_ms + asleep_ms
+            print("wakes full=%d sample=%d" % (full_wakes, sample_wakes))
+            print("awake %.1f s asleep %.1f s duty %.2f %%"
+                  % (awake_ms / 1000, asleep_ms / 1000, 100.0 * awake_ms / total_ms if total_ms else 0))
+            print("wake latency %d us max %d us, sample wake %d us" % (latency_us, max_latency_us, sample_wake_us))
+            for i, ms in enumerate(lease_ms):
+                name = LEASES[i] if i < len(LEASES) else str(i)
+                print("lease %s %.1f s%s" % (name, ms / 1000, " held" if lease_mask & (1 << i) else ""))
+            return
+
+        if args.dump is not None:
+            sock.sendall(encode_frame(TYPE_LOG_DUMP, 1, struct.pack("<Q", args.dump)))
+            while True:
+                frame_type, seq, payload = read_frame(sock)
+                if frame_type == TYPE_ACK:
+                    return
+                if frame_type != TYPE_LOG_BLOCK:
+                    continue
+                for timestamp_ms, channel, value in decode_block(payload):
+                    if timestamp_ms >= args.dump and args.channels & (1 << channel):
+                        name = CHANNELS[channel] if channel < len(CHANNELS) else str(channel)
+                        print("%d %s %.1f" % (timestamp_ms, name, value))
+
+        if args.alerts:
+            sock.sendall(encode_frame(TYPE_ALERT_SUBSCRIBE, 1, struct.pack("<I", args.channels)))
+            try:
+                while True:
+                    frame_type, seq, payload = read_frame(sock)
+                    if frame_type == TYPE_ACK:
+                        print("ack seq=%d status=%d" % (seq, payload[0]), file=sys.stderr)
+                        continue
+                    if frame_type != TYPE_ALERT:
+                        continue
+                    timestamp_ms, channel, start, value, baseline, score = ALERT.unpack(payload)
+                    name = CHANNELS[channel] if channel < len(CHANNELS) else str(channel)
+                    print("%d %s %s event=%d value=%.3f baseline=%.3f score=%.2f"
+                          % (timestamp_ms, name, "start" if start else "end", seq, value, baseline, score))
+            except KeyboardInterrupt:
+                sock.sendall(encode_frame(TYPE_ALERT_SUBSCRIBE, 2, struct.pack("<I", 0)))
+            return
+
+        sock.sendall(encode_frame(TYPE_SUBSCRIBE, 1, struct.pack("<HI", args.rate, args.channels)))
+        expected_seq = None
+        try:
+            while True:
+                frame_type, seq, payload = read_frame(sock)
+                if frame_type == TYPE_ACK:
+                    print("ack seq=%d status=%d" % (seq, payload[0]), file=sys.stderr)
+                    continue
+                if frame_type != TYPE_SAMPLES:
+                    continue
+                if expected_seq is not None and seq != expected_seq:
+                    print("lost %d frames" % (seq - expected_seq), file=sys.stderr)
+                expected_seq = seq + 1
+                for timestamp_ms, channel, value in RECORD.iter_unpack(payload):
+                    name = CHANNELS[channel] if channel < len(CHANNELS) else str(channel)
+                    print("%d %s %.3f" % (timestamp_ms, name, value))
+        except KeyboardInterrupt:
+            sock.sendall(encode_frame(TYPE_UNSUBSCRIBE, 2))
+
+
+if __name__ == "__main__":
+    main()